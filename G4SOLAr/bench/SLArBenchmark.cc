@@ -0,0 +1,146 @@
+/**
+ * @author      : Daniele Guffanti (daniele.guffanti@mib.infn.it)
+ * @file        : SLArBenchmark.cc
+ * @created     : Saturday Oct 17, 2026 22:10:17 CEST
+ */
+
+#include <cstdio>
+#include <chrono>
+#include <algorithm>
+#include <fstream>
+
+#include "SLArBenchmark.hh"
+
+#include "rapidjson/document.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/prettywriter.h"
+
+namespace slarbench {
+
+SLArBenchmarkSuite::SLArBenchmarkSuite(const std::string& name,
+    const int n_repetitions, const std::string& filter)
+  : fName(name), fNRepetitions(std::max(1, n_repetitions)), fFilter(filter)
+{
+  if (fFilter.empty() == false) fFilterRegex = std::regex(fFilter);
+}
+
+bool SLArBenchmarkSuite::IsSelected(const std::string& name) const
+{
+  if (fFilter.empty()) return true;
+  return std::regex_search(name, fFilterRegex);
+}
+
+/**
+ * @details Run the benchmark case if selected by the filter. The setup
+ * function is called before each repetition and is not timed.
+ *
+ * @return pointer to the result, to add case-specific counters (valid
+ * until the next call to Run), nullptr if the case is not selected
+ */
+SLArBenchResult* SLArBenchmarkSuite::Run(const std::string& name, const size_t n_ops,
+    const std::function<void()>& body, const std::function<void()>& setup)
+{
+  if (IsSelected(name) == false || n_ops == 0) return nullptr;
+
+  printf("slar_bench: running %s (%lu ops x %i)...\n", name.data(), n_ops, fNRepetitions);
+  fflush(stdout);
+
+  std::vector<double> ns_per_op(fNRepetitions, 0.);
+  for (int irep = 0; irep < fNRepetitions; irep++) {
+    if (setup) setup();
+    const auto t0 = std::chrono::steady_clock::now();
+    body();
+    const auto t1 = std::chrono::steady_clock::now();
+    ns_per_op[irep] = std::chrono::duration<double, std::nano>(t1 - t0).count() / n_ops;
+  }
+  std::sort(ns_per_op.begin(), ns_per_op.end());
+
+  SLArBenchResult result;
+  result.fName = name;
+  result.fNOps = n_ops;
+  result.fNRepetitions = fNRepetitions;
+  result.fNsPerOpMin = ns_per_op.front();
+  result.fNsPerOpMax = ns_per_op.back();
+  const size_t imid = ns_per_op.size() / 2;
+  result.fNsPerOpMedian = (ns_per_op.size() % 2) ?
+    ns_per_op[imid] : 0.5*(ns_per_op[imid-1] + ns_per_op[imid]);
+
+  fResults.push_back( result );
+  return &fResults.back();
+}
+
+void SLArBenchmarkSuite::Print() const
+{
+  printf("\n%-45s %12s %12s %12s %12s\n", fName.data(), "ops", "median [ns]", "min [ns]", "max [ns]");
+  for (const auto& r : fResults) {
+    printf("%-45s %12lu %12.2f %12.2f %12.2f\n", r.fName.data(), r.fNOps,
+        r.fNsPerOpMedian, r.fNsPerOpMin, r.fNsPerOpMax);
+    for (const auto& c : r.fCounters) {
+      printf("    %-41s %12g\n", c.first.data(), c.second);
+    }
+  }
+  printf("\n");
+}
+
+/**
+ * @details Write the results in a JSON file with the structure
+ *
+ *   {"suite": ..., "context": {...}, "benchmarks": [{"name": ...,
+ *    "ops": ..., "repetitions": ..., "ns_per_op": {"median": ...,
+ *    "min": ..., "max": ...}, "counters": {...}}, ...]}
+ */
+bool SLArBenchmarkSuite::WriteJSON(const std::string& file_path) const
+{
+  rapidjson::Document d;
+  d.SetObject();
+  auto& allocator = d.GetAllocator();
+
+  rapidjson::Value jsuite(fName.data(), allocator);
+  d.AddMember("suite", jsuite, allocator);
+
+  rapidjson::Value jcontext(rapidjson::kObjectType);
+  for (const auto& c : fContext) {
+    rapidjson::Value key(c.first.data(), allocator);
+    rapidjson::Value val(c.second.data(), allocator);
+    jcontext.AddMember(key, val, allocator);
+  }
+  d.AddMember("context", jcontext, allocator);
+
+  rapidjson::Value jbenchmarks(rapidjson::kArrayType);
+  for (const auto& r : fResults) {
+    rapidjson::Value jres(rapidjson::kObjectType);
+    rapidjson::Value jname(r.fName.data(), allocator);
+    jres.AddMember("name", jname, allocator);
+    jres.AddMember("ops", static_cast<uint64_t>(r.fNOps), allocator);
+    jres.AddMember("repetitions", r.fNRepetitions, allocator);
+    rapidjson::Value jtime(rapidjson::kObjectType);
+    jtime.AddMember("median", r.fNsPerOpMedian, allocator);
+    jtime.AddMember("min", r.fNsPerOpMin, allocator);
+    jtime.AddMember("max", r.fNsPerOpMax, allocator);
+    jres.AddMember("ns_per_op", jtime, allocator);
+    rapidjson::Value jcounters(rapidjson::kObjectType);
+    for (const auto& c : r.fCounters) {
+      rapidjson::Value key(c.first.data(), allocator);
+      jcounters.AddMember(key, c.second, allocator);
+    }
+    jres.AddMember("counters", jcounters, allocator);
+    jbenchmarks.PushBack(jres, allocator);
+  }
+  d.AddMember("benchmarks", jbenchmarks, allocator);
+
+  rapidjson::StringBuffer buffer;
+  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+  d.Accept(writer);
+
+  std::ofstream output(file_path);
+  if (output.is_open() == false) {
+    fprintf(stderr, "SLArBenchmarkSuite::WriteJSON ERROR: cannot open %s\n", file_path.data());
+    return false;
+  }
+  output << buffer.GetString() << std::endl;
+  printf("slar_bench: results written to %s\n", file_path.data());
+  return true;
+}
+
+}
+
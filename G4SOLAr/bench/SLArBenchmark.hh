@@ -0,0 +1,79 @@
+/**
+ * @author      : Daniele Guffanti (daniele.guffanti@mib.infn.it)
+ * @file        : SLArBenchmark.hh
+ * @created     : Saturday Oct 17, 2026 22:10:17 CEST
+ */
+
+#ifndef SLARBENCHMARK_HH
+
+#define SLARBENCHMARK_HH
+
+#include <string>
+#include <vector>
+#include <map>
+#include <regex>
+#include <functional>
+
+namespace slarbench {
+
+/**
+ * @struct SLArBenchResult
+ * @brief Timing of a benchmark case over the repetitions
+ */
+struct SLArBenchResult {
+  std::string fName;
+  size_t fNOps = 0; //!< operations per repetition
+  int fNRepetitions = 0;
+  double fNsPerOpMedian = 0.;
+  double fNsPerOpMin = 0.;
+  double fNsPerOpMax = 0.;
+  std::map<std::string, double> fCounters; //!< case-specific figures (e.g. hits per event)
+};
+
+/**
+ * @class SLArBenchmarkSuite
+ * @brief Minimal microbenchmark harness
+ *
+ * Each case is run for a number of repetitions: an optional setup function
+ * (not timed) prepares the input, then the body executing fNOps operations
+ * is timed. The median, minimum and maximum time per operation are
+ * reported, together with the run context, in a JSON file meant for
+ * trend tracking.
+ */
+class SLArBenchmarkSuite {
+  public:
+    SLArBenchmarkSuite(const std::string& name, const int n_repetitions = 5,
+        const std::string& filter = "");
+    ~SLArBenchmarkSuite() {}
+
+    bool IsSelected(const std::string& name) const;
+    SLArBenchResult* Run(const std::string& name, const size_t n_ops,
+        const std::function<void()>& body,
+        const std::function<void()>& setup = nullptr);
+    inline void SetContext(const std::string& key, const std::string& value) {fContext[key] = value;}
+    inline const std::vector<SLArBenchResult>& GetResults() const {return fResults;}
+
+    void Print() const;
+    bool WriteJSON(const std::string& file_path) const;
+
+  private:
+    std::string fName;
+    int fNRepetitions;
+    std::string fFilter;
+    std::regex fFilterRegex;
+    std::map<std::string, std::string> fContext;
+    std::vector<SLArBenchResult> fResults;
+};
+
+/**
+ * @brief Keep the compiler from optimizing away a benchmarked result
+ */
+template<typename T>
+inline void DoNotOptimize(const T& value) {
+  asm volatile("" : : "m"(value) : "memory");
+}
+
+}
+
+#endif /* end of include guard SLARBENCHMARK_HH */
+
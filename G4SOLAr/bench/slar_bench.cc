@@ -0,0 +1,518 @@
+/**
+ * @author      : Daniele Guffanti (daniele.guffanti@mib.infn.it)
+ * @file        : slar_bench.cc
+ * @created     : Saturday Oct 17, 2026 22:26:51 CEST
+ * @brief       : Microbenchmarks of the simulation hot paths
+ *
+ * The detector is built from one of the geometry configurations bundled
+ * in assets/geometry (no run is initialized, no external data is needed)
+ * and the readout, drift and output code is exercised with synthetic
+ * input generated with a fixed seed. The results are printed and written
+ * to a JSON file (see SLArBenchmarkSuite::WriteJSON).
+ */
+
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <memory>
+#include <filesystem>
+#include <getopt.h>
+
+#include "G4RunManager.hh"
+#include "G4Version.hh"
+#include "Randomize.hh"
+#include "TRandom3.h"
+#include "TROOT.h"
+#include "TFile.h"
+#include "TTree.h"
+#include "RVersion.h"
+
+#include "SLArVersion.hh"
+#include "SLArBenchmark.hh"
+#include "SLArAnalysisManager.hh"
+#include "SLArEventAction.hh"
+#include "detector/SLArDetectorConstruction.hh"
+#include "physics/SLArElectronDrift.hh"
+#include "event/SLArEventAnode.hh"
+#include "event/SLArEventTile.hh"
+#include "event/SLArEventChargePixel.hh"
+#include "event/SLArEventBacktrackerRecord.hh"
+#include "event/SLArMCPrimaryInfo.hh"
+
+#ifndef GIT_COMMIT_HASH
+#define GIT_COMMIT_HASH "unknown"
+#endif
+
+namespace {
+  void PrintUsage() {
+    fprintf(stderr, " Usage: \n");
+    fprintf(stderr, " slar_bench\t[-g/--geometry geometry_cfg_file]\n");
+    fprintf(stderr, " \t\t[-p/--materials material_db_file]\n");
+    fprintf(stderr, " \t\t[-o/--output output json file]\n");
+    fprintf(stderr, " \t\t[-f/--filter regex selecting the benchmark cases]\n");
+    fprintf(stderr, " \t\t[-n/--repetitions number of repetitions]\n");
+    fprintf(stderr, " \t\t[-s/--scale scale factor of the number of operations]\n");
+    fprintf(stderr, " \t\t[-b/--bkt-v1 output file with version 1 backtracker records to read back]\n");
+    fprintf(stderr, " \t\t[-h/--help print usage]\n");
+    exit(0);
+  }
+
+  //! Random points on the anode plane (in the anode frame), with a 5% margin
+  void sample_anode_points(SLArCfgAnode& anode_cfg, TRandom3& rndm, const size_t n,
+      std::vector<double>& xx, std::vector<double>& yy)
+  {
+    const TH2Poly* hmap = anode_cfg.GetAnodeMap(0);
+    const double xmin = hmap->GetXaxis()->GetXmin();
+    const double xmax = hmap->GetXaxis()->GetXmax();
+    const double ymin = hmap->GetYaxis()->GetXmin();
+    const double ymax = hmap->GetYaxis()->GetXmax();
+    const double margin_x = 0.05*(xmax - xmin);
+    const double margin_y = 0.05*(ymax - ymin);
+    xx.resize(n); yy.resize(n);
+    for (size_t i = 0; i < n; i++) {
+      xx[i] = rndm.Uniform(xmin - margin_x, xmax + margin_x);
+      yy[i] = rndm.Uniform(ymin - margin_y, ymax + margin_y);
+    }
+  }
+
+  //! Random pixels of the anode (indexes of existing pixels only)
+  std::vector<SLArCfgAnode::SLArPixIdx> sample_anode_pixels(SLArCfgAnode& anode_cfg,
+      TRandom3& rndm, const size_t n)
+  {
+    std::vector<SLArCfgAnode::SLArPixIdx> pixels;
+    pixels.reserve(n);
+    std::vector<double> xx, yy;
+    size_t n_trials = 0;
+    while (pixels.size() < n && n_trials < 100*n) {
+      sample_anode_points(anode_cfg, rndm, n, xx, yy);
+      for (size_t i = 0; i < n && pixels.size() < n; i++) {
+        const auto idx = anode_cfg.GetPixelIndex(xx[i], yy[i]);
+        if (idx[0] < 0 || idx[1] < 0 || idx[2] < 0) continue;
+        pixels.push_back(idx);
+      }
+      n_trials += n;
+    }
+    return pixels;
+  }
+
+  //! Fill the anode event with a synthetic event: n_hits hits spread on the given pixels
+  void fill_anode_event(SLArEventAnode& ev_anode,
+      const std::vector<SLArCfgAnode::SLArPixIdx>& pixels, TRandom3& rndm, const size_t n_hits)
+  {
+    if (pixels.empty()) return;
+    for (size_t i = 0; i < n_hits; i++) {
+      const auto& pix = pixels[ rndm.Integer(pixels.size()) ];
+      const SLArEventChargeHit hit(rndm.Uniform(0., 2e5), 1, 1);
+      ev_anode.RegisterChargeHit(pix, hit);
+    }
+  }
+
+  //! Check that the backtracker counters are sorted by key with non-zero counts
+  bool check_backtracker_collection(const BacktrackerVectorCollection_t& collection,
+      size_t& n_records, size_t& n_entries)
+  {
+    for (const auto& bkt_vector : collection) {
+      for (const auto& record : bkt_vector.second.GetConstRecords()) {
+        bool first = true;
+        Int_t last_key = 0;
+        for (const auto entry : record.GetConstCounter()) {
+          if (entry.second == 0 || (!first && entry.first <= last_key)) return false;
+          first = false;
+          last_key = entry.first;
+          n_entries++;
+        }
+        n_records++;
+      }
+    }
+    return true;
+  }
+
+  //! Read back the anode backtracker records of an output file
+  bool check_backtracker_file(const std::string& file_path)
+  {
+    std::unique_ptr<TFile> file( TFile::Open(file_path.data()) );
+    if (!file || file->IsZombie()) {
+      fprintf(stderr, "slar_bench ERROR: cannot open %s\n", file_path.data());
+      return false;
+    }
+    TTree* tree = file->Get<TTree>("EventTree");
+    if (!tree || !tree->GetBranch("EventAnode")) {
+      fprintf(stderr, "slar_bench ERROR: no EventTree/EventAnode in %s\n", file_path.data());
+      return false;
+    }
+    SLArListEventAnode* ev_anode = nullptr;
+    tree->SetBranchAddress("EventAnode", &ev_anode);
+
+    size_t n_records = 0, n_entries = 0;
+    for (Long64_t iev = 0; iev < tree->GetEntries(); iev++) {
+      tree->GetEntry(iev);
+      for (const auto& anode : ev_anode->GetConstAnodeMap()) {
+        for (const auto& mt : anode.second.GetConstMegaTilesMap()) {
+          for (const auto& tile : mt.second.GetConstTileMap()) {
+            bool ok = check_backtracker_collection(tile.second.GetBacktrackerRecordCollection(), n_records, n_entries);
+            for (const auto& pixel : tile.second.GetConstPixelEvents()) {
+              ok &= check_backtracker_collection(pixel.second.GetBacktrackerRecordCollection(), n_records, n_entries);
+            }
+            if (!ok) {
+              fprintf(stderr, "slar_bench ERROR: unsorted backtracker counter in event %lld of %s\n",
+                  iev, file_path.data());
+              delete ev_anode;
+              return false;
+            }
+          }
+        }
+      }
+    }
+    printf("slar_bench: read %lu backtracker records (%lu entries) from %s\n",
+        n_records, n_entries, file_path.data());
+    delete ev_anode;
+    return true;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  std::string geometry_file = std::string(SLAR_BENCH_ASSETS_DIR) + "/geometry/solaire/solaire_run.json";
+  std::string material_file = std::string(SLAR_BENCH_ASSETS_DIR) + "/materials/materials_db.json";
+  std::string output_file = "slar_bench.json";
+  std::string filter = "";
+  std::string bkt_v1_file = "";
+  int n_repetitions = 5;
+  double scale = 1.0;
+  const unsigned int seed = 4357;
+
+  const char* short_opts = "g:p:o:f:n:s:b:h";
+  static struct option long_opts[9] =
+  {
+    {"geometry", required_argument, 0, 'g'},
+    {"materials", required_argument, 0, 'p'},
+    {"output", required_argument, 0, 'o'},
+    {"filter", required_argument, 0, 'f'},
+    {"repetitions", required_argument, 0, 'n'},
+    {"scale", required_argument, 0, 's'},
+    {"bkt-v1", required_argument, 0, 'b'},
+    {"help", no_argument, 0, 'h'},
+    {nullptr, no_argument, nullptr, 0}
+  };
+
+  int c, option_index;
+  while ( (c = getopt_long(argc, argv, short_opts, long_opts, &option_index)) != -1) {
+    switch(c) {
+      case 'g' : geometry_file = optarg; break;
+      case 'p' : material_file = optarg; break;
+      case 'o' : output_file = optarg; break;
+      case 'f' : filter = optarg; break;
+      case 'n' : n_repetitions = std::atoi(optarg); break;
+      case 's' : scale = std::atof(optarg); break;
+      case 'b' : bkt_v1_file = optarg; break;
+      case 'h' : PrintUsage(); break;
+      case '?' :
+      {
+        printf("slar_bench error: unknown flag %c\n", optopt);
+        PrintUsage();
+        return 4;
+      }
+    }
+  }
+
+  auto n_ops = [scale](const size_t n) {return std::max<size_t>(1, n*scale);};
+
+  G4Random::setTheEngine(new CLHEP::RanecuEngine);
+  G4Random::setTheSeed(seed);
+
+  // the run manager is needed by the messengers and by the event action,
+  // but no run is initialized
+  G4RunManager* run_manager = new G4RunManager;
+  SLArAnalysisManager* ana_mgr = SLArAnalysisManager::Instance();
+
+  auto detector = new SLArDetectorConstruction(geometry_file, material_file);
+  run_manager->SetUserInitialization(detector);
+  detector->Construct();
+
+  if (ana_mgr->GetAnodeCfg().empty()) {
+    fprintf(stderr, "slar_bench ERROR: no anode found in %s\n", geometry_file.data());
+    return 1;
+  }
+  SLArCfgAnode& anode_cfg = ana_mgr->GetAnodeCfg().begin()->second;
+  SLArEventAnode& ev_anode = ana_mgr->GetEventAnode().GetAnodeMap().at(anode_cfg.GetTPCID());
+
+  slarbench::SLArBenchmarkSuite suite("slar_bench", n_repetitions, filter);
+  char time_str[64];
+  const std::time_t now = std::time(nullptr);
+  std::strftime(time_str, sizeof(time_str), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+  suite.SetContext("date", time_str);
+  suite.SetContext("solarsim_version", SOLARSIM_VERSION);
+  suite.SetContext("git_commit", GIT_COMMIT_HASH);
+  suite.SetContext("geant4_version", std::to_string(G4VERSION_NUMBER));
+  suite.SetContext("root_version", ROOT_RELEASE);
+  suite.SetContext("compiler", __VERSION__);
+  suite.SetContext("geometry", geometry_file);
+  suite.SetContext("scale", std::to_string(scale));
+
+  TRandom3 rndm(seed);
+
+  //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // SLArCfgAnode::GetPixelIndex
+  {
+    std::vector<double> xx, yy;
+    const size_t n = n_ops(1000000);
+    sample_anode_points(anode_cfg, rndm, n, xx, yy);
+
+    const bool use_lookup = anode_cfg.UsePixelLookup();
+    auto body = [&]() {
+      for (size_t i = 0; i < n; i++) slarbench::DoNotOptimize( anode_cfg.GetPixelIndex(xx[i], yy[i]) );
+    };
+
+    anode_cfg.SetUsePixelLookup(true);
+    suite.Run("cfg_anode_get_pixel_index_lookup", n, body);
+    anode_cfg.SetUsePixelLookup(false);
+    suite.Run("cfg_anode_get_pixel_index_th2poly", n, body);
+    anode_cfg.SetUsePixelLookup(use_lookup);
+  }
+
+  //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // SLArElectronDrift::Drift on synthetic steps
+  {
+    SLArLArProperties& lar_properties = detector->GetLArProperties();
+    lar_properties.ComputeProperties();
+    const auto drift_mode = lar_properties.GetChargeDriftMode();
+    SLArElectronDrift drift(lar_properties);
+
+    // 1 mm steps of a MIP-like track (about 6000 electrons)
+    const size_t n_steps = n_ops(2000);
+    const int n_electrons = 6000;
+    const G4ThreeVector axis0(anode_cfg.GetAxis0().x(), anode_cfg.GetAxis0().y(), anode_cfg.GetAxis0().z());
+    const G4ThreeVector axis1(anode_cfg.GetAxis1().x(), anode_cfg.GetAxis1().y(), anode_cfg.GetAxis1().z());
+    const G4ThreeVector normal(anode_cfg.GetNormal().x(), anode_cfg.GetNormal().y(), anode_cfg.GetNormal().z());
+    const G4ThreeVector anode_pos(anode_cfg.GetPhysX(), anode_cfg.GetPhysY(), anode_cfg.GetPhysZ());
+
+    std::vector<double> xx, yy;
+    sample_anode_points(anode_cfg, rndm, n_steps, xx, yy);
+    std::vector<G4ThreeVector> pre_pos(n_steps), post_pos(n_steps);
+    for (size_t i = 0; i < n_steps; i++) {
+      const double drift_length = rndm.Uniform(10., 1000.);
+      pre_pos[i] = anode_pos + drift_length*normal + xx[i]*axis0 + yy[i]*axis1;
+      const G4ThreeVector dir(rndm.Gaus(), rndm.Gaus(), rndm.Gaus());
+      post_pos[i] = pre_pos[i] + 1.0*CLHEP::mm*dir.unit();
+    }
+
+    auto body = [&]() {
+      for (size_t i = 0; i < n_steps; i++) {
+        drift.Drift(n_electrons, 1, 1, pre_pos[i], post_pos[i], 0., 0.01, &anode_cfg, &ev_anode);
+      }
+    };
+    auto setup = [&]() {ev_anode.ResetHits();};
+
+    lar_properties.SetChargeDriftMode(kDriftElectrons);
+    auto res = suite.Run("electron_drift_drift", n_steps, body, setup);
+    if (res) res->fCounters["electrons_per_step"] = n_electrons;
+    lar_properties.SetChargeDriftMode(kDriftParametric);
+    res = suite.Run("electron_drift_drift_parametric", n_steps, body, setup);
+    if (res) res->fCounters["electrons_per_step"] = n_electrons;
+    lar_properties.SetChargeDriftMode(drift_mode);
+    ev_anode.ResetHits();
+  }
+
+  //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // SLArEventTile::RegisterChargeHit and SLArEventHitsCollection::RegisterHit
+  {
+    const size_t n = n_ops(1000000);
+    std::vector<int> pix_id(n);
+    std::vector<SLArEventChargeHit> hits(n);
+    for (size_t i = 0; i < n; i++) {
+      pix_id[i] = rndm.Integer(256);
+      hits[i] = SLArEventChargeHit(rndm.Uniform(0., 2e5), 1, 1);
+    }
+
+    SLArEventTile tile(0);
+    suite.Run("event_tile_register_charge_hit", n,
+        [&]() {for (size_t i = 0; i < n; i++) tile.RegisterChargeHit(pix_id[i], hits[i]);},
+        [&]() {tile.ResetHits();});
+    tile.ResetHits();
+
+    SLArEventChargePixel pixel;
+    suite.Run("event_hits_collection_register_hit", n,
+        [&]() {for (size_t i = 0; i < n; i++) pixel.RegisterHit(hits[i]);},
+        [&]() {pixel.ResetHits();});
+    pixel.ResetHits();
+
+    // same hits with two backtracker records (track and ancestor)
+    // under the two storage policies
+    std::vector<int> trk_id(n), anc_id(n);
+    for (size_t i = 0; i < n; i++) {
+      trk_id[i] = 1 + rndm.Integer(30);
+      anc_id[i] = 1 + rndm.Integer(5);
+    }
+    auto body_bkt = [&]() {
+      for (size_t i = 0; i < n; i++) {
+        pixel.RegisterHit(hits[i]);
+        auto& records = pixel.GetBacktrackerVector( pixel.ConvertToClock<float>(hits[i].GetTime()) ).GetRecords();
+        records[0].UpdateCounter(trk_id[i]);
+        records[1].UpdateCounter(anc_id[i]);
+      }
+      slarbench::DoNotOptimize( pixel.ConsolidateHits() );
+    };
+    pixel.SetBacktrackerRecordSize(2);
+    pixel.SetStoragePolicy(kMapStorage);
+    suite.Run("event_hits_collection_register_hit_backtracker_map", n,
+        body_bkt, [&]() {pixel.ResetHits();});
+    pixel.ResetHits();
+    pixel.SetStoragePolicy(kBufferedStorage);
+    suite.Run("event_hits_collection_register_hit_backtracker_buffered", n,
+        body_bkt, [&]() {pixel.ResetHits();});
+    pixel.ResetHits();
+    pixel.SetStoragePolicy(kMapStorage);
+    pixel.SetBacktrackerRecordSize(0);
+  }
+
+  //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // SLArEventAnode::ApplyZeroSuppression
+  const auto pixels = sample_anode_pixels(anode_cfg, rndm, 5000);
+  {
+    const size_t n_hits = n_ops(200000);
+    const UShort_t threshold = ev_anode.GetZeroSuppressionThreshold();
+    ev_anode.SetZeroSuppressionThreshold(2);
+    auto res = suite.Run("event_anode_apply_zero_suppression", 1,
+        [&]() {slarbench::DoNotOptimize( ev_anode.ApplyZeroSuppression() );},
+        [&]() {ev_anode.ResetHits(); fill_anode_event(ev_anode, pixels, rndm, n_hits);});
+    if (res) {
+      res->fCounters["pixels"] = pixels.size();
+      res->fCounters["hits"] = n_hits;
+    }
+    ev_anode.SetZeroSuppressionThreshold(threshold);
+    ev_anode.ResetHits();
+  }
+
+  //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // SLArEventAction::FindAncestorID
+  {
+    // shower-like track table: each track descends from one of the
+    // latest 50 tracks, starting from 10 primaries
+    const int n_primaries = 10;
+    const int n_tracks = n_ops(100000);
+    auto& mc_truth = ana_mgr->GetMCTruth();
+    mc_truth.Reset();
+    for (int i = 1; i <= n_primaries; i++) {
+      SLArMCPrimaryInfo primary;
+      primary.SetTrackID(i);
+      mc_truth.RegisterPrimary(primary);
+    }
+    std::vector<int> parent(n_tracks+1);
+    for (int i = 1; i <= n_tracks; i++) {
+      parent[i] = (i <= n_primaries) ? i : std::max(1, i - 1 - (int)rndm.Integer(50));
+    }
+    const size_t n_queries = n_ops(1000000);
+    std::vector<int> queries(n_queries);
+    for (auto& q : queries) q = 1 + rndm.Integer(n_tracks);
+
+    std::unique_ptr<SLArEventAction> event_action;
+    auto register_tracks = [&]() {
+      for (int i = 1; i <= n_tracks; i++) event_action->RegisterNewTrackPID(i, parent[i]);
+    };
+
+    suite.Run("event_action_register_track_pid", n_tracks, register_tracks,
+        [&]() {event_action = std::make_unique<SLArEventAction>();});
+    suite.Run("event_action_find_ancestor_id", n_queries,
+        [&]() {for (const auto& q : queries) slarbench::DoNotOptimize( event_action->FindAncestorID(q) );},
+        [&]() {event_action = std::make_unique<SLArEventAction>(); register_tracks();});
+    event_action.reset();
+  }
+
+  //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // SLArEventBacktrackerRecord I/O: write and read back a tree of backtracker
+  // vectors with 1-4 keys per record and compare with the written counts
+  bool io_ok = true;
+  if (suite.IsSelected("event_backtracker_record_io")) {
+    const auto output_path = std::filesystem::temp_directory_path() / "slar_bench_bkt_io.root";
+    const size_t n_vectors = n_ops(100000);
+    std::vector<SLArEventBacktrackerVector> written(n_vectors, SLArEventBacktrackerVector(2));
+    for (auto& bkt_vector : written) {
+      for (auto& record : bkt_vector.GetRecords()) {
+        const int n_keys = 1 + rndm.Integer(4);
+        for (int k = 0; k < n_keys; k++) record.UpdateCounter(rndm.Integer(1000), 1 + rndm.Integer(10));
+      }
+    }
+
+    double tot_bytes = 0., zip_bytes = 0.;
+    auto io_cycle = [&]() {
+      {
+        TFile file(output_path.c_str(), "recreate");
+        TTree tree("bkt", "backtracker records");
+        SLArEventBacktrackerVector* bkt_vector = nullptr;
+        tree.Branch("bkt", &bkt_vector, 32000, 99);
+        for (auto& v : written) {bkt_vector = &v; tree.Fill();}
+        tree.Write();
+        tot_bytes = tree.GetTotBytes();
+        zip_bytes = tree.GetZipBytes();
+      }
+      TFile file(output_path.c_str());
+      TTree* tree = file.Get<TTree>("bkt");
+      SLArEventBacktrackerVector* bkt_vector = nullptr;
+      tree->SetBranchAddress("bkt", &bkt_vector);
+      for (Long64_t i = 0; i < tree->GetEntries(); i++) {
+        tree->GetEntry(i);
+        const auto& records = bkt_vector->GetConstRecords();
+        const auto& ref_records = written[i].GetConstRecords();
+        if (records.size() != ref_records.size()) {io_ok = false; continue;}
+        for (size_t ir = 0; ir < records.size(); ir++) {
+          const auto& counter = records[ir].GetConstCounter();
+          const auto& ref = ref_records[ir].GetConstCounter();
+          if (counter.size() != ref.size()) {io_ok = false; continue;}
+          for (size_t ie = 0; ie < counter.size(); ie++) {
+            if (counter.At(ie) != ref.At(ie)) io_ok = false;
+          }
+        }
+      }
+      delete bkt_vector;
+    };
+
+    auto res = suite.Run("event_backtracker_record_io", n_vectors, io_cycle);
+    if (res) {
+      res->fCounters["bytes_per_record"] = tot_bytes / (2*n_vectors);
+      res->fCounters["zip_bytes_per_record"] = zip_bytes / (2*n_vectors);
+      res->fCounters["sizeof_record"] = sizeof(SLArEventBacktrackerRecord);
+    }
+    if (!io_ok) fprintf(stderr, "slar_bench ERROR: backtracker records differ after the I/O round trip\n");
+    std::filesystem::remove( output_path );
+  }
+  if (!bkt_v1_file.empty()) io_ok &= check_backtracker_file(bkt_v1_file);
+
+  //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  // SLArAnalysisManager::FillTree
+  if (suite.IsSelected("analysis_manager_fill_tree")) {
+    const auto output_dir = std::filesystem::temp_directory_path();
+    const std::string output_name = "slar_bench_fill_tree.root";
+    ana_mgr->SetOutputPath( output_dir.string() );
+    ana_mgr->SetOutputName( output_name );
+    ana_mgr->CreateFileStructure();
+
+    const size_t n_events = n_ops(200);
+    const size_t n_hits = 50000;
+    ev_anode.ResetHits();
+    fill_anode_event(ev_anode, pixels, rndm, n_hits);
+    ev_anode.ConsolidateHits();
+
+    auto res = suite.Run("analysis_manager_fill_tree", n_events,
+        [&]() {for (size_t i = 0; i < n_events; i++) ana_mgr->FillTree();});
+    if (res) {
+      const TTree* tree = ana_mgr->GetEventTree();
+      res->fCounters["hits_per_event"] = n_hits;
+      res->fCounters["bytes_per_event"] = tree->GetTotBytes() / (double)tree->GetEntries();
+      res->fCounters["zip_bytes_per_event"] = tree->GetZipBytes() / (double)tree->GetEntries();
+    }
+
+    ana_mgr->Save();
+    std::filesystem::remove( output_dir / output_name );
+    ana_mgr->ResetEvent();
+  }
+
+  suite.Print();
+  const bool written = suite.WriteJSON(output_file);
+
+  delete ana_mgr;
+  delete run_manager;
+
+  return (written && io_ok) ? 0 : 1;
+}
+
@@ -40,6 +40,8 @@
 #include <map>
 #include <vector>
 
+class SLArMCPrimaryInfo;
+
 /// Event action
 
 class SLArEventAction : public G4UserEventAction
@@ -70,6 +72,7 @@ public:
     inline G4int GetAbsorptionCount()const     {return fAbsorptionCount;}
     inline G4int GetBoundaryAbsorptionCount()const {return fBoundaryAbsorptionCount;}
     int FindAncestorID(int); 
+    SLArMCPrimaryInfo* GetAncestorPrimary(int ancestor_id); 
     void  RegisterNewTrackPID(int, int); 
 
     struct TrackIdHelpInfo_t {
@@ -130,7 +133,15 @@ private:
     G4int fBoundaryAbsorptionCount;
     G4double fTotEdep;
 
-    std::map<int, int> fParentIDMap;
+    //! Entry of the event track table (indexed by track ID)
+    struct TrackAncestry_t {
+      int parent; //!< parent track ID (equal to the track ID for primaries)
+      int ancestor; //!< memoized primary ancestor ID (-1 if unresolved)
+
+      inline TrackAncestry_t() : parent(-1), ancestor(-1) {}
+    };
+    std::vector<TrackAncestry_t> fTrackTable; //!< track ID -> parent/ancestor
+    std::vector<int> fPrimaryIdx; //!< primary track ID -> index in MCTruth primaries
     std::map<TrackIdHelpInfo_t, G4String> fExtraProcessInfo;
 
     G4int RecordEventReadoutTile (const G4Event* ev, const G4int& verbose = 0);
@@ -32,12 +32,19 @@ class SLArSteppingAction : public G4UserSteppingAction
     virtual void UserSteppingAction(const G4Step*);
 
   private:
+    //! Max number of dropped points checked against the simplified path
+    static constexpr size_t kMaxDecimationWindow = 64;
+
     trj_point set_evtrj_point(const G4StepPoint* point, const int nel = 0, const int nph = 0); 
+    void RegisterTrajectoryPoint(SLArEventTrajectory* trajectory, trj_point& point); 
+    G4bool CanDecimate(const std::vector<trj_point>& points, const trj_point& point, const G4double tolerance) const; 
     G4OpBoundaryProcessStatus fExpectedNextStatus;
     SLArEventAction*          fEventAction;
     SLArTrackingAction*       fTrackinAction;
     G4Transform3D             fTransformWorld2Det;
     G4int fEventNumber;
+    const SLArEventTrajectory* fWindowTrajectory; //!< trajectory owning the decimation window
+    std::vector<trj_point>    fWindow;           //!< points dropped since the last kept point
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -14,9 +14,17 @@
 
 #include <cstdio>
 #include <stdexcept>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "TFile.h"
 #include "TTree.h"
 #include "TParameter.h"
+#include "Compression.h"
+#include "rapidjson/document.h"
 
 #include "config/SLArCfgAnode.hh"
 #include "config/SLArCfgBaseSystem.hh"
@@ -29,10 +37,16 @@
 
 #include "SLArBacktrackerManager.hh"
 #include "SLArAnalysisManagerMsgr.hh"
+#include "SLArFlatOutput.hh"
+#include "SLArProfiler.hh"
 
 #include "G4ToolsAnalysisManager.hh"
 #include "globals.hh"
 
+#ifdef G4MULTITHREADED
+#include "G4TaskGroup.hh"
+#endif
+
 
 class SLArAnalysisManager 
 {
@@ -47,6 +61,47 @@ class SLArAnalysisManager
       SLArXSecDumpSpec(const G4String& par, const G4String& proc, const G4String& mat, const bool& do_log = false);
     };
 
+    //! Strategy used to write the event to the output trees
+    enum EOutputMode {
+      kSyncOutput = 0,  //!< zero suppression and tree filling at the end of each event
+      kTaskOutput = 1,  //!< zero suppression and tree filling in a task of the G4TaskRunManager pool
+      kAsyncOutput = 2  //!< zero suppression and tree filling in a background I/O thread
+    };
+
+    //! Selection of the trajectory points stored when storeFullTrajectory is on
+    enum ETrjPointPolicy {
+      kStoreAllPoints = 0,   //!< one point per step
+      kDecimatePoints = 1,   //!< drop the points closer than a tolerance to the simplified path
+      kStoreLArPoints = 2,   //!< only the points in LAr
+      kStoreVolumeEdges = 3  //!< only the first and the last point in each volume
+    };
+
+    //! Behaviour of the asynchronous writer when all the event buffers are in use
+    enum EOutputBackPressure {
+      kBlockOnFullQueue = 0, //!< wait for the I/O thread to release a buffer
+      kGrowQueue = 1         //!< allocate a new buffer
+    };
+
+    /**
+     * @brief Event data handed over to the output stage
+     *
+     * The content of the event objects filled during the simulation is 
+     * swapped with the one of the buffer, which is bound to the output trees.
+     */
+    struct SLArEventBuffer {
+      Int_t fEventNumber; 
+      SLArMCTruth fMCTruth; 
+      SLArListEventAnode fEventAnode; 
+      SLArListEventPDS fEventPDS; 
+      SLArGenRecordsVector fGenRecords; 
+
+      SLArEventBuffer(const SLArListEventAnode& ev_anode, const SLArListEventPDS& ev_pds); 
+      void Reset(); 
+      void Swap(SLArEventBuffer& other); 
+      void SwapEvent(const Int_t ev_number, SLArMCTruth& mctruth, SLArListEventAnode& ev_anode, 
+          SLArListEventPDS& ev_pds, SLArGenRecordsVector& gen_records); 
+    };
+
     SLArAnalysisManager(G4bool isMaster);
     ~SLArAnalysisManager();
 
@@ -54,6 +109,7 @@ class SLArAnalysisManager
     static SLArAnalysisManager* Instance();
     static G4bool IsInstance();
 
+    inline G4bool IsMaster() const {return fIsMaster;}
     inline void SetSeed( const G4long myseed ) {fSeed = myseed;}
     inline G4long GetSeed() const {return fSeed;}
 
@@ -61,10 +117,25 @@ class SLArAnalysisManager
     void   ConstructBacktracker(const backtracker::EBkTrkReadoutSystem isys); 
     G4bool CreateEventStructure();
     G4bool CreateFileStructure();
+    void   CopyConfigurationFromMaster();
+    void   CopySettingsFromMaster();
+    void   RegisterWorkerOutput(const G4String& filepath);
+    G4bool MergeWorkerOutputs();
+    inline void SetKeepWorkerOutput(const G4bool keep) {fKeepWorkerOutput = keep;}
+    inline G4bool KeepWorkerOutput() const {return fKeepWorkerOutput;}
+    inline void RegisterDisabledSD(const G4String& sd_name) {fDisabledSD.push_back(sd_name);}
     G4bool LoadPDSCfg(SLArCfgSystemSuperCell&  pdsCfg );
     G4bool LoadAnodeCfg(SLArCfgAnode&  pixCfg );
     G4bool FillTree();
     G4bool FillGenTree(); 
+    G4bool SubmitEvent(); 
+    void   WaitOutput(); 
+    inline void SetOutputMode(const EOutputMode mode) {fOutputMode = mode;}
+    inline EOutputMode GetOutputMode() const {return fOutputMode;}
+    inline void SetOutputQueueDepth(const G4int depth) {fOutputQueueDepth = depth;}
+    inline G4int GetOutputQueueDepth() const {return fOutputQueueDepth;}
+    inline void SetOutputBackPressure(const EOutputBackPressure bp) {fOutputBackPressure = bp;}
+    inline EOutputBackPressure GetOutputBackPressure() const {return fOutputBackPressure;}
     void   SetOutputPath(G4String path);
     void   SetOutputName(G4String filename);
     inline void EnableMCTruthOutput(const bool enable) {fEnableMCTruthOutput = enable;}
@@ -73,8 +144,25 @@ class SLArAnalysisManager
     inline bool IsMCTruthOutputEnabled() const {return fEnableMCTruthOutput;}
     inline bool IsAnodeOutputEnabled() const {return fEnableEventAnodeOutput;}
     inline bool IsPDSOutputEnabled() const {return fEnableEventPDSOutput;}
+    inline void EnableFlatOutput(const bool enable) {fEnableFlatOutput = enable;}
+    inline bool IsFlatOutputEnabled() const {return fEnableFlatOutput;}
+    inline void EnableProfiling(const bool enable) {fEnableProfiling = enable;}
+    inline bool IsProfilingEnabled() const {return fEnableProfiling;}
+    inline void EnableDirectPhotonHits(const bool enable) {fEnableDirectPhotonHits = enable;}
+    inline bool IsDirectPhotonHitsEnabled() const {return fEnableDirectPhotonHits;}
     void   WriteSysCfg();
     bool   IsPathValid(G4String path);
+    G4bool SetCompression(const G4String& algorithm, const G4int level); 
+    inline G4int GetCompressionSettings() const {return fCompressionSettings;}
+    inline void SetAutoFlush(const Long64_t autoflush) {fAutoFlush = autoflush;}
+    inline Long64_t GetAutoFlush() const {return fAutoFlush;}
+    inline void SetAutoSave(const Long64_t autosave) {fAutoSave = autosave;}
+    inline Long64_t GetAutoSave() const {return fAutoSave;}
+    inline void SetSplitLevel(const G4int split_level) {fSplitLevel = split_level;}
+    inline G4int GetSplitLevel() const {return fSplitLevel;}
+    void   SetBasketSize(const G4String& branch, const G4int size); 
+    G4bool LoadOutputConfig(const G4String& config_file_path); 
+    G4bool LoadOutputConfig(const rapidjson::Value& config); 
     template<typename T> 
       inline int WriteVariable(G4String name, T val) {
         if (!fRootFile) {
@@ -100,6 +188,8 @@ class SLArAnalysisManager
     void SetupBacktrackerRecords(); 
     inline TTree* GetEventTree() const {return  fEventTree;}
     inline TTree* GetGenRecordsTree() const {return  fGenTree;}
+    inline SLArFlatOutput& GetFlatOutput() {return fFlatOutput;}
+    inline SLArProfiler& GetProfiler() {return fProfiler;}
 
     inline TFile* GetFile() const {return   fRootFile;}
     inline SLArCfgSystemSuperCell& GetPDSCfg() {return  fPDSysCfg;}
@@ -112,15 +202,31 @@ class SLArAnalysisManager
         exit(EXIT_FAILURE);
       }
     }
-    inline SLArCfgAnode& GetAnodeCfgByID(const int anode_id) {
+    //! Return the anode configuration with the given index or nullptr if not registered
+    inline SLArCfgAnode* FindAnodeCfgByID(const int anode_id) {
+      if (fCfgIndexFrozen) {
+        const size_t i = static_cast<size_t>(anode_id); 
+        return (i < fAnodeCfgByID.size()) ? fAnodeCfgByID[i] : nullptr; 
+      }
       for (auto& anode_cfg : fAnodeCfg) {
         if (anode_cfg.second.GetIdx() == anode_id) {
-          return anode_cfg.second;
+          return &anode_cfg.second;
         }
       }
-      std::fprintf(stderr, "No anode with id %i found in register. abort.\n\n", anode_id); 
-      exit(EXIT_FAILURE);
+      return nullptr;
+    }
+    inline SLArCfgAnode& GetAnodeCfgByID(const int anode_id) {
+      SLArCfgAnode* anode_cfg = FindAnodeCfgByID(anode_id); 
+      if (anode_cfg == nullptr) {
+        char error_msg[100]; 
+        std::snprintf(error_msg, sizeof(error_msg), 
+            "No anode with id %i found in register.\n\n", anode_id); 
+        throw std::runtime_error(error_msg); 
+      }
+      return *anode_cfg;
     }
+    void BuildCfgIndexTables(); 
+    inline bool IsCfgIndexFrozen() const {return fCfgIndexFrozen;}
     inline const std::map<G4String, G4double>& GetPhysicsBiasingMap() {return fBiasing;}
     inline const std::vector<SLArXSecDumpSpec>& GetXSecDumpVector() {return fXSecDump;}
     inline void SetEventNumber(Int_t event_number) {
@@ -156,6 +262,10 @@ class SLArAnalysisManager
     inline int GetXSNPoints () const {return fXSecNPoints;}
     inline void SetStoreTrajectoryFull(const bool store_trj_pts) {fTrajectoryFull = store_trj_pts;} 
     inline G4bool StoreTrajectoryFull() const {return fTrajectoryFull;}
+    inline void SetTrajectoryPointPolicy(const ETrjPointPolicy policy) {fTrjPointPolicy = policy;}
+    inline ETrjPointPolicy GetTrajectoryPointPolicy() const {return fTrjPointPolicy;}
+    inline void SetTrajectoryPointTolerance(const G4double tol) {fTrjPointTolerance = tol;}
+    inline G4double GetTrajectoryPointTolerance() const {return fTrjPointTolerance;}
 
     SLArAnalysisManagerMsgr* fAnaMsgr;
 #ifdef SLAR_EXTERNAL
@@ -178,6 +288,8 @@ class SLArAnalysisManager
     G4String fOutputPath;
     G4String fOutputFileName;
     G4bool   fTrajectoryFull;
+    ETrjPointPolicy fTrjPointPolicy = kStoreAllPoints;
+    G4double fTrjPointTolerance = 1.0; // mm
     std::map<G4String, G4double> fBiasing; 
     std::vector<SLArXSecDumpSpec> fXSecDump;
     G4double fXSecEmin = 0.01;
@@ -191,6 +303,46 @@ class SLArAnalysisManager
     bool   fEnableEventAnodeOutput = true;
     bool   fEnableEventPDSOutput = true;
     bool   fEnableGenTreeOutput = true;
+    bool   fEnableFlatOutput = false;
+    SLArFlatOutput fFlatOutput;
+    bool   fEnableProfiling = false;
+    SLArProfiler fProfiler;
+    bool   fEnableDirectPhotonHits = false; //!< photon SDs register hits in the event model
+    G4bool fKeepWorkerOutput = false;
+    G4int    fCompressionSettings = ROOT::RCompressionSetting::EDefaults::kUseCompiledDefault;
+    Long64_t fAutoFlush = -30000000;
+    Long64_t fAutoSave = -300000000;
+    G4int    fSplitLevel = 99;
+    G4int    fBasketSize = 32000;
+    std::vector<std::pair<G4String, G4int>> fBranchBasketSize;
+    void   ApplyOutputTuning(TTree* tree); 
+    void   FillFlatOutput(const Int_t ev_number, SLArMCTruth& mc_truth, const SLArListEventAnode& ev_anode); 
+    EOutputMode fOutputMode = kSyncOutput;
+    SLArEventBuffer* fOutputBuffer = {};
+#ifdef G4MULTITHREADED
+    G4TaskGroup<void>* fOutputTaskGroup = {};
+    std::shared_ptr<std::atomic<G4bool>> fOutputTaskClaim; //!< claim flag of the pending output task
+#endif
+    G4int fOutputQueueDepth = 2;
+    EOutputBackPressure fOutputBackPressure = kBlockOnFullQueue;
+    std::thread* fOutputWriter = {};
+    std::mutex fOutputMutex;
+    std::condition_variable fOutputCondition;
+    SLArEventBuffer* fBufferPrototype = {};
+    std::vector<SLArEventBuffer*> fBufferPool;
+    std::deque<SLArEventBuffer*> fFreeBuffers;
+    std::deque<SLArEventBuffer*> fFilledBuffers;
+    G4bool fStopWriter = false;
+    G4bool fWriterBusy = false;
+    G4long fOutputStalls = 0;
+    G4bool SetupOutputStage(); 
+    void   ReleaseOutputStage(); 
+    void   OutputWriterLoop(); 
+    void   FinalizeEventAnode(SLArListEventAnode& ev_anode); 
+    void   WriteOutputBuffer(); 
+    void   ClaimOutputTask(); 
+    std::vector<G4String> fWorkerOutputs;
+    std::vector<G4String> fDisabledSD;
     Int_t  fEventNumber = 0;
     SLArMCTruth fListMCPrimary;
     SLArGenRecordsVector fListGenRecords; 
@@ -208,6 +360,8 @@ class SLArAnalysisManager
 
     SLArCfgSystemSuperCell fPDSysCfg;
     std::map<int, SLArCfgAnode> fAnodeCfg;
+    bool fCfgIndexFrozen = false; //!< readout configuration index tables are built
+    std::vector<SLArCfgAnode*> fAnodeCfgByID; //!< anode configurations indexed by anode id
 };
 
 #endif /* end of include guard SLArANALYSISMANAGER_HH */
@@ -50,11 +50,27 @@ class SLArAnalysisManagerMsgr : public G4UImessenger
     G4UIcmdWithABool*           fCmdEnableMCTruthOutput;
     G4UIcmdWithABool*           fCmdEnableAnodeOutput; 
     G4UIcmdWithABool*           fCmdEnablePDSOutput;
+    G4UIcmdWithABool*           fCmdEnableFlatOutput;
+    G4UIcmdWithABool*           fCmdEnableProfiling;
+    G4UIcmdWithABool*           fCmdEnableDirectPhotonHits;
     G4UIcmdWithAString*         fCmdDisableSD;
     G4UIcmdWithABool*           fCmdStoreFullTrajectory;
+    G4UIcmdWithAString*         fCmdSetTrjPointPolicy;
+    G4UIcmdWithADoubleAndUnit*  fCmdSetTrjPointTolerance;
     G4UIcmdWithAString*         fCmdEnableBacktracker;
     G4UIcmdWithAString*         fCmdRegisterBacktracker;
     G4UIcmdWithAnInteger*       fCmdSetZeroSuppressionThrs;
+    G4UIcmdWithAString*         fCmdSetHitStoragePolicy;
+    G4UIcmdWithABool*           fCmdKeepWorkerOutput;
+    G4UIcmdWithAString*         fCmdSetOutputMode;
+    G4UIcmdWithAnInteger*       fCmdSetOutputQueueDepth;
+    G4UIcmdWithAString*         fCmdSetOutputBackPressure;
+    G4UIcmdWithAString*         fCmdSetCompression;
+    G4UIcmdWithAnInteger*       fCmdSetAutoFlush;
+    G4UIcmdWithAnInteger*       fCmdSetAutoSave;
+    G4UIcmdWithAnInteger*       fCmdSetSplitLevel;
+    G4UIcmdWithAString*         fCmdSetBasketSize;
+    G4UIcmdWithAString*         fCmdLoadOutputConfig;
     G4UIcmdWithADoubleAndUnit*  fCmdXSecEMin;
     G4UIcmdWithADoubleAndUnit*  fCmdXSecEMax;
     G4UIcmdWithAnInteger*       fCmdXSecNPoints;
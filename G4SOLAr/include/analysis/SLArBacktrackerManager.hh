@@ -25,6 +25,7 @@ class SLArBacktrackerManager {
 
     G4bool RegisterBacktracker(SLArBacktracker* bkt); 
     G4bool RegisterBacktracker(const EBacktracker id, const G4String name = "");
+    G4bool CloneBacktrackers(const SLArBacktrackerManager& other);
     G4bool IsNull() const;
 
   protected:
@@ -0,0 +1,77 @@
+/**
+ * @author      Daniele Guffanti (daniele.guffanti@mib.infn.it)
+ * @file        SLArFlatOutput.hh
+ * @created     Saturday Oct 17, 2026 18:02:36 CEST
+ */
+
+#ifndef SLARFLATOUTPUT_HH
+
+#define SLARFLATOUTPUT_HH
+
+#include "TFile.h"
+#include "TTree.h"
+
+#include "event/SLArMCTruth.hh"
+#include "event/SLArEventAnode.hh"
+
+/**
+ * @brief Columnar (one row per record) copy of the event output
+ *
+ * Flat trees with scalar branches only, written alongside the EventTree:
+ * - PixelHitTree: one row per (pixel, clock tick) of the charge readout
+ * - TrajectoryPointTree: one row per stored trajectory point
+ *
+ * Analyses can read a subset of the columns (e.g. with RDataFrame or
+ * the TTree bulk I/O) without deserializing the nested event objects.
+ */
+class SLArFlatOutput {
+  public:
+    struct pixel_row_t {
+      Int_t    fEvNumber;
+      Int_t    fAnode;
+      Int_t    fMegaTile;
+      Int_t    fTile;
+      Int_t    fPixel;
+      Int_t    fTick;
+      Float_t  fTime;
+      UShort_t fCount;
+    };
+
+    struct trj_point_row_t {
+      Int_t   fEvNumber;
+      Int_t   fPrimaryID;
+      Int_t   fTrkID;
+      Int_t   fParentID;
+      Int_t   fPDGCode;
+      Int_t   fPoint;
+      Float_t fX;
+      Float_t fY;
+      Float_t fZ;
+      Float_t fKEnergy;
+      Float_t fEdep;
+      Int_t   fNph;
+      Int_t   fNel;
+      Int_t   fCopy;
+      Bool_t  fLAr;
+    };
+
+    SLArFlatOutput();
+    ~SLArFlatOutput() {}
+
+    void CreateTrees(TFile* file);
+    size_t FillAnode(const Int_t ev_number, const SLArListEventAnode& ev_anode);
+    size_t FillTrajectories(const Int_t ev_number, SLArMCTruth& mc_truth);
+    inline TTree* GetPixelHitTree() {return fPixelHitTree;}
+    inline TTree* GetTrajectoryPointTree() {return fTrjPointTree;}
+    inline void SetPixelHitTree(TTree* t) {fPixelHitTree = t;}
+    inline void SetTrajectoryPointTree(TTree* t) {fTrjPointTree = t;}
+
+  private:
+    TTree* fPixelHitTree;
+    TTree* fTrjPointTree;
+    pixel_row_t fPixelRow;
+    trj_point_row_t fTrjPointRow;
+};
+
+#endif /* end of include guard SLARFLATOUTPUT_HH */
+
@@ -0,0 +1,156 @@
+/**
+ * @author      Daniele Guffanti (daniele.guffanti@mib.infn.it)
+ * @file        SLArProfiler.hh
+ * @created     Saturday Oct 17, 2026 22:41:26 CEST
+ */
+
+#ifndef SLARPROFILER_HH
+
+#define SLARPROFILER_HH
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include "TFile.h"
+#include "TTree.h"
+
+#include "globals.hh"
+
+/**
+ * @brief Per-thread timing and memory telemetry of the simulation
+ *
+ * Accumulates the time spent in the main subsystems of solar_sim (see
+ * ESection) through SLArProfileScope timers placed in the code, and
+ * records for each event the time of each section, the event wall time,
+ * the memory footprint and a few event counters. The records are written
+ * in the ProfileTree of the output file at the end of the run and a
+ * summary is printed.
+ *
+ * The timers are always compiled but only active when profiling is
+ * enabled with /SLAr/manager/enableProfiling: a disabled timer costs
+ * a thread-local pointer check.
+ */
+class SLArProfiler {
+  public:
+    //! Instrumented sections. Nested sections are timed inclusively
+    enum ESection {
+      kLArSD = 0,        //!< SLArLArSD::ProcessHits (includes the electron drift)
+      kReadoutTileSD,    //!< SLArReadoutTileSD::ProcessHits_constStep
+      kSuperCellSD,      //!< SLArSuperCellSD::ProcessHits_constStep
+      kExtScorerSD,      //!< SLArExtScorerSD::ProcessHits
+      kElectronDrift,    //!< SLArElectronDrift::Drift
+      kScintillation,    //!< SLArScintillation::PostStepDoIt
+      kStacking,         //!< SLArStackingAction::ClassifyNewTrack
+      kBacktracker,      //!< evaluation of the backtrackers of a hit
+      kZeroSuppression,  //!< hit consolidation and zero suppression of the anode
+      kFillTree,         //!< SLArAnalysisManager::FillTree
+      kNSections
+    };
+
+    //! Event counters
+    enum ECounter {
+      kNTrajectories = 0, //!< trajectories stored in the MC truth
+      kNChargeHits,       //!< electrons registered on the anode pixels
+      kNPhotonHits,       //!< photon hits registered on the photon detectors
+      kNCounters
+    };
+
+    //! Telemetry of a single event
+    struct SLArProfileRecord {
+      Int_t    fEvNumber;
+      Int_t    fThreadID;
+      Double_t fEventTime;                  //!< [ms]
+      Double_t fRSS;                        //!< [MB]
+      Double_t fPeakRSS;                    //!< [MB]
+      Long64_t fCounts[kNCounters];
+      Double_t fSectionTime[kNSections];    //!< [ms]
+      Long64_t fSectionCalls[kNSections];
+    };
+
+    SLArProfiler();
+    ~SLArProfiler();
+
+    static inline SLArProfiler* GetActive() {return fgActive;}
+    static const char* GetSectionName(const ESection section);
+    static const char* GetCounterName(const ECounter counter);
+    static Double_t GetResidentMemory();
+    static Double_t GetPeakResidentMemory();
+
+    void Activate(const G4bool enable);
+    inline G4bool IsEnabled() const {return fEnabled;}
+    void Reset();
+    void BeginEvent();
+    void EndEvent(const Int_t ev_number);
+    inline void AddTime(const ESection section, const Long64_t ns) {
+      fTotalTime[section].fetch_add(ns, std::memory_order_relaxed);
+      fTotalCalls[section].fetch_add(1, std::memory_order_relaxed);
+    }
+    inline void Count(const ECounter counter, const Long64_t n) {
+      if (fEnabled) fEventCounts[counter] += n;
+    }
+    static inline void CountActive(const ECounter counter, const Long64_t n) {
+      if (fgActive) fgActive->Count(counter, n);
+    }
+
+    TTree* FillProfileTree(TFile* file);
+    inline TTree* GetProfileTree() {return fProfileTree;}
+    inline void SetProfileTree(TTree* t) {fProfileTree = t;}
+    inline const std::vector<SLArProfileRecord>& GetRecords() const {return fRecords;}
+    void PrintSummary() const;
+
+  private:
+    static G4ThreadLocal SLArProfiler* fgActive;
+
+    G4bool fEnabled;
+    std::array<std::atomic<Long64_t>, kNSections> fTotalTime; //!< [ns]
+    std::array<std::atomic<Long64_t>, kNSections> fTotalCalls;
+    std::array<Long64_t, kNSections> fEventStartTime;
+    std::array<Long64_t, kNSections> fEventStartCalls;
+    std::array<Long64_t, kNCounters> fEventCounts;
+    std::chrono::steady_clock::time_point fEventStart;
+    std::vector<SLArProfileRecord> fRecords;
+    TTree* fProfileTree;
+};
+
+/**
+ * @brief Scoped timer of a SLArProfiler section
+ *
+ * The time between construction and destruction is added to the section
+ * of the active profiler of the thread (or of the given profiler, for
+ * code that can run outside the simulation threads, e.g. the output
+ * stage). Does nothing when profiling is disabled.
+ */
+class SLArProfileScope {
+  public:
+    inline SLArProfileScope(const SLArProfiler::ESection section)
+      : fProfiler(SLArProfiler::GetActive()), fSection(section)
+    {
+      if (fProfiler) fStart = std::chrono::steady_clock::now();
+    }
+
+    inline SLArProfileScope(SLArProfiler& profiler, const SLArProfiler::ESection section)
+      : fProfiler(profiler.IsEnabled() ? &profiler : nullptr), fSection(section)
+    {
+      if (fProfiler) fStart = std::chrono::steady_clock::now();
+    }
+
+    inline ~SLArProfileScope() {
+      if (fProfiler == nullptr) return;
+      const auto dt = std::chrono::steady_clock::now() - fStart;
+      fProfiler->AddTime(fSection,
+          std::chrono::duration_cast<std::chrono::nanoseconds>(dt).count());
+    }
+
+    SLArProfileScope(const SLArProfileScope&) = delete;
+    SLArProfileScope& operator=(const SLArProfileScope&) = delete;
+
+  private:
+    SLArProfiler* fProfiler;
+    SLArProfiler::ESection fSection;
+    std::chrono::steady_clock::time_point fStart;
+};
+
+#endif /* end of include guard SLARPROFILER_HH */
+
@@ -11,6 +11,8 @@
 #include "G4VUserTrackInformation.hh"
 #include "event/SLArEventTrajectory.hh"
 
+class SLArMCPrimaryInfo; 
+
 class SLArUserTrackInformation : public G4VUserTrackInformation {
   public: 
     SLArUserTrackInformation(SLArEventTrajectory* trj); 
@@ -22,13 +24,18 @@ class SLArUserTrackInformation : public G4VUserTrackInformation {
     inline SLArEventTrajectory* GimmeEvTrajectory() {return fTrajectory;}
     inline const SLArEventTrajectory* GimmeConstEvTrajectory() {return fTrajectory;}
     inline void MakeTrajectory(); 
+    inline G4int GetAncestorID() const {return fAncestorID;}
+    inline SLArMCPrimaryInfo* GetAncestor() const {return fAncestor;}
 
     inline void SetStoreTrajectory(const G4bool doStore) {fStoreTrajectory = doStore;}
     inline void SetTrajectory(SLArEventTrajectory& trajectory) {fTrajectory = &trajectory;} 
+    inline void SetAncestor(const G4int id, SLArMCPrimaryInfo* primary) {fAncestorID = id; fAncestor = primary;}
 
   private:
     SLArEventTrajectory* fTrajectory;
     G4bool fStoreTrajectory; 
+    G4int fAncestorID; //!< ID of the primary ancestor, resolved at track creation
+    SLArMCPrimaryInfo* fAncestor; //!< MCTruth record of the primary ancestor
     G4int fNphTemp; 
     G4int fNelTemp; 
 
@@ -15,6 +15,7 @@
 class G4Step;  
 class G4HCofThisEvent;
 class G4TouchableHistory;
+class SLArPhysicsList;
 
 /// LAr-volume sensitive detector
 
@@ -31,6 +32,7 @@ private:
     SLArLArHitsCollection* fHitsCollection;
     G4int    fHCID;
     G4int    fTPCID;
+    const SLArPhysicsList* fPhysicsList;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
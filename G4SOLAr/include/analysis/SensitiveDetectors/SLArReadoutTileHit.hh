@@ -16,20 +16,29 @@
 #include "G4Transform3D.hh"
 #include "G4RotationMatrix.hh"
 
+#include <cstdint>
+
 class G4AttDef;
 class G4AttValue;
 
 /// ReadoutTile hit
 ///
 /// It records:
-/// - the ReadoutTile ID
-/// - the particle time
-/// - the particle local and global positions
+/// - the channel key, packing the replica numbers of the touchable
+///   (anode, megatile row, megatile, tile row, tile, cell row, cell)
+/// - the photon creator process, wavelength, time and producer track
+/// - the particle local and global positions (single precision)
 
 
 class SLArReadoutTileHit : public G4VHit
 {
 public:
+    //! Photon creator process (values as in the event EPhProcess)
+    enum EPhotonProcess {kNoProcess = -1, kCerenkov = 1, kScintillation = 2, kWLS = 3, kOtherProcess = 4};
+
+    //! Bit layout of the channel key (from the least significant bit)
+    enum EChannelField {kCell = 0, kRowCell, kTile, kRowTile, kMegaTile, kRowMegaTile, kAnode, kNChannelFields};
+
     SLArReadoutTileHit();
     SLArReadoutTileHit(G4double z);
     SLArReadoutTileHit(const SLArReadoutTileHit &right);
@@ -52,49 +61,60 @@ public:
     void SetTime(G4double t) { fTime = t; }
     G4double GetTime() const { return fTime / CLHEP::ns; }
 
-    void SetLocalPos(G4ThreeVector xyz) { fLocalPos = xyz; }
-    G4ThreeVector GetLocalPos() const { return fLocalPos; }
+    void SetLocalPos(const G4ThreeVector& xyz) { for (int i=0; i<3; i++) fLocalPos[i] = xyz[i]; }
+    G4ThreeVector GetLocalPos() const { return G4ThreeVector(fLocalPos[0], fLocalPos[1], fLocalPos[2]); }
 
-    void SetWorldPos(G4ThreeVector xyz) { fWorldPos = xyz; }
-    G4ThreeVector GetWorldPos() const { return fWorldPos; }
+    void SetWorldPos(const G4ThreeVector& xyz) { for (int i=0; i<3; i++) fWorldPos[i] = xyz[i]; }
+    G4ThreeVector GetWorldPos() const { return G4ThreeVector(fWorldPos[0], fWorldPos[1], fWorldPos[2]); }
 
+    static EPhotonProcess GetPhotonProcessType(const G4String& prname);
     void      SetPhotonProcess(G4String prname);
+    inline void SetPhotonProcessType(const EPhotonProcess type) { fPhType = type; }
     G4int     GetPhotonProcessId() const;
     G4String  GetPhotonProcessName() const;
 
-    inline void SetAnodeIdx(G4int idx) { fAnodeIdx= idx; }
-    inline G4int GetAnodeIdx() const { return fAnodeIdx; }
-    inline void SetRowMegaTileReplicaNr(G4int idx) { fRowMegaTileReplicaNr= idx; }
-    inline G4int GetRowMegaTileReplicaNr() const { return fRowMegaTileReplicaNr; }
-    inline void SetMegaTileReplicaNr(G4int idx) { fMegaTileReplicaNr= idx; }
-    inline G4int GetMegaTileReplicaNr() const { return fMegaTileReplicaNr; }
-    inline void SetRowTileReplicaNr(G4int idx) { fRowTileReplicaNr= idx; }
-    inline G4int GetRowTileReplicaNr() const { return fRowTileReplicaNr; }
-    inline void SetTileReplicaNr(G4int idx) { fTileReplicaNr= idx; }
-    inline G4int GetTileReplicaNr() const { return fTileReplicaNr; }
-    inline void SetCellNr(G4int n) {fCellNr = n;}
-    inline G4int GetCellNr() const {return fCellNr;}
+    static G4bool IsValidChannel(const G4int anode, const G4int mt_row, const G4int mt, 
+        const G4int tile_row, const G4int tile, const G4int cell_row, const G4int cell);
+    static inline G4int GetChannelField(const uint64_t key, const EChannelField field) {
+      return static_cast<G4int>( (key >> kChannelShift[field]) & kChannelMask[field] );
+    }
+    //! Channel key of the tile (cell fields cleared)
+    static inline uint64_t GetTileKey(const uint64_t key) {
+      return (key >> kChannelShift[kTile]) << kChannelShift[kTile];
+    }
+    static uint64_t PackChannel(const G4int anode, const G4int mt_row, const G4int mt, 
+        const G4int tile_row, const G4int tile, const G4int cell_row, const G4int cell);
+    inline void SetChannel(const G4int anode, const G4int mt_row, const G4int mt, 
+        const G4int tile_row, const G4int tile, const G4int cell_row, const G4int cell) {
+      fChannelKey = PackChannel(anode, mt_row, mt, tile_row, tile, cell_row, cell);
+    }
+    inline void SetChannelKey(const uint64_t key) { fChannelKey = key; }
+    inline uint64_t GetChannelKey() const { return fChannelKey; }
+
+    inline G4int GetAnodeIdx() const { return GetChannelField(fChannelKey, kAnode); }
+    inline G4int GetRowMegaTileReplicaNr() const { return GetChannelField(fChannelKey, kRowMegaTile); }
+    inline G4int GetMegaTileReplicaNr() const { return GetChannelField(fChannelKey, kMegaTile); }
+    inline G4int GetRowTileReplicaNr() const { return GetChannelField(fChannelKey, kRowTile); }
+    inline G4int GetTileReplicaNr() const { return GetChannelField(fChannelKey, kTile); }
+    inline G4int GetRowCellNr() const { return GetChannelField(fChannelKey, kRowCell); }
+    inline G4int GetCellNr() const { return GetChannelField(fChannelKey, kCell); }
     inline void SetProducerID(const int trk_id) {fPhProducerID = trk_id;}
     inline G4int GetProducerID() const {return fPhProducerID;}
-    void SetRowCellNr(G4int n) {fRowCellNr = n;}
-    G4int GetRowCellNr() {return fRowCellNr;}
 
     G4String GetProcessName(int kType) const;
 
 private:
-    G4int         fAnodeIdx; 
-    G4int         fRowMegaTileReplicaNr;
-    G4int         fMegaTileReplicaNr;
-    G4int         fRowTileReplicaNr; 
-    G4int         fTileReplicaNr;
-    G4int         fRowCellNr; 
-    G4int         fCellNr; 
-    G4double      fWavelength;
+    static constexpr int kChannelShift[kNChannelFields] = {0, 8, 16, 24, 32, 42, 52};
+    static constexpr uint64_t kChannelMask[kNChannelFields] = {
+      0xff, 0xff, 0xff, 0xff, 0x3ff, 0x3ff, 0xfff};
+
+    uint64_t      fChannelKey;
+    G4float       fWavelength;
     G4float       fTime;
-    G4int         fPhType;
     G4int         fPhProducerID;
-    G4ThreeVector fLocalPos;
-    G4ThreeVector fWorldPos;
+    G4int         fPhType;
+    G4float       fLocalPos[3];
+    G4float       fWorldPos[3];
 };
 
 typedef G4THitsCollection<SLArReadoutTileHit> SLArReadoutTileHitsCollection;
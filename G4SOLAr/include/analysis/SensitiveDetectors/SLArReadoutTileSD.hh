@@ -12,9 +12,17 @@
 
 #include "SensitiveDetectors/SLArReadoutTileHit.hh"
 
+#include <utility>
+#include <vector>
+#include <unordered_map>
+
 class G4Step;
 class G4HCofThisEvent;
 class G4TouchableHistory;
+class G4VProcess;
+class SLArEventMegatile;
+class SLArEventTile;
+class SLArEventPhotonHit;
 
 class SLArReadoutTileSD : public G4VSensitiveDetector
 {
@@ -28,8 +36,27 @@ public:
                                  G4TouchableHistory* );
    
 private:
+    //! Tile of the output event hit by the photons of a channel
+    struct SLArEventTileRef {
+      SLArEventMegatile* fMegaTile = nullptr;
+      SLArEventTile* fTile = nullptr;
+    };
+
+    SLArReadoutTileHit::EPhotonProcess GetCreatorType(const G4VProcess* creator);
+    SLArEventTileRef* GetEventTile(const uint64_t tile_key, const G4int anode_idx, 
+        const SLArEventPhotonHit& hit);
+    void RegisterEventHit(SLArEventPhotonHit& hit, const uint64_t tile_key, 
+        const G4int anode_idx);
+
     SLArReadoutTileHitsCollection* fHitsCollection;
     G4int fHCID;
+    //! Photon creator processes already classified by this SD
+    std::vector<std::pair<const G4VProcess*, SLArReadoutTileHit::EPhotonProcess>> fCreatorTypes;
+    //! Register the hits in the output event instead of the hits collection
+    G4bool fDirectHits;
+    G4int fNCellRow; //!< number of cells in a readout tile row
+    //! Output event tiles hit in the current event (by channel key without cell bits)
+    std::unordered_map<uint64_t, SLArEventTileRef> fEventTiles;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -63,6 +63,7 @@ public:
     void SetWorldPos(G4ThreeVector xyz) { fWorldPos = xyz; }
     G4ThreeVector GetWorldPos() const { return fWorldPos; }
 
+    static G4int GetPhotonProcessType(const G4String& prname);
     void      SetPhotonProcess(G4String prname);
     G4int     GetPhotonProcessId() const;
     G4String  GetPhotonProcessName() const;
@@ -35,9 +35,15 @@
 
 #include "SensitiveDetectors/SLArSuperCellHit.hh"
 
+#include <cstdint>
+#include <unordered_map>
+
 class G4Step;
 class G4HCofThisEvent;
 class G4TouchableHistory;
+class SLArEventSuperCell;
+class SLArEventSuperCellArray;
+class SLArEventPhotonHit;
 
 /// Drift chamber sensitive detector
 
@@ -53,8 +59,21 @@ public:
                                  G4TouchableHistory* );
    
 private:
+    //! SuperCell of the output event hit by the photons of a channel
+    struct SLArEventSuperCellRef {
+      SLArEventSuperCellArray* fArray = nullptr;
+      SLArEventSuperCell* fSuperCell = nullptr;
+    };
+
+    SLArEventSuperCellRef* GetEventSuperCell(const G4int array_nr, const SLArEventPhotonHit& hit);
+    void RegisterEventHit(SLArEventPhotonHit& hit, const G4int array_nr);
+
     SLArSuperCellHitsCollection* fHitsCollection;
     G4int fHCID;
+    //! Register the hits in the output event instead of the hits collection
+    G4bool fDirectHits;
+    //! Output event SuperCells hit in the current event (by array nr and tile ID)
+    std::unordered_map<uint64_t, SLArEventSuperCellRef> fEventSuperCells;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -9,13 +9,25 @@
 #define SLARCFGSYSTEMPIX_HH
 
 #include <vector>
+#include <array>
 #include "TH2Poly.h"
 #include "config/SLArCfgAssembly.hh"
 #include "config/SLArCfgMegaTile.hh"
+#include "config/SLArPolyBinLookup.hh"
 
 class SLArCfgAnode : public SLArCfgAssembly<SLArCfgMegaTile> {
   public: 
     typedef std::array<int, 3> SLArPixIdx; 
+
+    //! Pixel index and bounding box projected on the anode axes
+    struct SLArPixCell {
+      SLArPixIdx fIdx; 
+      double fX0min; 
+      double fX0max; 
+      double fX1min; 
+      double fX1max; 
+    };
+
     SLArCfgAnode(); 
     SLArCfgAnode(const SLArCfgAssembly<SLArCfgMegaTile>& cfg); 
     SLArCfgAnode(TString name); 
@@ -24,15 +36,40 @@ class SLArCfgAnode : public SLArCfgAssembly<SLArCfgMegaTile> {
 
     TH2Poly* ConstructPixHistMap(const int depth, const std::vector<int>); 
     SLArPixIdx GetPixelBinIndex(const double& x, const double& y); 
-    SLArPixIdx GetPixelIndex(const double& x, const double& y); 
+    inline SLArPixIdx GetPixelIndex(const double& x, const double& y) {
+      if (fUsePixelLookup && fPixelLookupBuilt) return GetPixelIndexLookup(x, y);
+      return GetPixelIndexTH2Poly(x, y);
+    }
+    SLArPixIdx GetPixelIndexTH2Poly(const double& x, const double& y); 
+    SLArPixIdx GetPixelIndexLookup(const double& x, const double& y) const; 
+    bool FindPixelCell(const double& x, const double& y, SLArPixCell& cell) const; 
+    bool GetPixelPitch(double& pitch0, double& pitch1) const; 
+    void BuildPixelLookup(); 
+    void ClearPixelLookup(); 
+    size_t ValidatePixelLookup(const size_t n_points, const unsigned int seed = 4357); 
+    inline bool IsPixelLookupBuilt() const {return fPixelLookupBuilt;}
+    inline void SetUsePixelLookup(const bool use_lookup) {fUsePixelLookup = use_lookup;}
+    inline bool UsePixelLookup() const {return fUsePixelLookup;}
     void RegisterMap(size_t ilevel, TH2Poly* hmap); 
     inline TH2Poly* GetAnodeMap(size_t ilevel) {return fAnodeLevelsMap.at(ilevel).get();}
     inline int GetTPCID() const {return fTPCID;}
     inline void SetTPCID(int tpcID) {fTPCID = tpcID;}
 
   protected:
+    //! Precomputed position of a megatile/tile projected on the anode axes
+    struct SLArPixLookupNode {
+      int    fIdx; //!< element index
+      double fX0; //!< position projected on fAxis0
+      double fX1; //!< position projected on fAxis1
+    };
+
     std::vector<std::unique_ptr<TH2Poly>> fAnodeLevelsMap; 
     int fTPCID; 
+    bool fUsePixelLookup; //! Use the constant-time pixel lookup when available
+    bool fPixelLookupBuilt; //! Pixel lookup tables are built
+    std::array<SLArPolyBinLookup, 3> fLevelLookup; //! Lookup grids for megatile, tile and pixel maps
+    std::vector<SLArPixLookupNode> fMegaTileNode; //! Megatile nodes (indexed by bin-1)
+    std::vector<std::vector<SLArPixLookupNode>> fTileNode; //! Tile nodes (indexed by megatile, tile bin-1)
 
   public:
     ClassDefOverride(SLArCfgAnode, 2); 
@@ -28,41 +28,52 @@ class SLArCfgAssembly : public SLArCfgBaseModule {
     virtual void DumpMap() const;
     virtual void DumpInfo() const override; 
     inline TBaseModule& GetBaseElementByBin(const int ibin) {
-      auto itr = fBinToIdxMap.find(ibin); 
-      if (itr == fBinToIdxMap.end()) {
-        fprintf(stderr, "SLArCfgAssembly::GetBaseElementByBin ERROR: Module with Bin Index %i not found in records\n", ibin);
-        exit(EXIT_FAILURE);
-      }
-      int module_idx = itr->second;
-      return fElementsMap.at(module_idx); 
+      const int module_idx = GetElementIdxByBin(ibin); 
+      if (module_idx < 0) ThrowMissingElement("GetBaseElementByBin", "Bin Index", ibin); 
+      return fElementsMap[module_idx]; 
     }
     inline const TBaseModule& GettBaseElementByBin(const int ibin) const {
-      auto itr = fBinToIdxMap.find(ibin); 
-      if (itr == fBinToIdxMap.end()) {
-        fprintf(stderr, "SLArCfgAssembly::GetBaseElementByBin ERROR: Module with Bin Index %i not found in records\n", ibin);
-        exit(EXIT_FAILURE);
-      }
-      int module_idx = itr->second;
-      return fElementsMap.at(module_idx); 
+      const int module_idx = GetElementIdxByBin(ibin); 
+      if (module_idx < 0) ThrowMissingElement("GetBaseElementByBin", "Bin Index", ibin); 
+      return fElementsMap[module_idx]; 
     }; 
     inline TBaseModule& GetBaseElementByID(int const id) {
-      auto itr = fIDtoIdxMap.find(id); 
-      if (itr == fIDtoIdxMap.end()) {
-        fprintf(stderr, "SLArCfgAssembly::GetBaseElementByID ERROR: Module with ID %i not found in records\n", id);
-        exit(EXIT_FAILURE);
-      }
-      int module_idx = itr->second;
-      return fElementsMap.at(module_idx); 
+      const int module_idx = GetElementIdxByID(id); 
+      if (module_idx < 0) ThrowMissingElement("GetBaseElementByID", "ID", id); 
+      return fElementsMap[module_idx]; 
     }
     inline const TBaseModule& GetBaseElementByID(const int id) const {
-      auto itr = fIDtoIdxMap.find(id);
-      if (itr == fIDtoIdxMap.end()) {
-        fprintf(stderr, "SLArCfgAssembly::GetBaseElementByID ERROR: Module with ID %i not found in records\n", id);
-        exit(EXIT_FAILURE);
-      }
-      const int module_idx = itr->second;
-      return fElementsMap.at(module_idx); 
+      const int module_idx = GetElementIdxByID(id); 
+      if (module_idx < 0) ThrowMissingElement("GetBaseElementByID", "ID", id); 
+      return fElementsMap[module_idx]; 
     }; 
+    //! Return the element with the given ID or nullptr if not registered
+    inline TBaseModule* FindBaseElementByID(const int id) {
+      const int module_idx = GetElementIdxByID(id); 
+      return (module_idx < 0) ? nullptr : &fElementsMap[module_idx]; 
+    }
+    inline const TBaseModule* FindBaseElementByID(const int id) const {
+      const int module_idx = GetElementIdxByID(id); 
+      return (module_idx < 0) ? nullptr : &fElementsMap[module_idx]; 
+    }
+    //! Return the element index of the given ID (-1 if not registered)
+    inline int GetElementIdxByID(const int id) const {
+      if (fIndexFrozen) {
+        const size_t i = static_cast<size_t>(id - fIDOffset); 
+        return (i < fIDtoIdxTable.size()) ? fIDtoIdxTable[i] : -1; 
+      }
+      auto itr = fIDtoIdxMap.find(id); 
+      return (itr == fIDtoIdxMap.end()) ? -1 : itr->second; 
+    }
+    //! Return the element index of the given bin (-1 if not registered)
+    inline int GetElementIdxByBin(const int ibin) const {
+      if (fIndexFrozen) {
+        const size_t i = static_cast<size_t>(ibin - fBinOffset); 
+        return (i < fBinToIdxTable.size()) ? fBinToIdxTable[i] : -1; 
+      }
+      auto itr = fBinToIdxMap.find(ibin); 
+      return (itr == fBinToIdxMap.end()) ? -1 : itr->second; 
+    }
     inline TBaseModule& GetBaseElement(int const idx) {
       return fElementsMap.at(idx); 
     }
@@ -72,6 +83,9 @@ class SLArCfgAssembly : public SLArCfgBaseModule {
     inline std::vector<TBaseModule>& GetMap() {return fElementsMap;}
     inline const std::vector<TBaseModule>& GetConstMap() const {return fElementsMap;}
     void RegisterElement(TBaseModule& element);
+    virtual void BuildIndexTables(); 
+    virtual void ClearIndexTables(); 
+    inline bool IsIndexFrozen() const {return fIndexFrozen;}
     virtual TH2Poly* BuildPolyBinHist(const ESubModuleReferenceFrame kFrame = kWorld, const bool set_bin_idx = false, const int n = 25, const int m = 25);
     TGraph BuildGShape() const override; 
 
@@ -80,6 +94,14 @@ class SLArCfgAssembly : public SLArCfgBaseModule {
     std::vector<TBaseModule> fElementsMap;
     std::map<int, int> fBinToIdxMap;
     std::map<int, int> fIDtoIdxMap; 
+    bool fIndexFrozen; //! Dense index tables are built and the element list is frozen
+    int fIDOffset; //! Smallest element ID
+    int fBinOffset; //! Smallest element bin index
+    std::vector<int> fIDtoIdxTable; //! Element index by (ID - fIDOffset), -1 for holes
+    std::vector<int> fBinToIdxTable; //! Element index by (bin - fBinOffset), -1 for holes
+
+    void BuildBinIndexTable(); 
+    [[noreturn]] void ThrowMissingElement(const char* method, const char* key, const int value) const; 
 
   public:
     ClassDefOverride(SLArCfgAssembly,3);
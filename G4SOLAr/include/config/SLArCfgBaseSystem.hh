@@ -12,6 +12,7 @@
 #include <iostream>
 #include <fstream>
 #include <map>
+#include <vector>
 #include "SLArCfgMegaTile.hh"
 #include "SLArCfgBaseModule.hh"
 #include "SLArCfgSuperCellArray.hh"
@@ -26,21 +27,37 @@ class SLArCfgBaseSystem : public SLArCfgBaseModule
     SLArCfgBaseSystem(const SLArCfgBaseSystem& cfg);
     SLArCfgBaseSystem(TString name);
     ~SLArCfgBaseSystem();
+    SLArCfgBaseSystem& operator=(const SLArCfgBaseSystem& cfg); 
 
     //virtual TH2Poly* BuildPolyBinHist(); 
     void DumpMap() const;
     void DumpInfo() const override;
     TAssemblyModule& GetBaseElement(int idx); 
+    //! Return the element with the given index or nullptr if not registered
+    inline TAssemblyModule* FindBaseElement(const int idx) {
+      if (fIndexFrozen) {
+        const size_t i = static_cast<size_t>(idx - fIdxOffset); 
+        return (i < fIdxTable.size()) ? fIdxTable[i] : nullptr; 
+      }
+      auto itr = fElementsMap.find(idx); 
+      return (itr == fElementsMap.end()) ? nullptr : &itr->second; 
+    }
     TAssemblyModule& GetBaseElement(const char* name);
     TAssemblyModule& FindBaseElementInMap(int ibin); 
     std::map<int, TAssemblyModule>& GetMap() {return fElementsMap;}
     const std::map<int, TAssemblyModule>& GetConstMap() const {return fElementsMap;}
     void RegisterElement(TAssemblyModule& mod);
     TGraph BuildGShape() const override;
+    void BuildIndexTables(); 
+    void ClearIndexTables(); 
+    inline bool IsIndexFrozen() const {return fIndexFrozen;}
 
   protected:
     int fNElements; 
     std::map<int, TAssemblyModule> fElementsMap;
+    bool fIndexFrozen; //! Dense index table is built and the element list is frozen
+    int fIdxOffset; //! Smallest element index
+    std::vector<TAssemblyModule*> fIdxTable; //! Elements by (index - fIdxOffset), nullptr for holes
 
   public:
     ClassDefOverride(SLArCfgBaseSystem, 2);
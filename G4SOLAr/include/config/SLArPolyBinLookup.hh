@@ -0,0 +1,109 @@
+/**
+ * @author      : Daniele Guffanti (daniele.guffanti@mib.infn.it)
+ * @file        : SLArPolyBinLookup.hh
+ * @created     : Saturday Oct 17, 2026 10:12:41 CEST
+ * @brief       : Constant-time bin lookup for TH2Poly-based readout maps
+ */
+
+#ifndef SLARPOLYBINLOOKUP_HH
+
+#define SLARPOLYBINLOOKUP_HH
+
+#include <vector>
+#include <cmath>
+
+class TH2Poly;
+
+/**
+ * @brief Uniform-grid accelerator for TH2Poly::FindBin
+ *
+ * The bins of the TH2Poly are sorted into the cells of a regular grid.
+ * When the bins are axis-aligned rectangles replicated with a constant
+ * pitch (as it is the case for megatiles, tiles and pixels) the grid is
+ * aligned to the replication lattice, so that the lookup reduces to an
+ * affine transformation plus an integer division followed by a single
+ * bounds check. Irregular layouts are handled by testing the (few)
+ * polygons overlapping the selected cell.
+ *
+ * The returned value is the same as the one of TH2Poly::FindBin,
+ * including the negative overflow/underflow codes.
+ */
+class SLArPolyBinLookup {
+  public:
+    SLArPolyBinLookup();
+    ~SLArPolyBinLookup() {}
+
+    void Build(TH2Poly* h2);
+    void Clear();
+    inline bool IsBuilt() const {return fIsBuilt;}
+    inline bool IsRegular() const {return fIsRegular;}
+    inline int GetNCellsX() const {return fNx;}
+    inline int GetNCellsY() const {return fNy;}
+    inline double GetCellSizeX() const {return (fInvDx > 0) ? 1.0/fInvDx : 0.;}
+    inline double GetCellSizeY() const {return (fInvDy > 0) ? 1.0/fInvDy : 0.;}
+    bool GetBinEdges(const int bin, double& xmin, double& xmax, double& ymin, double& ymax) const;
+    inline int FindBin(const double x, const double y) const {
+      // reproduce TH2Poly overflow/underflow codes
+      int overflow = 0;
+      if (y > fYmax) overflow += -1;
+      else if (y > fYmin) overflow += -4;
+      else overflow += -7;
+      if (x > fXmax) overflow += -2;
+      else if (x > fXmin) overflow += -1;
+      if (overflow != -5) return overflow;
+
+      int ix = static_cast<int>( std::floor( (x-fX0)*fInvDx ) );
+      int iy = static_cast<int>( std::floor( (y-fY0)*fInvDy ) );
+      if (ix < 0) ix = 0; else if (ix >= fNx) ix = fNx-1;
+      if (iy < 0) iy = 0; else if (iy >= fNy) iy = fNy-1;
+
+      const int icell = ix*fNy + iy;
+      for (int k = fCellOffset[icell]; k < fCellOffset[icell+1]; k++) {
+        const SBinShape& b = fBins[ fCellBins[k] ];
+        if (b.fIsRect) {
+          if (x > b.fXmin && x <= b.fXmax && y > b.fYmin && y <= b.fYmax) return b.fBin;
+        }
+        else if (IsInsidePolygon(b, x, y)) {
+          return b.fBin;
+        }
+      }
+      return -5;
+    }
+
+  private:
+    struct SBinShape {
+      int    fBin;
+      bool   fIsRect;
+      double fXmin;
+      double fXmax;
+      double fYmin;
+      double fYmax;
+      std::vector<double> fVx;
+      std::vector<double> fVy;
+
+      SBinShape() : fBin(0), fIsRect(false), fXmin(0), fXmax(0), fYmin(0), fYmax(0) {}
+    };
+
+    bool   fIsBuilt;
+    bool   fIsRegular;
+    double fXmin; //!< TH2Poly x-axis lower limit
+    double fXmax; //!< TH2Poly x-axis upper limit
+    double fYmin; //!< TH2Poly y-axis lower limit
+    double fYmax; //!< TH2Poly y-axis upper limit
+    double fX0; //!< grid origin (x)
+    double fY0; //!< grid origin (y)
+    double fInvDx; //!< inverse of the grid cell size (x)
+    double fInvDy; //!< inverse of the grid cell size (y)
+    int    fNx; //!< number of grid cells along x
+    int    fNy; //!< number of grid cells along y
+    std::vector<SBinShape> fBins;
+    std::vector<int> fCellOffset; //!< first candidate of each cell in fCellBins
+    std::vector<int> fCellBins; //!< candidate bins of each cell, sorted by bin number
+
+    static bool IsInsidePolygon(const SBinShape& b, const double x, const double y);
+    static bool FindLattice(std::vector<double> lo, const double max_width,
+        double& origin, double& pitch);
+};
+
+#endif /* end of include guard SLARPOLYBINLOOKUP_HH */
+
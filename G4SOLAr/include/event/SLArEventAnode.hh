@@ -28,9 +28,10 @@ class SLArEventAnode : public TNamed {
     inline bool IsActive() const {return fIsActive;}
 
     SLArEventTile& RegisterHit(const SLArEventPhotonHit& hit, int mt_idx = -999, int t_idx = -999); 
-    SLArEventChargePixel& RegisterChargeHit(const SLArCfgAnode::SLArPixIdx& pixId, const SLArEventChargeHit& hit); 
+    SLArEventChargePixel& RegisterChargeHit(const SLArCfgAnode::SLArPixIdx& pixId, const SLArEventChargeHit& hit, const UShort_t n = 1); 
     int ResetHits(); 
     int SoftResetHits();
+    int ConsolidateHits(); 
 
     void SetActive(bool is_active); 
     inline void SetChargeBacktrackerRecordSize(const UShort_t size) {fChargeBacktrackerRecordSize = size;}
@@ -39,6 +40,8 @@ class SLArEventAnode : public TNamed {
     inline UShort_t GetLightBacktrackerRecordSize() const {return fLightBacktrackerRecordSize;}
     inline void SetZeroSuppressionThreshold(const UShort_t& threshold) {fZeroSuppressionThreshold = threshold;}
     inline UShort_t GetZeroSuppressionThreshold() const {return fZeroSuppressionThreshold;}
+    inline void SetHitStoragePolicy(const EHitStoragePolicy policy) {fHitStoragePolicy = policy;}
+    inline EHitStoragePolicy GetHitStoragePolicy() const {return fHitStoragePolicy;}
 
     Int_t ApplyZeroSuppression(); 
 
@@ -54,6 +57,7 @@ class SLArEventAnode : public TNamed {
     UShort_t fLightBacktrackerRecordSize;
     UShort_t fChargeBacktrackerRecordSize;
     UShort_t fZeroSuppressionThreshold;
+    EHitStoragePolicy fHitStoragePolicy; //! storage policy of tile and pixel hits
     std::map<int, SLArEventMegatile> fMegaTilesMap;
 
   public:
@@ -105,6 +109,11 @@ class SLArListEventAnode: public TObject {
       fEvNumber = -1;
     }
 
+    inline void Swap(SLArListEventAnode& other) {
+      std::swap(fEvNumber, other.fEvNumber); 
+      fAnodeMap.swap(other.fAnodeMap); 
+    }
+
   private:
     Int_t fEvNumber = -1;
     std::map<int, SLArEventAnode> fAnodeMap;
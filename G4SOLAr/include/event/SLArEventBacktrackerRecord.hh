@@ -10,9 +10,62 @@
 
 #include <vector>
 #include <map>
+#include <utility>
 #include "TObject.h"
 
-typedef std::map<Int_t, UShort_t> BacktrackerCounter_t;
+/**
+ * @brief Small-vector counter of backtracker keys
+ *
+ * Stores the (key, count) pairs sorted by key like the std::map counter 
+ * it replaces. Most records hold one or two distinct keys: these are 
+ * kept inline, and all the entries move to a single vector of pairs 
+ * when a record collects more keys than kInlineSize. The unused inline 
+ * slots are kept to zero, so that they compress away in the output. 
+ * The counter is streamed (and split) by the dictionary-generated streamer.
+ */
+class SLArBacktrackerCounter {
+  public: 
+    typedef std::pair<Int_t, UShort_t> Entry_t; 
+    static constexpr UShort_t kInlineSize = 2; 
+
+    //! Iterator over the (key, count) pairs, returned by value
+    class const_iterator {
+      public: 
+        const_iterator(const SLArBacktrackerCounter* counter, const size_t idx) 
+          : fCounter(counter), fIdx(idx) {}
+        inline Entry_t operator*() const {return fCounter->At(fIdx);}
+        inline const_iterator& operator++() {++fIdx; return *this;}
+        inline bool operator==(const const_iterator& other) const {return fIdx == other.fIdx;}
+        inline bool operator!=(const const_iterator& other) const {return fIdx != other.fIdx;}
+      private: 
+        const SLArBacktrackerCounter* fCounter; 
+        size_t fIdx; 
+    };
+
+    SLArBacktrackerCounter() {}
+
+    inline const_iterator begin() const {return const_iterator(this, 0);}
+    inline const_iterator end() const {return const_iterator(this, size());}
+    inline size_t size() const {return IsSpilled() ? fSpill.size() : fNInline;}
+    inline bool empty() const {return size() == 0;}
+    inline bool IsSpilled() const {return !fSpill.empty();}
+    inline Entry_t At(const size_t idx) const {
+      return IsSpilled() ? fSpill[idx] : Entry_t(fKey[idx], fVal[idx]);
+    }
+    UShort_t Get(const Int_t key) const; 
+    UShort_t Add(const Int_t key, const UShort_t val); 
+    void clear(); 
+
+  private:
+    UShort_t fNInline = 0; // number of inline entries
+    UShort_t fVal[kInlineSize] = {0}; // inline counts
+    Int_t fKey[kInlineSize] = {0}; // inline keys
+    std::vector<Entry_t> fSpill; // all the entries, once spilled over from the inline slots
+
+    void ClearInline(); 
+};
+
+typedef SLArBacktrackerCounter BacktrackerCounter_t;
 
 class SLArEventBacktrackerRecord : public TObject {
   public: 
@@ -26,7 +79,7 @@ class SLArEventBacktrackerRecord : public TObject {
     BacktrackerCounter_t fCounter; 
 
   public: 
-    ClassDef(SLArEventBacktrackerRecord, 1)
+    ClassDef(SLArEventBacktrackerRecord, 2)
 };
 
 
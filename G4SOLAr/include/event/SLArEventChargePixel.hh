@@ -18,6 +18,8 @@ class SLArEventChargePixel : public SLArEventHitsCollection<SLArEventChargeHit>
     SLArEventChargePixel(const SLArEventChargePixel&); 
     ~SLArEventChargePixel() {}
 
+    static constexpr UShort_t kDefaultClockUnit = 100; //!< default clock tick [ns]
+
   private: 
 
   public: 
@@ -11,6 +11,7 @@
 #include <RtypesCore.h>
 #include <iostream>
 #include <map>
+#include <vector>
 
 #include "TNamed.h"
 #include "event/SLArEventGenericHit.hh"
@@ -19,6 +20,20 @@
 typedef std::map<Int_t, UShort_t> HitsCollection_t; 
 typedef std::map<Int_t, SLArEventBacktrackerVector> BacktrackerVectorCollection_t;
 
+//! Storage policy for the time-binned hits
+enum EHitStoragePolicy {
+  kMapStorage = 0, //!< hits are counted directly in the clock map
+  kBufferedStorage = 1 //!< hits and backtracker counts are appended to flat buffers and merged in the maps by ConsolidateHits()
+}; 
+
+//! Backtracker count buffered under the kBufferedStorage policy
+struct SLArBacktrackerBufferEntry {
+  Int_t fClock; //!< clock tick of the hit
+  UShort_t fRecord; //!< index of the record in the backtracker vector
+  Int_t fKey; //!< backtracker key
+  UShort_t fCount; //!< counts 
+};
+
 template<class T>
 class SLArEventHitsCollection : public TNamed {
   public: 
@@ -36,6 +51,9 @@ class SLArEventHitsCollection : public TNamed {
     inline int GetIdx() const {return fIdx;}
     inline int GetNhits() const {return fNhits;}
     inline virtual double GetTime() {return -1.;} 
+    inline EHitStoragePolicy GetStoragePolicy() const {return fStoragePolicy;}
+    inline size_t GetNBufferedHits() const {return fHitBuffer.size();}
+    inline size_t GetNBufferedBacktrackerCounts() const {return fBacktrackerBuffer.size();}
     inline HitsCollection_t& GetHits() {return fHits;}
     inline const HitsCollection_t& GetConstHits() const {return fHits;}
     inline BacktrackerVectorCollection_t& GetBacktrackerRecordCollection() {return fBacktrackerCollections;}
@@ -48,7 +66,9 @@ class SLArEventHitsCollection : public TNamed {
     virtual void PrintHits() const; 
 
     virtual int RegisterHit(const T hit); 
+    int RegisterHits(const T& hit, const UShort_t n); 
     virtual int ResetHits(); 
+    int ConsolidateHits(); 
 
     //virtual bool SortHits(); 
     inline void SetActive(bool is_active) {fIsActive = is_active;}
@@ -56,6 +76,7 @@ class SLArEventHitsCollection : public TNamed {
     inline void SetClockUnit(const UShort_t unit) {fClockUnit = unit;}
     inline void SetBacktrackerRecordSize(const UShort_t size) {fBacktrackerRecordSize = size;}
     inline void SetNhits(const int& n) {fNhits = n;}
+    inline void SetStoragePolicy(const EHitStoragePolicy policy) {fStoragePolicy = policy;}
 
     int ZeroSuppression(const UShort_t threshold);  
 
@@ -67,6 +88,17 @@ class SLArEventHitsCollection : public TNamed {
     HitsCollection_t fHits; 
     BacktrackerVectorCollection_t fBacktrackerCollections;
     UShort_t fClockUnit; 
+    EHitStoragePolicy fStoragePolicy; //! hit storage policy
+    std::vector<Int_t> fHitBuffer; //! clock values of the hits not yet merged in fHits
+    std::vector<SLArBacktrackerBufferEntry> fBacktrackerBuffer; //! backtracker counts not yet merged in fBacktrackerCollections
+    SLArEventBacktrackerVector fBacktrackerScratch; //! records filled by the backtrackers of the last buffered clock tick
+    Int_t fScratchClock; //! clock tick of the scratch records
+    bool fScratchPending; //! the scratch records hold counts to be buffered
+
+    void FlushBacktrackerScratch(); 
+    void AppendBacktrackerScratch(std::vector<SLArBacktrackerBufferEntry>& buffer) const; 
+    static void MergeBacktrackerBuffer(std::vector<SLArBacktrackerBufferEntry>& buffer, 
+        BacktrackerVectorCollection_t& collection, const UShort_t record_size); 
 
   public: 
     ClassDefOverride(SLArEventHitsCollection, 2);
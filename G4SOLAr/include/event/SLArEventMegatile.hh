@@ -31,8 +31,10 @@ class SLArEventMegatile : public TNamed {
     inline int GetIdx() const {return fIdx;}
 
     SLArEventTile& RegisterHit(const SLArEventPhotonHit& hit, const int idx = -999); 
+    SLArEventTile& RegisterHit(const SLArEventPhotonHit& hit, SLArEventTile& tile_ev); 
     int ResetHits(); 
     int SoftResetHits();
+    int ConsolidateHits(); 
 
     void SetActive(bool is_active); 
     void SetIdx(int idx) {fIdx = idx;}
@@ -40,6 +42,8 @@ class SLArEventMegatile : public TNamed {
     inline UShort_t GetChargeBacktrackerRecordSize() const {return fChargeBacktrackerRecordSize;}
     inline void SetLightBacktrackerRecordSize(const UShort_t size) {fLightBacktrackerRecordSize = size;}
     inline UShort_t GetLightBacktrackerRecordSize() const {return fLightBacktrackerRecordSize;}
+    inline void SetHitStoragePolicy(const EHitStoragePolicy policy) {fHitStoragePolicy = policy;}
+    inline EHitStoragePolicy GetHitStoragePolicy() const {return fHitStoragePolicy;}
     //bool SortHits(); 
 
   private:
@@ -48,6 +52,7 @@ class SLArEventMegatile : public TNamed {
     int fNhits; 
     UShort_t fLightBacktrackerRecordSize;
     UShort_t fChargeBacktrackerRecordSize;
+    EHitStoragePolicy fHitStoragePolicy; //! storage policy of tile and pixel hits
     std::map<int, SLArEventTile> fTilesMap; 
 
   public:
@@ -15,14 +15,22 @@
 #pragma link C++ class std::vector<SLArEventChargeHit>+; 
 #pragma link C++ class std::vector<SLArEventPhotonHit>+;
 #pragma link C++ class std::map<Int_t, UShort_t>+;
+#pragma link C++ class std::pair<Int_t, UShort_t>+;
+#pragma link C++ class std::vector<std::pair<Int_t, UShort_t>>+;
+#pragma link C++ class SLArBacktrackerCounter+;
 #pragma link C++ typedef BacktrackerCounter_t+;
 #pragma link C++ class SLArEventBacktrackerRecord+;
+// records written up to version 1 store the counter in a std::map
+#pragma read sourceClass="SLArEventBacktrackerRecord" targetClass="SLArEventBacktrackerRecord" \
+  version="[1]" source="std::map<Int_t, UShort_t> fCounter" target="fCounter" \
+  code="{ fCounter.clear(); for (const auto& entry : onfile.fCounter) fCounter.Add(entry.first, entry.second); }"
 #pragma link C++ class std::vector<SLArEventBacktrackerRecord>+;
 #pragma link C++ class SLArEventBacktrackerVector+;
 #pragma link C++ class std::map<UShort_t, SLArEventBacktrackerVector>+;
 #pragma link C++ typedef BacktrackerVectorCollection_t+;
 #pragma link C++ class std::map<UShort_t, UShort_t>+;
 #pragma link C++ typedef HitsCollection_t+;
+#pragma link C++ enum EHitStoragePolicy;
 #pragma link C++ class SLArEventHitsCollection<SLArEventPhotonHit>+;
 #pragma link C++ class SLArEventHitsCollection<SLArEventChargeHit>+;
 #pragma link C++ class SLArEventChargePixel+; 
@@ -28,6 +28,7 @@ class SLArEventSuperCellArray : public TNamed {
     inline UShort_t GetLightBacktrackerRecordSize() const {return fLightBacktrackerRecordSize;}
     SLArEventSuperCell& GetOrCreateEventSuperCell(const int scIdx); 
     SLArEventSuperCell& RegisterHit(const SLArEventPhotonHit& hit, int sc_idx = -999); 
+    SLArEventSuperCell& RegisterHit(const SLArEventPhotonHit& hit, SLArEventSuperCell& sc_event); 
     int ResetHits(); 
     int SoftResetHits();
 
@@ -79,6 +80,11 @@ class SLArListEventPDS: public TObject {
       }
       fEvNumber = -1;
     }
+
+    inline void Swap(SLArListEventPDS& other) {
+      std::swap(fEvNumber, other.fEvNumber); 
+      fOpDetArrayMap.swap(other.fOpDetArrayMap); 
+    }
   private: 
     Int_t fEvNumber = {};
     std::map<int, SLArEventSuperCellArray> fOpDetArrayMap;
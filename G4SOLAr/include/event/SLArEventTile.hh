@@ -33,9 +33,10 @@ class SLArEventTile :  public SLArEventHitsCollection<SLArEventPhotonHit>
     inline void SetChargeBacktrackerRecordSize(const UShort_t size) {fChargeBacktrackerRecordSize = size;}
     inline UShort_t GetChargeBacktrackerRecordSize() const {return fChargeBacktrackerRecordSize;}
     void PrintHits() const; 
-    SLArEventChargePixel& RegisterChargeHit(const int&, const SLArEventChargeHit& ); 
+    SLArEventChargePixel& RegisterChargeHit(const int&, const SLArEventChargeHit&, const UShort_t n = 1); 
     int ResetHits(); 
     int SoftResetHits();
+    int ConsolidateHits(); 
 
     //bool SortHits(); 
     //bool SortPixelHits();
@@ -10,6 +10,7 @@
 
 #include <iostream>
 #include <cassert>
+#include <deque>
 #include "TObject.h"
 #include "TString.h"
 #include "TVector3.h"
@@ -66,15 +67,18 @@ struct trj_point {
 };
 
 class SLArEventTrajectoryLite;
+class SLArEventTrajectoryArena;
 
 class SLArEventTrajectory : public TObject
 {
   public:
     SLArEventTrajectory();
     SLArEventTrajectory(const SLArEventTrajectory& trj);
-    SLArEventTrajectory(SLArEventTrajectory&& trj) = default;
+    SLArEventTrajectory(SLArEventTrajectory&& trj);
     ~SLArEventTrajectory();
 
+    void Reset(); 
+
     TString GetParticleName() const {return fParticleName;}
     TString GetCreatorProcess() const {return fCreatorProcess ;}
     TString GetEndProcess() const {return fEndProcess ;}
@@ -91,6 +95,7 @@ class SLArEventTrajectory : public TObject
     float GetTotalNph () const {return fTotalNph;} 
     float GetTotalNel () const {return fTotalNel;} 
     Bool_t DoStoreTrajectoryPts() const {return fStoreTrajectoryPts;}
+    Bool_t IsPooled() const {return fPooled;}
 
     inline void SetStoreTrajectoryPts(const bool store_pts) {fStoreTrajectoryPts = store_pts;}
     inline void SetParticleName(const TString& name) {fParticleName = name;}
@@ -116,6 +121,7 @@ class SLArEventTrajectory : public TObject
     void    RegisterPoint(const trj_point& point); 
 
     friend class SLArEventTrajectoryLite;
+    friend class SLArEventTrajectoryArena;
 
   private:
     Bool_t                 fStoreTrajectoryPts;
@@ -135,11 +141,46 @@ class SLArEventTrajectory : public TObject
     float                  fTotalEdep        ; 
     float                  fTotalNph         ; 
     float                  fTotalNel         ; 
+    Bool_t                 fPooled           ; //! owned by a SLArEventTrajectoryArena
 
   public:
     ClassDef(SLArEventTrajectory, 5);
 };
 
+/**
+ * @brief Pool of SLArEventTrajectory objects reused across events
+ *
+ * Trajectories are handed out in order and stay owned by the arena: 
+ * Reset() only rewinds the slot counter, so that clearing an event does
+ * not run the destructor of each trajectory. The slots (and the capacity
+ * of their point buffers) are kept for the next event and are cleaned 
+ * when they are handed out again. 
+ *
+ * The arena is not thread-safe: it is meant to be owned by the event
+ * object (see SLArMCTruth) and to be moved together with it.
+ */
+class SLArEventTrajectoryArena {
+  public: 
+    SLArEventTrajectoryArena() : fNext(0) {}
+    SLArEventTrajectoryArena(const SLArEventTrajectoryArena&) : fNext(0) {}
+    SLArEventTrajectoryArena& operator=(const SLArEventTrajectoryArena&) {Reset(); return *this;}
+    ~SLArEventTrajectoryArena() {}
+
+    SLArEventTrajectory* Acquire(); 
+    void Reserve(const size_t n); 
+    inline void Reset() {fNext = 0;}
+    inline void Swap(SLArEventTrajectoryArena& other) {
+      fSlots.swap(other.fSlots); 
+      std::swap(fNext, other.fNext); 
+    }
+    inline size_t GetSize() const {return fNext;}
+    inline size_t GetCapacity() const {return fSlots.size();}
+
+  private: 
+    std::deque<SLArEventTrajectory> fSlots; 
+    size_t fNext; 
+};
+
 class SLArEventTrajectoryLite : public TObject {
   public: 
     struct Coordinates_t {
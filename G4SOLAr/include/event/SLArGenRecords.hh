@@ -66,6 +66,11 @@ class SLArGenRecordsVector : public TObject {
       fStatusVector.clear();
     }
 
+    inline void Swap(SLArGenRecordsVector& other) {
+      std::swap(fEvNumber, other.fEvNumber); 
+      fStatusVector.swap(other.fStatusVector); 
+    }
+
   private: 
     Int_t fEvNumber; 
     std::vector<SLArGenRecord> fStatusVector; 
@@ -65,6 +65,7 @@ class SLArMCPrimaryInfo : public TNamed
     
     int RegisterTrajectory(SLArEventTrajectory&& trj);
     int RegisterTrajectory(const SLArEventTrajectory& trj);
+    int RegisterTrajectory(SLArEventTrajectory* trj);
 
   private:
     Int_t fPDG; 
@@ -83,7 +84,8 @@ class SLArMCPrimaryInfo : public TNamed
     inline void ClearTrajectories() 
     {
       for (auto &trj : fTrajectories) {
-        delete trj;
+        // trajectories from a SLArEventTrajectoryArena are owned by the arena
+        if (!trj->IsPooled()) delete trj;
       }
       fTrajectories.clear();
     }
@@ -8,6 +8,7 @@
 
 #define SLARMCTRUTH_HH
 
+#include <algorithm>
 #include "event/SLArMCPrimaryInfo.hh"
 
 class SLArMCTruth : public TObject {
@@ -28,7 +29,21 @@ class SLArMCTruth : public TObject {
     
     inline std::vector<SLArMCPrimaryInfo>& GetPrimaries() {return fPrimaries;}
     
-    inline void Reset() {fPrimaries.clear(); fEvNumber = -1;}
+    inline void Reset() {fPrimaries.clear(); fTrjArena.Reset(); fEvNumber = -1;}
+
+    inline void Swap(SLArMCTruth& other) {
+      // the arena handed back to the event loop is sized on the number of 
+      // trajectories of the event being swapped out
+      const size_t n_trj = std::max(fTrjArena.GetSize(), other.fTrjArena.GetSize()); 
+      std::swap(fEvNumber, other.fEvNumber); 
+      fPrimaries.swap(other.fPrimaries); 
+      fTrjArena.Swap(other.fTrjArena); 
+      fTrjArena.Reserve(n_trj); 
+      other.fTrjArena.Reserve(n_trj); 
+    }
+
+    //! Get a trajectory from the event arena (released by Reset)
+    inline SLArEventTrajectory* NewTrajectory() {return fTrjArena.Acquire();}
     
     inline size_t RegisterPrimary(SLArMCPrimaryInfo& p) {
       fPrimaries.push_back( std::move(p) );
@@ -62,6 +77,7 @@ class SLArMCTruth : public TObject {
   private: 
     Int_t fEvNumber; 
     std::vector<SLArMCPrimaryInfo> fPrimaries;
+    SLArEventTrajectoryArena fTrjArena; //!
 
   public:
     ClassDef(SLArMCTruth, 1);
@@ -0,0 +1,67 @@
+/**
+ * @author      : Daniele Guffanti (daniele.guffanti@mib.infn.it)
+ * @file        : SLArAliasSampler.hh
+ * @created     : Saturday Oct 17, 2026 21:12:40 CEST
+ */
+
+#ifndef SLARALIASSAMPLER_HH
+
+#define SLARALIASSAMPLER_HH
+
+#include <vector>
+#include <cstdint>
+
+#include "TH1.h"
+#include "TRandom.h"
+
+/**
+ * @class SLArAliasSampler
+ * @brief Walker alias-table sampler of 1D and 2D histograms
+ *
+ * The tables are built once from the bin contents, then each sample costs
+ * a constant number of uniform draws, independently of the number of bins.
+ * Within the selected bin the value is either uniform (as TH1::GetRandom)
+ * or follows a linear density interpolated from the neighbouring bins.
+ * The sampler only depends on ROOT, the random engine is given by the
+ * caller.
+ */
+class SLArAliasSampler {
+  public:
+    enum EInterpolation {kUniform = 0, kLinear = 1};
+
+    SLArAliasSampler();
+    SLArAliasSampler(const TH1& h, const EInterpolation interp = kLinear);
+    ~SLArAliasSampler() {}
+
+    bool Build(const TH1& h, const EInterpolation interp = kLinear);
+    double Sample(TRandom* engine) const;
+    void Sample(TRandom* engine, double& x, double& y) const;
+    bool IsBuiltFrom(const TH1& h) const;
+
+    inline int GetDimension() const {return fDimension;}
+    inline size_t GetNCells() const {return fProb.size();}
+    inline EInterpolation GetInterpolation() const {return fInterpolation;}
+    inline bool IsEmpty() const {return fProb.empty();}
+
+  private:
+    int fDimension;
+    EInterpolation fInterpolation;
+    int fNBinsX;
+    std::vector<double> fEdgesX;
+    std::vector<double> fEdgesY;
+    std::vector<double> fProb; //!< acceptance probability of each table entry
+    std::vector<uint32_t> fAlias; //!< alias of each table entry
+    std::vector<uint32_t> fCell; //!< (ix + nx*iy) index of each table entry
+    std::vector<float> fSlopeX; //!< in-bin linear slope along x of each table entry
+    std::vector<float> fSlopeY; //!< in-bin linear slope along y of each table entry
+
+    // bookkeeping to detect a change of the source histogram
+    int fSourceNCells;
+    double fSourceEntries;
+
+    size_t SampleCell(TRandom* engine) const;
+    static double SampleInBin(const double u, const double slope);
+};
+
+#endif /* end of include guard SLARALIASSAMPLER_HH */
+
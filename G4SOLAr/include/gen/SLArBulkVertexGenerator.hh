@@ -10,12 +10,15 @@
 
 // Standard library
 #include <random>
+#include <memory>
 
 #include "gen/SLArVertexGenerator.hh"
+#include "gen/SLArVoxelAcceptanceMap.hh"
 
 #include "G4LogicalVolume.hh"
 #include "G4Box.hh"
 #include "G4ThreeVector.hh"
+#include "G4Point3D.hh"
 #include "G4RotationMatrix.hh"
 
 namespace gen {
@@ -39,6 +42,14 @@ namespace vertex {
  * - `material`: the material of the volume. If set, the generator will only generate vertexes
  *   where the material matches the specified one.
  * - `time`: the time generator configuration. This is passed to the `SLArTimeGenerator` class.
+ * - `sampler`: `rejection` (default) samples the vertexes in the bounding box and 
+ *   rejects the ones outside the volume; `voxel` samples them from a voxel occupancy 
+ *   map of the volume (see SLArVoxelAcceptanceMap), checking only the points falling in 
+ *   voxels crossed by the volume surface or by a daughter. Recommended for thin or 
+ *   irregular volumes with a small bounding-box acceptance.
+ * - `voxel_size`: the voxel size of the `voxel` sampler (`val` and `unit`, default 5 cm)
+ * - `voxel_map_cache`: directory where the voxel maps are cached, tagged with 
+ *   a hash of the geometry (not cached if missing)
  *
  */
 class SLArBulkVertexGenerator: public SLArVertexGenerator
@@ -121,16 +132,23 @@ private:
   G4bool fRequireMaterialMatch = false;
   G4String fMaterial = {};
   G4double fMass; //!< Parameter that sets up the volume mass
+  G4bool fUseVoxelMap = false; //!< Sample the vertexes from the voxel occupancy map
+  G4double fVoxelSize{5.0 * CLHEP::cm}; //!< Voxel size of the occupancy map
+  G4String fVoxelMapCacheDir = {}; //!< Cache directory of the occupancy map
   
   // Working internals:
   G4VSolid * fSolid = nullptr; ///< Reference to the solid volume from which are generated vertexes
   G4RotationMatrix fBulkInverseRotation; ///< The inverse box rotation
   unsigned int fCounter = 0.0; // Internal vertex counter
+  std::shared_ptr<SLArVoxelAcceptanceMap> fVoxelMap; ///< Voxel occupancy map (built on first use)
 
   inline G4double GetMassVolumeGenerator() const {return fLogVol->GetMass();}
 
   double ComputeDeltaX(const G4ThreeVector& lo, const G4ThreeVector& hi) const;
   double ComputeDeltaX(const G4ThreeVector& lo, const G4ThreeVector& hi, const G4double fv) const;
+
+  void BuildVoxelMap(const G4ThreeVector& lo, const G4ThreeVector& hi);
+  G4bool IsValidVertex(const G4Point3D& localVertex) const;
      
 };
 }
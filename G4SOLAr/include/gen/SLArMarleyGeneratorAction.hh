@@ -19,6 +19,9 @@
 // Standard library includes
 #include <string>
 #include <map>
+#include <list>
+#include <vector>
+#include <memory>
 
 // Geant4 includes
 #include <G4VUserPrimaryGeneratorAction.hh>
@@ -26,16 +29,46 @@
 
 // MARLEY includes
 #include <marley/Generator.hh>
+#include <marley/NeutrinoSource.hh>
 
 // ROOT includes
 #include <TH2F.h>
 #include <TH1F.h>
+#include <TH1D.h>
 
 class G4Event;
 
 namespace gen {
 namespace marley {
 
+/**
+ * @brief Neutrino source forwarding to the spectrum of the current nadir bin
+ *
+ * The source is handed to the MARLEY generator once. While the generator 
+ * normalizes the energy pdf (in set_source) the source returns the envelope 
+ * of the spectra of all the nadir bins, so that the rejection sampling 
+ * bound holds for any bin. The spectrum of the bin sampled for the event 
+ * is then selected with SetActiveSource, without rebuilding the generator 
+ * state.
+ */
+class SLArOscillogramNeutrinoSource : public ::marley::NeutrinoSource
+{
+  public:
+    SLArOscillogramNeutrinoSource(int pid, 
+        const std::vector<double>& edges, const std::vector<double>& envelope); 
+    ~SLArOscillogramNeutrinoSource() {}
+
+    double pdf(double E) const override; 
+    inline double get_Emin() const override {return fEdges.front();}
+    inline double get_Emax() const override {return fEdges.back();}
+    inline void SetActiveSource(const ::marley::NeutrinoSource* source) {fActiveSource = source;}
+
+  private: 
+    std::vector<double> fEdges;
+    std::vector<double> fEnvelope;
+    const ::marley::NeutrinoSource* fActiveSource;
+};
+
 class SLArMarleyGeneratorAction : public SLArBaseGenerator
 {
   public:
@@ -49,9 +82,18 @@ class SLArMarleyGeneratorAction : public SLArBaseGenerator
       std::vector<G4String> reactions; 
       TargetConfig_t target; 
       ExtSourceInfo_t oscillogram_info;
+      G4int oscillogram_cache_size = 0; //!< max nadir bins cached (0: all)
+      G4bool oscillogram_prebuild = false; 
       G4bool weight_flux = true;
     };
 
+    struct NadirBinSource_t {
+      std::unique_ptr<TH1D> spectrum;
+      std::unique_ptr<::marley::NeutrinoSource> source;
+      std::list<int>::iterator lru_itr;
+      bool checked = false; //!< energy pdf checked against the rejection bound
+    };
+
     SLArMarleyGeneratorAction(G4String label = "");
     ~SLArMarleyGeneratorAction() {};
 
@@ -74,7 +116,16 @@ class SLArMarleyGeneratorAction : public SLArBaseGenerator
     ::marley::Generator fMarleyGenerator;
     std::map<double, double> fHalfLifeTable;
     std::unique_ptr<TH2F> fOscillogram;
+    std::vector<NadirBinSource_t> fNadirCache;
+    std::list<int> fNadirCacheLRU; //!< cached nadir bins, most recent first
+    SLArOscillogramNeutrinoSource* fOscillogramSource; //!< owned by fMarleyGenerator
+    double fEPdfBound; //!< maximum of the envelope energy pdf (without the safety margin)
     double SampleDecayTime(const double half_life) const;
+    void SetupOscillogramSource();
+    NadirBinSource_t& BuildNadirBinSource(const int ibin_nadir); 
+    const ::marley::NeutrinoSource* GetNadirBinSource(const int ibin_nadir); 
+    double ScanEPdfMax(); 
+    void CheckNadirBinSource(const int ibin_nadir); 
 };
 }
 }
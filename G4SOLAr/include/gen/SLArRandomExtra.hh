@@ -9,12 +9,16 @@
 #define SLARRANDOMEXTRA_HH
 
 #include <memory>
+#include <unordered_map>
 
 #include "G4ThreeVector.hh"
 #include "G4RandomTools.hh"
 
 #include "TRandom3.h"
 #include "TH1.h"
+#include "TH2.h"
+
+#include "SLArAliasSampler.hh"
 
 class SLArRandom {
   public:
@@ -24,14 +28,19 @@ class SLArRandom {
     inline ~SLArRandom() {}; 
 
     std::unique_ptr<TRandom3>& GetEngine() {return fRandomEngine;}
-    inline G4double SampleFromHist(const TH1& h) {return h.GetRandom(fRandomEngine.get());}
-    inline G4double SampleFromHist(const TH1* h) {return h->GetRandom(fRandomEngine.get());}
+    G4double SampleFromHist(const TH1& h);
+    inline G4double SampleFromHist(const TH1* h) {return SampleFromHist(*h);}
+    void SampleFromHist(const TH2& h, G4double& x, G4double& y);
+    inline void SampleFromHist(const TH2* h, G4double& x, G4double& y) {SampleFromHist(*h, x, y);}
+    const SLArAliasSampler& GetHistSampler(const TH1& h);
+    inline void ClearHistSamplers() {fHistSamplers.clear();}
     static G4ThreeVector SampleRandomDirection();
     static G4ThreeVector SampleLinearPolarization(const G4ThreeVector& momentum); 
     static std::array<G4ThreeVector,2> SampleRandomDirectionAndPolarization();
 
   protected: 
     std::unique_ptr<TRandom3> fRandomEngine; 
+    std::unordered_map<const TH1*, std::unique_ptr<SLArAliasSampler>> fHistSamplers; 
 };
 
 #endif /* end of include guard SLARRANDOMEXTRA_HH */
@@ -0,0 +1,76 @@
+/**
+ * @author      : Daniele Guffanti (daniele.guffanti@mib.infn.it)
+ * @file        : SLArVoxelAcceptanceMap.hh
+ * @created     : Saturday Oct 17, 2026 20:41:36 CEST
+ */
+
+#ifndef SLARVOXELACCEPTANCEMAP_HH
+
+#define SLARVOXELACCEPTANCEMAP_HH
+
+#include <vector>
+#include <cstdint>
+
+#include "G4ThreeVector.hh"
+#include "G4LogicalVolume.hh"
+
+namespace gen {
+namespace vertex {
+
+/**
+ * @class SLArVoxelAcceptanceMap
+ * @brief Voxel occupancy map of a logical volume for vertex sampling
+ *
+ * The bounding box of the volume (in the solid frame) is divided in
+ * voxels of (about) the requested size, and each voxel is classified as
+ * - fully accepted: all its points are valid vertexes
+ * - partially accepted: only some points are valid, so the sampled
+ *   point must be checked
+ * - empty: no valid vertex, not stored
+ *
+ * The classification is conservative: a voxel is fully accepted only if
+ * its distance from the solid surface (G4VSolid safety) is larger than its
+ * half diagonal and, when daughters or materials matter, it does not
+ * overlap the bounding box of any daughter volume.
+ *
+ * The map can be saved to and loaded from a cache file, tagged with a hash
+ * of the geometry and of the map parameters.
+ */
+class SLArVoxelAcceptanceMap {
+  public:
+    SLArVoxelAcceptanceMap();
+    ~SLArVoxelAcceptanceMap() {}
+
+    void Build(const G4LogicalVolume* lv,
+        const G4ThreeVector& lo, const G4ThreeVector& hi, const G4double voxel_size,
+        const G4bool check_daughters, const G4String& material = "");
+
+    G4bool SamplePoint(G4ThreeVector& point, G4bool& is_partial) const;
+
+    G4bool Save(const G4String& file_path) const;
+    G4bool Load(const G4String& file_path, const size_t geometry_hash);
+
+    static size_t ComputeGeometryHash(const G4LogicalVolume* lv,
+        const G4ThreeVector& lo, const G4ThreeVector& hi, const G4double voxel_size,
+        const G4bool check_daughters, const G4String& material = "");
+
+    inline size_t GetNVoxels() const {return fVoxels.size();}
+    inline size_t GetNPartialVoxels() const {return fNPartial;}
+    inline size_t GetGeometryHash() const {return fGeometryHash;}
+    inline G4bool IsEmpty() const {return fVoxels.empty();}
+
+  private:
+    size_t fGeometryHash;
+    G4ThreeVector fLo;
+    G4ThreeVector fWidth;
+    G4int fNBins[3];
+    std::vector<uint32_t> fVoxels; //!< index of the non-empty voxels
+    std::vector<uint8_t> fPartial; //!< partially accepted flag of the non-empty voxels
+    size_t fNPartial;
+};
+
+}
+}
+
+#endif /* end of include guard SLARVOXELACCEPTANCEMAP_HH */
+
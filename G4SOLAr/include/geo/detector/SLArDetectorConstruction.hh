@@ -24,6 +24,8 @@
 
 #include "globals.hh"
 #include "G4VUserDetectorConstruction.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VSensitiveDetector.hh"
 #include "G4MaterialPropertyVector.hh"
 #include "G4MaterialPropertiesTable.hh"
 #include "G4VisAttributes.hh"
@@ -48,6 +50,15 @@ class SLArDetectorConstruction : public G4VUserDetectorConstruction
   friend class SLArAnalysisManagerMsgr;
 
   public:
+    //! Photon detectors triggered by the stepping action on Detection
+    enum EPhotonSD {kNoPhotonSD = 0, kReadoutTilePhotonSD = 1, kSuperCellPhotonSD = 2};
+
+    //! Entry of the photon-detector dispatch table
+    struct SLArPhotonSD {
+      EPhotonSD fType = kNoPhotonSD;
+      G4VSensitiveDetector* fSD = nullptr;
+    };
+
     //! Constructor
     SLArDetectorConstruction(G4String, G4String);
     //! Destructor
@@ -66,8 +77,20 @@ class SLArDetectorConstruction : public G4VUserDetectorConstruction
     void ConstructCryostat(); 
     //! Construct Sensitive Detectors and cryostat scorers
     virtual void ConstructSDandField();
+    //! Return the photon detector (of the calling thread) attached to the logical volume
+    static inline const SLArPhotonSD& GetPhotonSD(const G4LogicalVolume* lv) {
+      static const SLArPhotonSD no_sd; 
+      const size_t id = lv->GetInstanceID(); 
+      return (fPhotonSDTable && id < fPhotonSDTable->size()) ? (*fPhotonSDTable)[id] : no_sd; 
+    }
     //! Construct virtual pixelization of the anode readout system
     void ConstructAnodeMap(); 
+    //! Enable/disable the constant-time pixel lookup of the anode maps
+    void SetUsePixelLookup(const G4bool use_lookup); 
+    //! Set the number of random points used to validate the pixel lookup
+    void SetPixelLookupValidation(const G4int n_points); 
+    //! Cross-check the pixel lookup against the TH2Poly maps on random points
+    G4int ValidatePixelLookup(const G4int n_points) const; 
     G4VIStore* CreateImportanceStore();
     //! Return SLArDetectorConstruction::fTPCs map
     inline std::map<G4int, SLArDetTPC*>& GetDetTPCs() {return fTPC;}
@@ -114,6 +137,11 @@ class SLArDetectorConstruction : public G4VUserDetectorConstruction
     void                            AddExternalScorer(const G4String phys_volume_name, const G4String alias);
 
   private:
+    //! Photon-detector dispatch table indexed by the logical volume instance ID
+    static G4ThreadLocal std::vector<SLArPhotonSD>* fPhotonSDTable; 
+    //! Register a photon detector in the dispatch table of the calling thread
+    void RegisterPhotonSD(const G4LogicalVolume* lv, G4VSensitiveDetector* sd, const EPhotonSD type); 
+
     //! Messenger class for detector construction commands
     SLArDetectorConstructionMsgr* fDetectorMsgr;
 
@@ -121,6 +149,8 @@ class SLArDetectorConstruction : public G4VUserDetectorConstruction
     void Init();
     G4String fGeometryCfgFile; //!< Geometry configuration file
     G4String fMaterialDBFile;  //!< Material table file
+    G4bool fUsePixelLookup; //!< Use constant-time lookup for the anode pixel maps
+    G4int fPixelLookupValidationPoints; //!< Number of points for pixel lookup validation
     SLArLArProperties fLArProperties; //!< Liquid Argon Properties
     //! vector of visualization attributes
     std::vector<G4VisAttributes*>   fVisAttributes; 
@@ -11,6 +11,8 @@
 #include "G4UImessenger.hh"
 
 class G4UIcmdWithAString;
+class G4UIcmdWithABool;
+class G4UIcmdWithAnInteger;
 class SLArDetectorConstruction;
 
 class SLArDetectorConstructionMsgr : public G4UImessenger {
@@ -23,6 +25,8 @@ class SLArDetectorConstructionMsgr : public G4UImessenger {
   private:
     SLArDetectorConstruction* fDetector; 
     G4UIcmdWithAString* fCmdCheckOverlaps; 
+    G4UIcmdWithABool* fCmdUsePixelLookup; 
+    G4UIcmdWithAnInteger* fCmdValidatePixelLookup; 
 };
 
 #endif /* end of include guard SLARDETECTORCONSTRUCTIONMSGR_HH */
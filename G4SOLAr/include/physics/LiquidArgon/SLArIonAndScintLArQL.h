@@ -57,6 +57,45 @@ class SLArIonAndScintLArQL : public SLArIonAndScintModel {
     double FlatLightYieldPerMeV = 24000.;
 
 
+    //! Evaluation of the LArQL charge yield
+    enum ELArQLMode {
+      kAnalytic = 0,  //!< evaluate the parametrization at each step
+      kTabulated = 1  //!< bilinear interpolation of a precomputed table
+    };
+
+    /**
+     * @brief Lookup table of the LArQL escape term in (dE/dx, E-field)
+     *
+     * The escape term Corr*QChi*Qinf is split into the smooth numerator 
+     * Corr*chi0*Qinf, tabulated on a regular (dE/dx, field) grid, and the 
+     * denominator of QChi, which only depends on dE/dx and is tabulated 
+     * separately so that the table follows its zero crossing.
+     */
+    struct SLArLArQLTable {
+      double fDEdxMin = 0.;
+      double fDEdxMax = 0.;
+      double fFieldMin = 0.;
+      double fFieldMax = 0.;
+      double fInvStepDEdx = 0.;
+      double fInvStepField = 0.;
+      int    fNDEdx = 0;
+      int    fNField = 0;
+      double fAccuracy = 0.; //!< max relative deviation at the cell centers
+      double fPoleMin = 0.;  //!< dE/dx band around the QChi pole (evaluated analytically)
+      double fPoleMax = 0.;
+      std::vector<double> fNum; //!< [field][dE/dx] numerator of the escape term
+      std::vector<double> fDen; //!< [dE/dx] denominator of QChi
+
+      inline bool IsBuilt() const {return fNDEdx > 1 && fNField > 1;}
+      inline bool Covers(const double& dEdx, const double& E) const {
+        return dEdx <= fDEdxMax && E >= fFieldMin && E <= fFieldMax;
+      }
+      inline bool NearPole(const double& dEdx) const {
+        return dEdx > fPoleMin && dEdx < fPoleMax;
+      }
+      double Eval(const double& dEdx, const double& E) const;
+    };
+
   public:
     SLArIonAndScintLArQL(); // Constructor
     SLArIonAndScintLArQL(const G4MaterialPropertiesTable* mpt); 
@@ -67,8 +106,28 @@ class SLArIonAndScintLArQL : public SLArIonAndScintModel {
     Ion_and_Scint_t ComputeIonAndScintYield(double& dEdx, const double& electricField) const override;
     double ComputeIonYield(const double& energy_dep, const double& hit_distance, const double& electric_field) const;
     double ComputeIonYield(double& dEdx, const double& electric_field) const;
+    double ComputeIonYieldAnalytic(double& dEdx, const double& electric_field) const;
     double Flat() const;
 
+    inline void SetMode(const ELArQLMode mode) {fMode = mode;}
+    inline ELArQLMode GetMode() const {return fMode;}
+    void SetTableAccuracy(const double& accuracy);
+    inline double GetTableAccuracy() const {return fTableAccuracy;}
+    void SetTableDEdxMax(const double& dEdx_max);
+    inline void SetTableFieldSpan(const double& span) {fTableFieldSpan = span; fTable = SLArLArQLTable();}
+    bool BuildTable(const double& electric_field) const;
+    inline const SLArLArQLTable& GetTable() const {return fTable;}
+
+  private:
+    double EscapeNumerator(const double& dEdx, const double& E) const; 
+    double EscapeDenominator(const double& dEdx) const; 
+
+    ELArQLMode fMode = kTabulated;
+    double fTableAccuracy = 1e-4;  //!< target relative accuracy of the charge yield
+    double fTableDEdxMax = 40.;    //!< [MeV/cm] upper edge of the table
+    double fTableFieldSpan = 0.1;  //!< relative field range around the field used to build the table
+    mutable SLArLArQLTable fTable; //!< built at the first use (the model is owned by a single thread)
+
 };
 
 #endif /* end of include guard SLARIONANDSCINT_H */
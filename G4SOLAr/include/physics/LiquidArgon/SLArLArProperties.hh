@@ -12,6 +12,12 @@
 #include <G4ThreeVector.hh>
 #include <G4SystemOfUnits.hh>
 
+//! Simulation of the ionization charge collected on the anode
+enum EChargeDriftMode {
+  kDriftElectrons = 0, //!< diffusion of each ionization electron
+  kDriftParametric = 1 //!< Gaussian cloud integrated over the pixels
+}; 
+
 class SLArLArProperties {
   public: 
     SLArLArProperties();
@@ -24,6 +30,8 @@ class SLArLArProperties {
     inline double GetStepLengthThreshold() const {return fStepThreshold;}
     inline double GetSegmentLength() const {return fLSegment;}
     inline unsigned int GetNSegmentsLimit() const {return fNSegmentsLimit;}
+    inline EChargeDriftMode GetChargeDriftMode() const {return fChargeDriftMode;}
+    inline void SetChargeDriftMode(const EChargeDriftMode mode) {fChargeDriftMode = mode;}
 
     inline void SetElectricField(double _E)
     {
@@ -93,6 +101,7 @@ class SLArLArProperties {
     double fStepThreshold;       //!< Step length threshold for distributing ionization along the step
     double fLSegment;            //!< Length of segments for distributing ionization along the step
     unsigned int fNSegmentsLimit;//!< Maximum number of segments for distributing ionization along the step, to avoid excessive segmentation for long steps
+    EChargeDriftMode fChargeDriftMode; //!< Charge drift simulation mode
 
     double ComputeMobility(double E, double larT);
     double ComputeMobility(std::array<double, 2> par); 
@@ -11,11 +11,14 @@
 #include <math.h>
 #include <vector>
 #include "physics/LiquidArgon/SLArLArProperties.hh"
+#include "config/SLArCfgAnode.hh"
 #include "G4ThreeVector.hh"
 #include "G4SystemOfUnits.hh"
 
-class SLArCfgAnode;
 class SLArEventAnode;
+namespace backtracker {
+  class SLArBacktrackerManager;
+}
 
 class SLArElectronDrift {
   public:
@@ -30,7 +33,69 @@ class SLArElectronDrift {
         SLArCfgAnode* anodeCfg, SLArEventAnode* anodeEv);
 
   private: 
+    //! Half-width of the parametric integration window (in units of σ)
+    static constexpr double kNSigma = 4.0; 
+    //! Largest number of pixels probed by the parametric response
+    static constexpr int kMaxParametricPixels = 1024; 
+
+    //! Fraction of the electron cloud collected by a pixel
+    struct SLArPixWeight {
+      SLArCfgAnode::SLArPixIdx fIdx; 
+      double fWeight; 
+    };
+
+    G4bool DriftSegmentParametric(const double& n_mean, 
+        const double& posX, const double& posY, const double& diffLengthT, 
+        const double& hitTime, const double& diffTime, 
+        const int& trkId, const int& ancestorId, 
+        SLArCfgAnode* anodeCfg, SLArEventAnode* anodeEv); 
+    void RegisterHits(const SLArCfgAnode::SLArPixIdx& pixID, 
+        const double& time, const UShort_t n_hits, 
+        const int& trkId, const int& ancestorId, SLArEventAnode* anodeEv, 
+        backtracker::SLArBacktrackerManager* bkt_mngr); 
+    static double GaussianFraction(const double& lo, const double& hi, 
+        const double& mu, const double& sigma); 
+
+    //! Key used to aggregate the electrons reaching the same pixel in the same clock tick
+    struct SLArDriftKey {
+      int fMegaTile; 
+      int fTile; 
+      int fPixel; 
+      int fClock; 
+      unsigned int fIndex; //!< index of the first electron in the batch buffers
+
+      inline bool operator<(const SLArDriftKey& other) const {
+        if (fMegaTile != other.fMegaTile) return fMegaTile < other.fMegaTile;
+        if (fTile != other.fTile) return fTile < other.fTile;
+        if (fPixel != other.fPixel) return fPixel < other.fPixel;
+        return fClock < other.fClock;
+      }
+      inline bool SameBin(const SLArDriftKey& other) const {
+        return fMegaTile == other.fMegaTile && fTile == other.fTile && 
+          fPixel == other.fPixel && fClock == other.fClock;
+      }
+    };
+
+    //! Structure-of-arrays buffers holding all the electrons of a step
+    struct SLArDriftBatch {
+      size_t fSize = 0; 
+      std::vector<double> fX; 
+      std::vector<double> fY; 
+      std::vector<double> fT; 
+      std::vector<int>    fMegaTile; 
+      std::vector<int>    fTile; 
+      std::vector<int>    fPixel; 
+      std::vector<int>    fClock; 
+      std::vector<SLArDriftKey> fKeys; 
+
+      inline void Clear() {fSize = 0; fKeys.clear();}
+      size_t Grow(const size_t n); 
+    };
+
     const SLArLArProperties& fLArProperties;
+    SLArDriftBatch fBatch; //!< reused across steps (one SLArElectronDrift per worker thread)
+    std::vector<SLArPixWeight> fPixWeights; //!< pixels touched by the parametric response
+    std::vector<double> fClockWeights; //!< clock ticks touched by the parametric response
 };
 
 
@@ -0,0 +1,63 @@
+/**
+ * @author      : Daniele Guffanti (daniele.guffanti@mib.infn.it)
+ * @file        : SLArOpticalLibrary.hh
+ * @created     : Saturday Oct 17, 2026 19:02:18 CEST
+ */
+
+#ifndef SLAROPTICALLIBRARY_HH
+
+#define SLAROPTICALLIBRARY_HH
+
+#include <vector>
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+/**
+ * @brief Voxelized photon visibility library of the SuperCell readout
+ *
+ * For each voxel of a regular grid in the detector (LAr) frame the library
+ * lists the optical channels seeing the voxel with
+ * - the visibility (detected photons / emitted photons)
+ * - the earliest arrival time t0 and the mean delay tau of the photons
+ *   after t0, used to sample the propagation time as t0 + Exp(tau)
+ *
+ * The library is read from a ROOT file containing
+ * - `VoxelGrid`: a TH3 whose (uniform) axes define the voxel grid
+ * - `OpticalLibrary`: a TTree with one entry per (voxel, channel) and
+ *   branches voxel/I, array/I, cell/I, vis/F, t0/F, tau/F, where
+ *   voxel = ix + nx*(iy + ny*iz) (0-based bin indices) and (array, cell)
+ *   are the keys of the SLArListEventPDS array and SuperCell maps.
+ *
+ * See SOLArAnalysis/source/script/build_optical_library.C
+ */
+class SLArOpticalLibrary {
+  public:
+    struct SLArOpticalLibraryEntry {
+      G4int   fArray;
+      G4int   fCell;
+      G4float fVisibility;
+      G4float fT0;
+      G4float fTau;
+    };
+
+    SLArOpticalLibrary();
+    ~SLArOpticalLibrary() {}
+
+    G4bool Load(const G4String& file_path);
+    const SLArOpticalLibraryEntry* GetEntries(const G4ThreeVector& pos, size_t& n) const;
+    inline const G4String& GetFilePath() const {return fFilePath;}
+    inline size_t GetNVoxels() const {return fNBins[0]*fNBins[1]*fNBins[2];}
+    inline size_t GetNEntries() const {return fEntries.size();}
+    inline G4bool IsLoaded() const {return !fVoxelOffset.empty();}
+
+  private:
+    G4String fFilePath;
+    G4int    fNBins[3];
+    G4double fMin[3];
+    G4double fInvWidth[3];
+    std::vector<size_t> fVoxelOffset;
+    std::vector<SLArOpticalLibraryEntry> fEntries;
+};
+
+#endif /* end of include guard SLAROPTICALLIBRARY_HH */
+
@@ -43,6 +43,7 @@ class SLArPhysicsListMessenger;
 
 class SLArStepMax;
 class SLArOpticalPhysics;
+class SLArOpticalLibrary;
 
 class SLArPhysicsList: public G4VModularPhysicsList
 {
@@ -56,6 +57,12 @@ class SLArPhysicsList: public G4VModularPhysicsList
     inline void SetTraceOptPhotons(bool do_trace) {fDoTraceOptPhotons = do_trace;}
     inline void SetDriftElectrons(bool do_drift) {fDoDriftElectrons = do_drift;}
 
+    //! Load the photon visibility library used by the fast optical simulation
+    G4bool LoadOpticalLibrary(const G4String& file_path);
+    //! Switch between optical photon tracking and the visibility library
+    G4bool SetOpticalLibraryMode(G4bool use_library);
+    inline const SLArOpticalLibrary* GetOpticalLibrary() const {return fOpticalLibrary;}
+
     void SetCuts();
     void SetCutForGamma(G4double);
     void SetCutForElectron(G4double);
@@ -92,6 +99,7 @@ class SLArPhysicsList: public G4VModularPhysicsList
     SLArStepMax* fStepMaxProcess;
 
     SLArOpticalPhysics* fOpticalPhysics;
+    SLArOpticalLibrary* fOpticalLibrary;
 
     SLArPhysicsListMessenger* fMessenger;
 
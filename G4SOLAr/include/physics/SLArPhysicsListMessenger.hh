@@ -76,6 +76,9 @@ class SLArPhysicsListMessenger : public G4UImessenger
     G4UIcmdWithADoubleAndUnit*  fCmdSetLArStepLenThreshold;
     G4UIcmdWithADoubleAndUnit*  fCmdSetLArSegmentLen;
     G4UIcmdWithAnInteger*       fCmdSetLArNSegmentsLimit;
+    G4UIcmdWithAString*         fCmdSetChargeDriftMode;
+    G4UIcmdWithAString*         fCmdLoadOpticalLibrary;
+    G4UIcmdWithAString*         fCmdSetOpticalMode;
 
     G4UIdirectory* fDecayDirectory;
     G4UIcmdWithABool* fSetAbsorptionCMD;
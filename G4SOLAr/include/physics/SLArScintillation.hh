@@ -61,6 +61,18 @@
 class G4PhysicsTable;
 class G4Step;
 class G4Track;
+class G4MaterialPropertiesTable;
+class SLArOpticalLibrary;
+
+// Yields of the last scintillation step computed in the current thread,
+// tagged with the track and step number they belong to.
+struct SLArScintStepYield {
+  const G4Track* fTrack = nullptr;
+  G4int fTrackID = -1;
+  G4int fStepNumber = -1;
+  G4int fNumPhotons = 0;
+  G4int fNumIonElectrons = 0;
+};
 
 // Class Description:
 // RestDiscrete Process - Generation of Scintillation Photons.
@@ -190,11 +202,28 @@ class SLArScintillation : public G4VRestDiscreteProcess
   G4int GetNumIonElectrons() const;
   // Returns the current number of ionization electrons (after PostStepDoIt)
 
+  static G4bool GetStepYield(const G4Step* step, G4int& n_ph, G4int& n_el);
+  // Returns the scint. photons and ionization electrons produced in the
+  // given step (zero if the process has not been invoked for it). 
+  // Meant to be read by the SD and the stepping action of the same thread
+
   G4bool IsPhotonGeneration() const {return fDoGeneratePhotons;}
 
   void DisablePhotonGeneration() {fDoGeneratePhotons = false;}
   void EnablePhotonGeneration() {fDoGeneratePhotons = true;}
 
+  static void SetOpticalLibrary(const SLArOpticalLibrary* library) {fgOpticalLibrary = library;}
+  static const SLArOpticalLibrary* GetOpticalLibrary() {return fgOpticalLibrary;}
+  // Set the photon visibility library used in place of the optical photon 
+  // tracking (nullptr restores the photon tracking). Shared by all threads
+
+  void SetLArQLMode(const G4String& mode);
+  // Select the evaluation of the LArQL charge yield: "table" (default,
+  // interpolation in a lookup table) or "analytic"
+
+  void SetLArQLTableAccuracy(const G4double accuracy);
+  // Target relative accuracy of the charge yield of the LArQL table
+
   
   void DumpPhysicsTable() const;
   // Prints the fast and slow scintillation integral tables.
@@ -217,6 +246,9 @@ class SLArScintillation : public G4VRestDiscreteProcess
   G4int fNumPhotons;
   G4int fNumIonElectrons; 
 
+  static G4ThreadLocal SLArScintStepYield fgStepYield;
+  static const SLArOpticalLibrary* fgOpticalLibrary;
+
   G4bool fScintillationByParticleType;
   G4bool fScintillationTrackInfo;
   G4bool fStackingFlag;
@@ -233,6 +265,11 @@ class SLArScintillation : public G4VRestDiscreteProcess
   // emission time distribution when there is a finite rise time
   G4double sample_time(G4double tau1, G4double tau2);
 
+  // sample the photons detected by the SuperCells from the visibility library
+  G4int SampleOpticalLibraryHits(const G4Track& aTrack, const G4Step& aStep, 
+      const G4MaterialPropertiesTable* MPT, G4int N_timeconstants, 
+      const G4double yields[3]);
+
   G4int secID = -1;  // creator modelID
 
 };
@@ -11,11 +11,13 @@
 
 #ifdef G4MULTITHREADED
 #include "G4MTRunManager.hh"
+#include "G4TaskRunManager.hh"
 #else
 #include "G4RunManager.hh"
 #endif
 
 #include "G4UImanager.hh"
+#include "TROOT.h"
 
 #include "SLArVersion.hh"
 #include "SLArUserPath.hh"
@@ -46,6 +48,10 @@ namespace {
     fprintf(stderr, " \t\t[-g/--geometry geometry_cfg_file]\n");
     fprintf(stderr, " \t\t[-p/--materials material_db_file]\n");
     fprintf(stderr, " \t\t[-b/--bias particle <process_list> bias_factor]\n");
+#ifdef G4MULTITHREADED
+    fprintf(stderr, " \t\t[-t/--threads number of threads]\n");
+    fprintf(stderr, " \t\t[-k/--tasking use the task-based run manager]\n");
+#endif
     fprintf(stderr, " \t\t[-h/--help print usage]\n");
     exit(0);
   }
@@ -98,11 +104,12 @@ int main(int argc,char** argv)
   std::vector<G4String> bias_process;
 
 #ifdef G4MULTITHREADED
-  G4int nThreads = 0;
+  G4int nThreads = 1;
+  G4bool use_tasking = false;
 #endif
 
-  const char* short_opts = "m:o:d:l:x:u:t:r:g:p:b:c:h";
-  static struct option long_opts[14] = 
+  const char* short_opts = "m:o:d:l:x:u:t:kr:g:p:b:c:h";
+  static struct option long_opts[15] = 
   {
     {"macro", required_argument, 0, 'm'}, 
     {"output", required_argument, 0, 'o'}, 
@@ -110,6 +117,7 @@ int main(int argc,char** argv)
     {"physics_list", required_argument, 0, 'l'},
     {"session", required_argument, 0, 'u'}, 
     {"threads", required_argument, 0, 't'}, 
+    {"tasking", no_argument, 0, 'k'}, 
     {"seed", required_argument, 0, 'r'}, 
     {"generator", required_argument, 0, 'x'},
     {"geometry", required_argument, 0, 'g'}, 
@@ -219,6 +227,12 @@ int main(int argc,char** argv)
         printf("solar_sim running on %i threads\n", nThreads);
         break;
       };
+      case 'k':
+      {
+        use_tasking = true; 
+        printf("solar_sim using the task-based run manager\n");
+        break;
+      };
 #endif
     }
   }
@@ -236,9 +250,16 @@ int main(int argc,char** argv)
   // Construct the default run manager
   //
 #ifdef G4MULTITHREADED
-  // force just 1 thread
-  nThreads = 1;
-  G4MTRunManager * runManager = new G4MTRunManager;
+  // each worker thread fills its own ROOT output
+  ROOT::EnableThreadSafety(); 
+  G4MTRunManager * runManager = nullptr;
+  if ( use_tasking ) {
+    // events are processed by the tasks of a shared thread pool
+    runManager = new G4TaskRunManager;
+  }
+  else {
+    runManager = new G4MTRunManager;
+  }
   if ( nThreads > 0 ) runManager->SetNumberOfThreads(nThreads);
 #else
   G4RunManager * runManager = new G4RunManager;
@@ -272,6 +293,10 @@ int main(int argc,char** argv)
   analysisManager->SetSeed( myseed ); 
   printf("storing seed in analysis manager: %ld - %ld\n", 
       myseed, G4Random::getTheSeed());
+#ifdef G4MULTITHREADED
+  // overlap the output of each event with the simulation of the next one
+  if ( use_tasking ) analysisManager->SetOutputMode( SLArAnalysisManager::kTaskOutput ); 
+#endif
 
 
   // Physics list
@@ -314,10 +339,16 @@ int main(int argc,char** argv)
   runManager->Initialize();
 
   if (generator_file.empty() == false) {
+    printf("Configuring generator as per %s", generator_file.data()); 
+#ifdef G4MULTITHREADED
+    // the primary generator only exists on the worker threads: 
+    // the UI command is broadcast to the workers at the start of the run
+    G4UImanager::GetUIpointer()->ApplyCommand("/SLAr/gen/configure " + generator_file); 
+#else
     gen::SLArPrimaryGeneratorAction* gen = 
       (gen::SLArPrimaryGeneratorAction*)runManager->GetUserPrimaryGeneratorAction(); 
-    printf("Configuring generator as per %s", generator_file.data()); 
     gen->SourceConfiguration( generator_file ); 
+#endif
     printf("Done\n"); 
   }
 
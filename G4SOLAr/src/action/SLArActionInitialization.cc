@@ -51,16 +51,9 @@ SLArActionInitialization::~SLArActionInitialization()
 
 void SLArActionInitialization::BuildForMaster() const
 {
-  SLArEventAction* eventAction = new SLArEventAction();
-  SLArTrackingAction* trkAction = new SLArTrackingAction();
-  SetUserAction(eventAction);
-
-
-  SetUserAction(new gen::SLArPrimaryGeneratorAction());
+  // the master thread does not process events: it only opens the 
+  // output file and merges the workers' output at the end of the run
   SetUserAction(new SLArRunAction());
-  SetUserAction(trkAction);
-  SetUserAction(new SLArSteppingAction(eventAction, trkAction));
-  SetUserAction(new SLArStackingAction(eventAction));
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -27,6 +27,7 @@
 
 #include "G4ios.hh"
 #include <cstdio>
+#include <algorithm>
 
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -120,6 +121,8 @@ void SLArEventAction::BeginOfEventAction(const G4Event*)
     fReadoutTileHits         = 0; 
     fSuperCellHits           = 0; 
 
+    SLArAnalysisManager::Instance()->GetProfiler().BeginEvent(); 
+
     return;
 }     
 
@@ -153,10 +156,12 @@ void SLArEventAction::EndOfEventAction(const G4Event* event)
     // set global edep, electrons and photon counts per primary
     auto& primaries = slar_ev_mctruth.GetPrimaries(); 
     size_t n_primaries = primaries.size(); 
+    auto& profiler = SLArAnaMgr->GetProfiler(); 
     for (size_t i = 0; i < n_primaries; i++) {
       SLArMCPrimaryInfo& primary = primaries.at(i); 
       const auto& trjs = primary.GetTrajectories();
       const size_t n_trjs = trjs.size(); 
+      profiler.Count(SLArProfiler::kNTrajectories, n_trjs); 
       G4double edep = 0; 
       G4double nph = 0; 
       for (size_t j = 0; j < n_trjs; j++) {
@@ -172,28 +177,18 @@ void SLArEventAction::EndOfEventAction(const G4Event* event)
 #ifndef SLAR_EXTERNAL
     //RecordEventLAr( event );
 
-    if ( !SLArAnaMgr->GetAnodeCfg().empty() && SLArAnaMgr->IsAnodeOutputEnabled() ) {
-      RecordEventReadoutTile( event, verbose );
+    // with direct photon hits the SDs have already filled the event
+    const bool direct_ph_hits = SLArAnaMgr->IsDirectPhotonHitsEnabled(); 
+    if ( !SLArAnaMgr->GetAnodeCfg().empty() && SLArAnaMgr->IsAnodeOutputEnabled() && !direct_ph_hits ) {
+      profiler.Count(SLArProfiler::kNPhotonHits, RecordEventReadoutTile( event, verbose ));
     }
 
-    if (SLArAnaMgr->IsPDSOutputEnabled()) {
-      RecordEventSuperCell( event, verbose );
-    }
-     
-    // apply zero suppression to charge signal
-    for (auto &evAnode : slar_ev_anode.GetAnodeMap()) {
-      short thrs = evAnode.second.GetZeroSuppressionThreshold(); 
-      if (thrs > 0) {
-        evAnode.second.ApplyZeroSuppression();
-      }
+    if (SLArAnaMgr->IsPDSOutputEnabled() && !direct_ph_hits) {
+      profiler.Count(SLArProfiler::kNPhotonHits, RecordEventSuperCell( event, verbose ));
     }
     #else
     G4int ext_scorer_hits = RecordEventExtScorer( event, verbose ); 
 #endif 
-    
-    SLArAnaMgr->FillTree();
-    SLArAnaMgr->FillGenTree();
-    
 
     if (verbose > 0) {
       printf("SLArEventAction::EndOfEventAction()\n"); 
@@ -218,7 +213,13 @@ void SLArEventAction::EndOfEventAction(const G4Event* event)
       }
     }
 
-    fParentIDMap.clear(); 
+    // hit consolidation, zero suppression and tree filling
+    SLArAnaMgr->SubmitEvent(); 
+
+    profiler.EndEvent( event->GetEventID() ); 
+
+    fTrackTable.clear(); 
+    fPrimaryIdx.clear(); 
     fExtraProcessInfo.clear(); 
 
     SLArAnaMgr->ResetEvent();
@@ -288,11 +289,16 @@ G4int SLArEventAction::RecordEventReadoutTile(const G4Event* ev, const G4int& ve
       dstHit.SetCellNr(hit->GetCellNr()); 
       dstHit.SetProducerTrkID( hit->GetProducerID() ); 
 
-      const auto& anodeCfg = SLArAnaMgr->GetAnodeCfgByID( hit->GetAnodeIdx() ); 
-      const auto& mtCfg = anodeCfg.GetBaseElementByID( dstHit.GetMegaTileID() ); 
-      const auto& tCfg = mtCfg.GetBaseElementByID( dstHit.GetTileID() ); 
-      const int mtIdx = mtCfg.GetIdx();
-      const int tIdx = tCfg.GetIdx();
+      const auto anodeCfg = SLArAnaMgr->FindAnodeCfgByID( hit->GetAnodeIdx() ); 
+      const int mtIdx = anodeCfg ? anodeCfg->GetElementIdxByID( dstHit.GetMegaTileID() ) : -1; 
+      const int tIdx = (mtIdx < 0) ? -1 : 
+        anodeCfg->GetBaseElement( mtIdx ).GetElementIdxByID( dstHit.GetTileID() ); 
+      if (tIdx < 0) {
+        printf("SLArEventAction::RecordEventReadoutTile WARNING: ");
+        printf("tile [%i, %i, %i] not found in the anode configuration. Hit skipped.\n", 
+            anode_idx, dstHit.GetMegaTileID(), dstHit.GetTileID());
+        continue;
+      }
 
       // Compute unique identifier of SiPM replacing cell nr
       const int sipm_nr = n_cell_row * dstHit.GetRowCellNr() + dstHit.GetCellNr();
@@ -314,6 +320,7 @@ G4int SLArEventAction::RecordEventReadoutTile(const G4Event* ev, const G4int& ve
 
       if (bktManager) {
         if (bktManager->IsNull() == false) {
+          SLArProfileScope profile_scope(SLArProfiler::kBacktracker); 
           auto& records = 
             ev_tile.GetBacktrackerVector( ev_tile.ConvertToClock(dstHit.GetTime()) );
 
@@ -392,13 +399,20 @@ G4int SLArEventAction::RecordEventSuperCell(const G4Event* ev, const G4int& verb
       dstHit.SetTileInfo(0, array_nr, cellrow_nr, cell_nr); 
       dstHit.SetProducerTrkID( hit->GetProducerID() ); 
 
-      const auto& cfgArray = SLArAnaMgr->GetPDSCfg().GetBaseElement(array_nr);
-      const int cell_idx = cfgArray.GetBaseElementByID( dstHit.GetTileID() ).GetIdx(); 
+      const auto cfgArray = SLArAnaMgr->GetPDSCfg().FindBaseElement(array_nr);
+      const int cell_idx = cfgArray ? cfgArray->GetElementIdxByID( dstHit.GetTileID() ) : -1; 
+      if (cell_idx < 0) {
+        printf("SLArEventAction::RecordEventSuperCell WARNING: ");
+        printf("SuperCell [%i, %i] not found in the PDS configuration. Hit skipped.\n", 
+            array_nr, dstHit.GetTileID());
+        continue;
+      }
 
       auto& ev_sc = SLArAnaMgr->GetEventPDS().GetOpDetArrayByID(array_nr).RegisterHit(dstHit, cell_idx);
 
       if (bktManager) {
         if (bktManager->IsNull() == false) {
+          SLArProfileScope profile_scope(SLArProfiler::kBacktracker); 
           SLArEventBacktrackerVector& records = 
             ev_sc.GetBacktrackerVector( ev_sc.ConvertToClock<float>(dstHit.GetTime()) );
 
@@ -500,8 +514,40 @@ G4int SLArEventAction::RecordEventExtScorer(const G4Event* ev, const G4int& verb
   return n_hits;
 }
 
+/**
+ * @details Register a new track in the event track table. Primary tracks
+ * (registered with `p_id == trk_id`) are matched to the corresponding
+ * MCTruth primary, while secondaries inherit the ancestor of their parent, 
+ * so that the ancestor of every track is resolved once at creation.
+ *
+ * @param trk_id track ID
+ * @param p_id parent track ID
+ */
 void SLArEventAction::RegisterNewTrackPID(int trk_id, int p_id) {
-  fParentIDMap.insert( std::make_pair(trk_id, p_id) ); 
+  if (trk_id < 0) return;
+  if (trk_id >= (int)fTrackTable.size()) {
+    fTrackTable.resize( std::max(2*fTrackTable.size(), (size_t)trk_id+1) ); 
+  }
+
+  auto& entry = fTrackTable[trk_id]; 
+  if (entry.parent != -1) return; // already registered
+  entry.parent = p_id; 
+
+  if (p_id == trk_id) {
+    const auto& primaries = 
+      SLArAnalysisManager::Instance()->GetMCTruth().GetPrimaries(); 
+    for (size_t ip = 0; ip < primaries.size(); ip++) {
+      if (primaries[ip].GetTrackID() == trk_id) {
+        if (trk_id >= (int)fPrimaryIdx.size()) fPrimaryIdx.resize(trk_id+1, -1); 
+        fPrimaryIdx[trk_id] = ip; 
+        entry.ancestor = trk_id; 
+        break;
+      }
+    }
+  }
+  else {
+    entry.ancestor = FindAncestorID(p_id); 
+  }
   return;
 }
 
@@ -519,66 +565,57 @@ void SLArEventAction::RegisterNewProcessExtraInfo(const TrackIdHelpInfo_t& trkHe
 }
 
 
+/**
+ * @details Return the ID of the primary particle from which the given
+ * track descends. The ancestor is normally memoized when the track is 
+ * registered; otherwise the parent chain is walked up to the first track 
+ * with a known ancestor and the result is stored for every track 
+ * along the path (path compression). 
+ *
+ * @param trkid track ID
+ */
 int SLArEventAction::FindAncestorID(int trkid) {
-  int primary = -1; 
-  int pid = trkid; 
-
-  SLArAnalysisManager* anaMngr = SLArAnalysisManager::Instance(); 
-  const auto& primaries = anaMngr->GetMCTruth().GetPrimaries(); 
-
-  if (primaries.empty()) {
-    fprintf(stderr, "SLArEventAction::FindAncestorID(%i) ERROR: no primaries found in event\n", trkid);
+  if (trkid < 0 || trkid >= (int)fTrackTable.size() || fTrackTable[trkid].parent == -1) {
+    fprintf(stderr, "SLArEventAction::FindAncestorID(%i) ERROR: cannot find track in event track table\n", trkid);
     return -1; 
   }
 
-  bool caught = false; 
-//#ifdef SLAR_DEBUG
-  //printf("SLArEventAction::FindAncestorID() Lookging for primary parent of %i among\n", trkid);
-  //for (const auto& _pid : fParentIDMap) {
-    //printf("%i - PID: %i\n", _pid.first, _pid.second); 
-  //}
-
-  //printf("\nList of primaries: \n");
-  //for (const SLArMCPrimaryInfo& p : primaries) {
-    //printf("%s - PID: %i\n", p.GetParticleName().Data(), p.GetTrackID());
-  //}
-//#endif
-
-  while ( !caught ) {
-    if (fParentIDMap.find(trkid) == fParentIDMap.end()) {
-      fprintf(stderr, "SLArEventAction::FindAncestorID(%i) ERROR: cannot find track in event track table\n", trkid);
+  if (fTrackTable[trkid].ancestor != -1) return fTrackTable[trkid].ancestor; 
+
+  int primary = -1; 
+  int id = trkid; 
+  std::vector<int> path; 
+  while (true) {
+    path.push_back(id); 
+    const int pid = fTrackTable[id].parent; 
+    if (pid == id) break; // unmatched primary
+    if (pid < 0 || pid >= (int)fTrackTable.size() || fTrackTable[pid].parent == -1) {
+      fprintf(stderr, "SLArEventAction::FindAncestorID(%i) ERROR: cannot find track %i in event track table\n", trkid, pid);
       break;
     }
-
-    pid = fParentIDMap[trkid];
-//#ifdef SLAR_DEBUG
-    //printf("local parent id: %i\n", pid);
-//#endif
-
-    for (const auto& p : primaries) {
-      if (pid == p.GetTrackID()) {
-        primary = pid; 
-        caught = true;
-//#ifdef SLAR_DEBUG
-        //printf("Acestor found: trk %i associated to primary %i\n", 
-            //trkid, primary);
-//#endif
-       }
+    if (fTrackTable[pid].ancestor != -1) {
+      primary = fTrackTable[pid].ancestor; 
+      break;
     }
-
-    trkid = pid; 
-//#ifdef SLAR_DEBUG
-    //getchar(); 
-//#endif
+    id = pid; 
   }
 
-//#ifdef SLAR_DEBUG
-    //printf("Caught! returning %i\n", primary);
-    ////getchar(); 
-//#endif
+  if (primary == -1) return -1; 
+
+  for (const auto& t : path) fTrackTable[t].ancestor = primary; 
 
   return primary; 
 }
 
-//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+/**
+ * @details Return a pointer to the MCTruth primary with the given track ID 
+ * (as returned by `FindAncestorID`), or `nullptr` if there is none. 
+ */
+SLArMCPrimaryInfo* SLArEventAction::GetAncestorPrimary(int ancestor_id) {
+  if (ancestor_id < 0 || ancestor_id >= (int)fPrimaryIdx.size()) return nullptr; 
+  const int idx = fPrimaryIdx[ancestor_id]; 
+  if (idx < 0) return nullptr; 
+  return &SLArAnalysisManager::Instance()->GetMCTruth().GetPrimary(idx); 
+}
 
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -11,9 +11,11 @@
 #include "SLArRunAction.hh"
 #include "SLArRun.hh"
 #include "geo/SLArGeoUtils.hh"
+#include "physics/SLArScintillation.hh"
 
 #include "G4Run.hh"
 #include "G4RunManager.hh"
+#include "G4Threading.hh"
 #include "G4ProductionCutsTable.hh"
 
 
@@ -25,8 +27,11 @@ SLArRunAction::SLArRunAction()
   SLArAnalysisManager* anamgr = SLArAnalysisManager::Instance();
   fTRandomInterface = new SLArRandom(); 
 
-  const auto detector = (SLArDetectorConstruction*)G4RunManager::GetRunManager()->GetUserDetectorConstruction();
-  fElectronDrift = new SLArElectronDrift(detector->GetLArProperties()); 
+  // the electron drift is only needed where events are processed
+  if ( !G4Threading::IsMultithreadedApplication() || G4Threading::IsWorkerThread() ) {
+    const auto detector = (SLArDetectorConstruction*)G4RunManager::GetRunManager()->GetUserDetectorConstruction();
+    fElectronDrift = new SLArElectronDrift(detector->GetLArProperties()); 
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -34,6 +39,7 @@ SLArRunAction::SLArRunAction()
 SLArRunAction::~SLArRunAction()
 {
   delete fTRandomInterface;
+  if (fElectronDrift) delete fElectronDrift;
   delete SLArAnalysisManager::Instance();
   fSDName.clear(); 
 }
@@ -52,14 +58,35 @@ void SLArRunAction::BeginOfRunAction(const G4Run* aRun)
   //G4RunManager::GetRunManager()->SetRandomNumberStore(true);
   SLArAnalysisManager* SLArAnaMgr = SLArAnalysisManager::Instance(); 
 
+  SLArAnaMgr->CopySettingsFromMaster(); 
   SLArAnaMgr->CreateFileStructure();
 
   const auto detector = (SLArDetectorConstruction*)G4RunManager::GetRunManager()->GetUserDetectorConstruction();
   const auto stepping = (SLArSteppingAction*)G4RunManager::GetRunManager()->GetUserSteppingAction(); 
 
-  SLArLArProperties& lar_properties = detector->GetLArProperties(); 
-  lar_properties.ComputeProperties(); 
-  lar_properties.PrintProperties(); 
+  // LAr properties are shared among threads: computed by the master 
+  // before the workers start the event loop
+  if ( IsMaster() ) {
+    SLArLArProperties& lar_properties = detector->GetLArProperties(); 
+    lar_properties.ComputeProperties(); 
+    lar_properties.PrintProperties(); 
+
+    // the optical library only samples SuperCell hits: the anode tile 
+    // SiPMs do not receive any light in library mode
+    if (SLArScintillation::GetOpticalLibrary() && !SLArAnaMgr->GetAnodeCfg().empty()) {
+      if (SLArAnaMgr->IsAnodeOutputEnabled()) {
+        G4Exception("SLArRunAction::BeginOfRunAction", "OpticalLibraryTiles", 
+            FatalException, 
+            "Optical library mode does not produce photon hits on the anode tile SiPMs. "
+            "Disable the anode output (/SLAr/manager/enableAnodeOutput false) or switch back to "
+            "photon tracking (/SLAr/phys/setOpticalMode tracking).");
+      }
+      else {
+        G4Exception("SLArRunAction::BeginOfRunAction", "OpticalLibraryTiles", 
+            JustWarning, "Optical library mode: the anode tile SiPMs do not receive any light.");
+      }
+    }
+  }
 
   // set tranformation for step points output
   const auto target_lar_pv = detector->GetLArTargetVolume()->GetModPV();
@@ -68,11 +95,13 @@ void SLArRunAction::BeginOfRunAction(const G4Run* aRun)
 
   const G4Transform3D transform(*r, t);
   fTransformWorld2Det = transform.inverse();
-  stepping->SetPointTransformation(fTransformWorld2Det);
+  if (stepping) stepping->SetPointTransformation(fTransformWorld2Det);
 
   // dump cross sections
-  for (const auto& xsec : SLArAnaMgr->GetXSecDumpVector()) {
-    SLArAnaMgr->WriteCrossSection(xsec); 
+  if ( IsMaster() ) {
+    for (const auto& xsec : SLArAnaMgr->GetXSecDumpVector()) {
+      SLArAnaMgr->WriteCrossSection(xsec); 
+    }
   }
   /*
   auto volumeStore = G4PhysicalVolumeStore::GetInstance();
@@ -165,27 +194,35 @@ void SLArRunAction::EndOfRunAction(const G4Run* aRun)
   //SLArAnaMgr->WriteVariable("nCurrent_outerWall", ncurr_0);
   //SLArAnaMgr->WriteVariable("nCurrent_innerWall", ncurr_1);
 
+  auto RunMngr = G4RunManager::GetRunManager(); 
+
+  // in MT mode the generator only exists on the workers: the generator
+  // configuration is copied to the master file when merging the output
+  auto SLArGen = (gen::SLArPrimaryGeneratorAction*)RunMngr->GetUserPrimaryGeneratorAction(); 
+  if (SLArGen) {
+    const auto& generators = SLArGen->GetGenerators(); 
+
+    for (const auto& gen : generators) {
+      G4String gen_config = gen.second->WriteConfig(); 
+
+      SLArAnaMgr->WriteCfg(gen.first.data(), gen_config.data()); 
+    }
+  }
+
+  if ( !IsMaster() ) {
+    SLArAnaMgr->Save(); 
+    return;
+  }
+
   if (!fG4MacroFile.empty()) {
     SLArAnaMgr->WriteCfgFile("g4macro", fG4MacroFile.c_str()); 
   }
 
-  auto RunMngr = G4RunManager::GetRunManager(); 
   auto SLArDetConstr = 
     (SLArDetectorConstruction*)RunMngr->GetUserDetectorConstruction(); 
   SLArAnaMgr->WriteCfgFile("geometry", SLArDetConstr->GetGeometryCfgFile().c_str());
   SLArAnaMgr->WriteCfgFile("materials", SLArDetConstr->GetMaterialCfgFile().c_str());
 
-  auto SLArGen = (gen::SLArPrimaryGeneratorAction*)RunMngr->GetUserPrimaryGeneratorAction(); 
-  const auto& generators = SLArGen->GetGenerators(); 
-
-  for (const auto& gen : generators) {
-    gen::EGenerator kGen = gen.second->GetGeneratorEnum(); 
-
-    G4String gen_config = gen.second->WriteConfig(); 
-
-    SLArAnaMgr->WriteCfg(gen.first.data(), gen_config.data()); 
-  }
-
   for (const auto& scorer : fExtScorerLV) {
     auto scorer_solid = scorer->GetSolid(); 
     printf("scorer solid volume is %s\n", scorer_solid->GetName().data()); 
@@ -197,9 +234,11 @@ void SLArRunAction::EndOfRunAction(const G4Run* aRun)
 
   SLArAnaMgr->WriteVariable("rndm_seed", SLArAnaMgr->GetSeed()); 
 
-  SLArAnaMgr->Save();
+  if ( G4Threading::IsMultithreadedApplication() ) {
+    SLArAnaMgr->MergeWorkerOutputs(); 
+  }
 
-  delete fElectronDrift;  fElectronDrift = nullptr;
+  SLArAnaMgr->Save();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
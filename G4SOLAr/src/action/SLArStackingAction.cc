@@ -62,6 +62,7 @@ SLArStackingAction::~SLArStackingAction()
 G4ClassificationOfNewTrack
 SLArStackingAction::ClassifyNewTrack(const G4Track * aTrack)
 {
+  SLArProfileScope profile_scope(SLArProfiler::kStacking); 
   G4ClassificationOfNewTrack kClassification = fUrgent; 
 
   if(aTrack->GetDefinition() != G4OpticalPhoton::OpticalPhotonDefinition()) {
@@ -75,7 +76,6 @@ SLArStackingAction::ClassifyNewTrack(const G4Track * aTrack)
       auto SLArAnaMgr = SLArAnalysisManager::Instance(); 
       G4int parentID = 0; 
       if (aTrack->GetParentID() == 0) { // this is a primary
-        fEventAction->RegisterNewTrackPID(aTrack->GetTrackID(), aTrack->GetTrackID()); 
         parentID = aTrack->GetTrackID(); 
         //printf("Track %i is a candidate primary with pdg id %i\n", 
             //aTrack->GetTrackID(), aTrack->GetParticleDefinition()->GetPDGEncoding());
@@ -87,6 +87,9 @@ SLArStackingAction::ClassifyNewTrack(const G4Track * aTrack)
           G4double match = PositivePrimaryIdentification(aTrack, primaryInfo);
           if (match) break;
         }
+        // register after the identification so that the track is 
+        // immediately resolved as its own ancestor
+        fEventAction->RegisterNewTrackPID(aTrack->GetTrackID(), aTrack->GetTrackID()); 
       } else {
         //printf("Not a primary, recording parent id\n");
         fEventAction->RegisterNewTrackPID(aTrack->GetTrackID(), aTrack->GetParentID()); 
@@ -114,37 +117,30 @@ SLArStackingAction::ClassifyNewTrack(const G4Track * aTrack)
       }
       
       //printf("creating trajectory...\n");
-      SLArEventTrajectory trajectory;
-      trajectory.SetTrackID( aTrack->GetTrackID() ); 
-      trajectory.SetParentID(aTrack->GetParentID()); 
-      trajectory.SetParticleName( particleName );
-      trajectory.SetPDGID( aTrack->GetDynamicParticle()->GetPDGcode() ); 
-      trajectory.SetCreatorProcess( creatorProc ); 
-      trajectory.SetTime( aTrack->GetGlobalTime() ); 
-      trajectory.SetWeight(aTrack->GetWeight()); 
-      trajectory.SetStoreTrajectoryPts( SLArAnaMgr->StoreTrajectoryFull() ); 
+      SLArEventTrajectory* trajectory = SLArAnaMgr->GetMCTruth().NewTrajectory();
+      trajectory->SetTrackID( aTrack->GetTrackID() ); 
+      trajectory->SetParentID(aTrack->GetParentID()); 
+      trajectory->SetParticleName( particleName );
+      trajectory->SetPDGID( aTrack->GetDynamicParticle()->GetPDGcode() ); 
+      trajectory->SetCreatorProcess( creatorProc ); 
+      trajectory->SetTime( aTrack->GetGlobalTime() ); 
+      trajectory->SetWeight(aTrack->GetWeight()); 
+      trajectory->SetStoreTrajectoryPts( SLArAnaMgr->StoreTrajectoryFull() ); 
       //trajectory.SetOriginVolCopyNo(aTrack->GetVolume()->GetCopyNo()); 
-      trajectory.SetInitKineticEne( aTrack->GetKineticEnergy() ); 
+      trajectory->SetInitKineticEne( aTrack->GetKineticEnergy() ); 
       auto& vertex_momentum = aTrack->GetMomentumDirection();
-      trajectory.SetInitMomentum( vertex_momentum.x(), vertex_momentum.y(), vertex_momentum.z() );
+      trajectory->SetInitMomentum( vertex_momentum.x(), vertex_momentum.y(), vertex_momentum.z() );
       G4int ancestor_id = fEventAction->FindAncestorID( parentID ); 
-
-      SLArMCPrimaryInfo* ancestor = nullptr; 
-      auto& primaries = SLArAnaMgr->GetMCTruth().GetPrimaries();
-      for (auto &p : primaries) {
-        if (p.GetTrackID() == ancestor_id) {
-          ancestor = &p; 
-          break;
-        }
-      }
+      SLArMCPrimaryInfo* ancestor = fEventAction->GetAncestorPrimary( ancestor_id ); 
       if (!ancestor) printf("Unable to find corresponding primary particle\n");
 #ifdef SLAR_DEBUG
       if (!ancestor) printf("Unable to find corresponding primary particle\n");
 #endif
 
-      ancestor->RegisterTrajectory( std::move(trajectory) ); 
+      ancestor->RegisterTrajectory( trajectory ); 
 
-      auto trkInfo = new SLArUserTrackInformation( ancestor->GetTrajectories().back() ); 
+      auto trkInfo = new SLArUserTrackInformation( trajectory ); 
+      trkInfo->SetAncestor( ancestor_id, ancestor ); 
 
       trkInfo->SetStoreTrajectory(true); 
 
@@ -155,10 +151,8 @@ SLArStackingAction::ClassifyNewTrack(const G4Track * aTrack)
   { // particle is optical photon
     if(aTrack->GetParentID() > 0)
     { // particle is secondary
-      SLArAnalysisManager* anaMngr = SLArAnalysisManager::Instance(); 
       SLArMCPrimaryInfo* primary = nullptr; 
       //SLArMCPrimaryInfoPtr* primary = nullptr; 
-      auto& primaries = anaMngr->GetMCTruth().GetPrimaries();
 
       int primary_parent_id = fEventAction->FindAncestorID(aTrack->GetParentID()); 
       
@@ -168,15 +162,7 @@ SLArStackingAction::ClassifyNewTrack(const G4Track * aTrack)
         //#ifdef SLAR_DEBUG
         //printf("Creator process: %s, Primary parent ID %i\n", primary_parent_id, creator_process.data());
         //#endif
-        for (auto &p : primaries) {
-          if (p.GetTrackID() == primary_parent_id) {
-            primary = &p; 
-            //#ifdef SLAR_DEBUG
-            //printf("primary parent found\n");
-            //#endif
-            break; 
-          }
-        }
+        primary = fEventAction->GetAncestorPrimary(primary_parent_id); 
 
 #ifdef SLAR_DEBUG
         if (!primary) printf("Unable to find corresponding primary particle\n");
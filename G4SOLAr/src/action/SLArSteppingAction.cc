@@ -5,6 +5,7 @@
  * @brief       Implementation of the SLArSteppingAction class
  */
 
+#include <algorithm>
 #include "SLArScintillation.hh"
 #include "SLArSteppingAction.hh"
 #include "SLArUserPhotonTrackInformation.hh"
@@ -36,6 +37,8 @@ SLArSteppingAction::SLArSteppingAction(SLArEventAction* ea, SLArTrackingAction*
   fEventAction          = ea;
   fTrackinAction        = ta;
   fEventNumber = -1;
+  fWindowTrajectory = nullptr;
+  fWindow.reserve(kMaxDecimationWindow);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -76,6 +79,113 @@ trj_point SLArSteppingAction::set_evtrj_point(const G4StepPoint* point, const in
   return step_point;
 }
 
+/**
+ * @details Add a step point to the trajectory according to the trajectory
+ * point policy set in the analysis manager. The selection is done while
+ * stepping: when a new point makes the last stored one redundant, the last 
+ * point is replaced by the new one and its edep, n_ph and n_el are added 
+ * to it, so that the sums over the stored points are conserved. 
+ *
+ * - kStoreAllPoints: every point is stored
+ * - kDecimatePoints: the last point is dropped if it and all the points 
+ *   already dropped since the previous stored one lie within the tolerance
+ *   from the segment joining the previous stored point and the new one 
+ *   (a streaming version of the Douglas-Peucker simplification). Points 
+ *   are never merged across a change of volume. 
+ * - kStoreLArPoints: points outside LAr are not stored 
+ * - kStoreVolumeEdges: only the first and the last point in each volume 
+ *   are stored 
+ */
+void SLArSteppingAction::RegisterTrajectoryPoint(SLArEventTrajectory* trajectory, trj_point& point)
+{
+  const auto anaMngr = SLArAnalysisManager::Instance(); 
+  const auto policy = anaMngr->GetTrajectoryPointPolicy(); 
+  auto& points = trajectory->GetPoints(); 
+
+  if (policy == SLArAnalysisManager::kStoreAllPoints) {
+    trajectory->RegisterPoint(point); 
+    return;
+  }
+  else if (policy == SLArAnalysisManager::kStoreLArPoints) {
+    if (point.fLAr) trajectory->RegisterPoint(point); 
+    return;
+  }
+
+  auto same_volume = [](const trj_point& p0, const trj_point& p1) {
+    return (p0.fCopy == p1.fCopy) && (p0.fLAr == p1.fLAr);
+  }; 
+
+  const size_t npoints = points.size(); 
+  G4bool merge = false; 
+  if (policy == SLArAnalysisManager::kStoreVolumeEdges) {
+    // the last point can be dropped if it is not the first one in its volume
+    merge = (npoints > 1) && 
+      same_volume(points[npoints-1], point) && same_volume(points[npoints-2], points[npoints-1]);
+  }
+  else if (policy == SLArAnalysisManager::kDecimatePoints) {
+    // a new track (or a suspended one) starts with an empty window
+    if (trajectory != fWindowTrajectory || npoints < 2) {
+      fWindowTrajectory = trajectory; 
+      fWindow.clear(); 
+    }
+    else {
+      merge = same_volume(points[npoints-1], point) && 
+        fWindow.size() < kMaxDecimationWindow && 
+        CanDecimate(points, point, anaMngr->GetTrajectoryPointTolerance());
+    }
+  }
+
+  if (merge) {
+    trj_point& last = points.back(); 
+    point.fEdep += last.fEdep; 
+    point.fNph += last.fNph; 
+    point.fNel += last.fNel; 
+    if (policy == SLArAnalysisManager::kDecimatePoints) fWindow.push_back(last); 
+    last = point; 
+  }
+  else {
+    fWindow.clear(); 
+    trajectory->RegisterPoint(point); 
+  }
+
+  return;
+}
+
+/**
+ * @details Check if the last stored point and the points in the decimation
+ * window are all within the tolerance from the segment joining the 
+ * second-to-last stored point and the new point.
+ */
+G4bool SLArSteppingAction::CanDecimate(const std::vector<trj_point>& points, 
+    const trj_point& point, const G4double tolerance) const
+{
+  const trj_point& anchor = points[points.size()-2]; 
+  const float dx = point.fX - anchor.fX; 
+  const float dy = point.fY - anchor.fY; 
+  const float dz = point.fZ - anchor.fZ; 
+  const float len2 = dx*dx + dy*dy + dz*dz; 
+  const float tol2 = tolerance*tolerance; 
+
+  auto dist2 = [&](const trj_point& p) {
+    float qx = p.fX - anchor.fX; 
+    float qy = p.fY - anchor.fY; 
+    float qz = p.fZ - anchor.fZ; 
+    if (len2 > 0) {
+      const float t = std::min(1.0f, std::max(0.0f, (qx*dx + qy*dy + qz*dz) / len2)); 
+      qx -= t*dx; 
+      qy -= t*dy; 
+      qz -= t*dz; 
+    }
+    return qx*qx + qy*qy + qz*qz;
+  }; 
+
+  if (dist2(points.back()) > tol2) return false;
+  for (const auto& p : fWindow) {
+    if (dist2(p) > tol2) return false;
+  }
+  return true;
+}
+
 void SLArSteppingAction::UserSteppingAction(const G4Step* step)
 {
   G4Track* track = step->GetTrack();
@@ -108,25 +218,9 @@ void SLArSteppingAction::UserSteppingAction(const G4Step* step)
     auto trkInfo = (SLArUserTrackInformation*)track->GetUserInformation(); 
     SLArEventTrajectory* trajectory = trkInfo->GimmeEvTrajectory();
     double edep = step->GetTotalEnergyDeposit();
-    auto stepMngr = fTrackinAction->GetTrackingManager()->GetSteppingManager(); 
     int n_ph = 0; 
     int n_el = 0; 
-
-    if (stepMngr->GetfStepStatus() != fAtRestDoItProc) {
-      G4ProcessVector* process_vector = stepMngr->GetfPostStepDoItVector(); 
-      for (size_t iproc = 0; iproc < process_vector->size(); iproc++) {
-        G4VProcess* proc = (*process_vector)[iproc]; 
-        if (!proc) continue;
-        if (proc->GetProcessName() == "Scintillation") {
-          SLArScintillation* scint_process = (SLArScintillation*)proc; 
-
-          n_ph = scint_process->GetNumPhotons(); 
-          n_el = scint_process->GetNumIonElectrons(); 
-          
-          break;
-        } 
-      }
-    }
+    SLArScintillation::GetStepYield(step, n_ph, n_el); 
 
     if (trkInfo->CheckStoreTrajectory() == true) {
       if (trajectory->GetPoints().empty()) {
@@ -141,7 +235,7 @@ void SLArSteppingAction::UserSteppingAction(const G4Step* step)
         //printf("trajectory has %lu points\n", trajectory->GetPoints().size());
         trj_point step_point = set_evtrj_point( thePostPoint, n_el, n_ph ); 
         step_point.fEdep = step->GetTotalEnergyDeposit(); 
-        trajectory->RegisterPoint(step_point); 
+        RegisterTrajectoryPoint(trajectory, step_point); 
       }
     }
 
@@ -350,83 +444,31 @@ void SLArSteppingAction::UserSteppingAction(const G4Step* step)
               (G4TouchableHistory*)thePostPoint->GetTouchable(); 
 #ifdef SLAR_DEBUG
             G4cout << "SLArSteppingAction::UserSteppingAction Detection" << G4endl;
-#endif
-            G4SDManager* SDman = G4SDManager::GetSDMpointer();
-            G4String volName = touchable->GetVolume()->GetName();
-
-            G4String sdNameSiPM  ="/tile/sipm";
-            G4String sdNameSC    ="/supercell";
-
-            SLArReadoutTileSD* sipmSD = nullptr;
-            SLArSuperCellSD* supercellSD = nullptr; 
-
-#ifdef SLAR_DEBUG
              printf("Detection in %s - copy id [%i]\n", 
-                 volName.c_str(), touchable->GetCopyNumber(0)); 
-             //getchar(); 
+                 touchable->GetVolume()->GetName().c_str(), touchable->GetCopyNumber(0)); 
 #endif
 
             if (phInfo) phInfo->AddTrackStatusFlag(hitPMT);
-            if (volName=="SiPMActivePV") {
-//#ifdef SLAR_DEBUG
-              //printf("Copy No hierarchy: [%i, %i, %i, %i, %i, %i, %i, %i, %i, %i]\n", 
-                  //touchable->GetCopyNumber(0), 
-                  //touchable->GetCopyNumber(1),
-                  //touchable->GetCopyNumber(2),
-                  //touchable->GetCopyNumber(3),
-                  //touchable->GetCopyNumber(4),
-                  //touchable->GetCopyNumber(5), 
-                  //touchable->GetCopyNumber(6), 
-                  //touchable->GetCopyNumber(7), 
-                  //touchable->GetCopyNumber(8),
-                  //touchable->GetCopyNumber(9)
-                  //);
-              //for (int i=0; i<10; i++) {
-                //printf("depth %i: %s\n", i, touchable->GetVolume(i)->GetName().c_str());   
-              //}
-
-              //getchar(); 
-//#endif
-              sipmSD = (SLArReadoutTileSD*)SDman->FindSensitiveDetector(sdNameSiPM);
-              if(sipmSD) { 
-                fEventAction->IncReadoutTileHitCount(); 
-                sipmSD->ProcessHits_constStep(step, nullptr);
-              } else {
-#ifdef SLAR_DEBUG
-                printf("SLArSteppingAction::UserSteppingAction::Detection WARNING\n"); 
-                printf("%s is not recognized as SD\n", volName.c_str());
-#endif
-              }
-            } else if (volName == "SuperCellCoating") {
-#ifdef SLAR_DEBUG
-              printf("Copy No hierarchy: [%i, %i, %i, %i, %i]\n", 
-                  touchable->GetCopyNumber(0), 
-                  touchable->GetCopyNumber(1),
-                  touchable->GetCopyNumber(2),
-                  touchable->GetCopyNumber(3),
-                  touchable->GetCopyNumber(4)
-                  );
-              //getchar(); 
-#endif
 
-              supercellSD = (SLArSuperCellSD*)SDman->FindSensitiveDetector(sdNameSC);
-              if(supercellSD) { 
+            // dispatch table filled in SLArDetectorConstruction::ConstructSDandField
+            const auto& photonSD = SLArDetectorConstruction::GetPhotonSD(
+                touchable->GetVolume()->GetLogicalVolume()); 
+            switch (photonSD.fType) {
+              case SLArDetectorConstruction::kReadoutTilePhotonSD:
+                fEventAction->IncReadoutTileHitCount(); 
+                static_cast<SLArReadoutTileSD*>(photonSD.fSD)->ProcessHits_constStep(step, nullptr);
+                break;
+              case SLArDetectorConstruction::kSuperCellPhotonSD:
                 fEventAction->IncSuperCellHitCount(); 
-                supercellSD->ProcessHits_constStep(step, nullptr);
-              } else {
+                static_cast<SLArSuperCellSD*>(photonSD.fSD)->ProcessHits_constStep(step, nullptr);
+                break;
+              default:
 #ifdef SLAR_DEBUG
                 printf("SLArSteppingAction::UserSteppingAction::Detection WARNING\n"); 
-                printf("%s is not recognized as SD\n", volName.c_str());
+                printf("%s is not recognized as SD\n", touchable->GetVolume()->GetName().c_str());
 #endif
-              }
-            } 
-#ifdef SLAR_DEBUG
-            else {
-                printf("SLArSteppingAction::UserSteppingAction::Detection WARNING\n"); 
-                printf("%s is not recognized as SD\n", volName.c_str());
-                getchar(); 
+                break;
             }
-#endif
             
             track->SetTrackStatus( fStopAndKill );
             break;
@@ -5,26 +5,91 @@
  */
 
 #include <cstdio>
+#include <cstring>
 #include <sys/stat.h>
 #include <fstream>
 #include <sstream>
+#include <algorithm>
 
 #include "G4ParticleTable.hh"
 #include "G4Material.hh"
 #include "G4ProcessManager.hh"
 #include "G4ProcessVector.hh"
 #include "G4HadronicProcessStore.hh"
+#include "G4SDManager.hh"
+#include "G4AutoLock.hh"
+#ifdef G4MULTITHREADED
+#include "G4TaskRunManager.hh"
+#endif
 
 #include "SLArAnalysisManager.hh"
 #include "SLArBacktrackerManager.hh"
+#include "SLArRootUtilities.hh"
+
+#include "rapidjson/filereadstream.h"
 
 #include "SLArEventAnode.hh"
 #include "TObjString.h"
 #include "TVectorD.h"
+#include "TKey.h"
+#include "TROOT.h"
 
 SLArAnalysisManager* SLArAnalysisManager::fgMasterInstance = nullptr;
 G4ThreadLocal SLArAnalysisManager* SLArAnalysisManager::fgInstance = nullptr;
 
+namespace {
+  G4Mutex anaMgrMutex = G4MUTEX_INITIALIZER;
+
+  struct SLArMergeEntry_t {
+    Int_t    fEvNumber;
+    size_t   fFile;
+    Long64_t fEntry;
+  };
+
+  std::vector<SLArMergeEntry_t> sequential_order(const std::vector<TFile*>& inputs, const char* name) 
+  {
+    std::vector<SLArMergeEntry_t> order;
+    for (size_t i = 0; i < inputs.size(); i++) {
+      TTree* t = inputs[i]->Get<TTree>(name);
+      if (t == nullptr) continue;
+      for (Long64_t j = 0; j < t->GetEntries(); j++) order.push_back({0, i, j});
+    }
+    return order;
+  }
+
+  TTree* merge_tree(const char* name, const std::vector<TFile*>& inputs, 
+      const std::vector<SLArMergeEntry_t>& order, TFile* output) 
+  {
+    std::vector<TTree*> trees(inputs.size(), nullptr);
+    TTree* ref = nullptr;
+    for (size_t i = 0; i < inputs.size(); i++) {
+      trees[i] = inputs[i]->Get<TTree>(name);
+      if (ref == nullptr) ref = trees[i];
+    }
+    if (ref == nullptr) return nullptr;
+
+    output->cd();
+    TTree* merged = ref->CloneTree(0);
+    merged->SetDirectory(output);
+
+    size_t icurrent = inputs.size();
+    for (const auto& entry : order) {
+      TTree* t = trees[entry.fFile];
+      if (t == nullptr) continue;
+      if (entry.fFile != icurrent) {
+        // point the output branches to the buffers of the current input
+        t->CopyAddresses(merged);
+        icurrent = entry.fFile;
+      }
+      t->GetEntry(entry.fEntry);
+      merged->Fill();
+    }
+    merged->ResetBranchAddresses();
+
+    return merged;
+  }
+}
+
 SLArAnalysisManager::SLArXSecDumpSpec::SLArXSecDumpSpec() 
   : particle_name(""), process_name(""), material_name(""), log_span(false)
 {}
@@ -33,6 +98,39 @@ SLArAnalysisManager::SLArXSecDumpSpec::SLArXSecDumpSpec(const G4String& par, con
   : particle_name(par), process_name(proc), material_name(mat), log_span(do_log)
 {}
 
+SLArAnalysisManager::SLArEventBuffer::SLArEventBuffer(const SLArListEventAnode& ev_anode, const SLArListEventPDS& ev_pds)
+  : fEventNumber(-1), fMCTruth(), fEventAnode(ev_anode), fEventPDS(ev_pds), fGenRecords()
+{}
+
+void SLArAnalysisManager::SLArEventBuffer::Reset() 
+{
+  fMCTruth.Reset(); 
+  fEventAnode.Reset(); 
+  fEventPDS.Reset(); 
+  fGenRecords.Reset(); 
+  fEventNumber = -1;
+}
+
+void SLArAnalysisManager::SLArEventBuffer::Swap(SLArEventBuffer& other) 
+{
+  std::swap(fEventNumber, other.fEventNumber); 
+  fMCTruth.Swap( other.fMCTruth ); 
+  fEventAnode.Swap( other.fEventAnode ); 
+  fEventPDS.Swap( other.fEventPDS ); 
+  fGenRecords.Swap( other.fGenRecords ); 
+}
+
+void SLArAnalysisManager::SLArEventBuffer::SwapEvent(const Int_t ev_number, 
+    SLArMCTruth& mctruth, SLArListEventAnode& ev_anode, 
+    SLArListEventPDS& ev_pds, SLArGenRecordsVector& gen_records) 
+{
+  fEventNumber = ev_number; 
+  fMCTruth.Swap( mctruth ); 
+  fEventAnode.Swap( ev_anode ); 
+  fEventPDS.Swap( ev_pds ); 
+  fGenRecords.Swap( gen_records ); 
+}
+
 //__________________________________________________________________
 SLArAnalysisManager* SLArAnalysisManager::Instance()
 {
@@ -76,6 +174,9 @@ SLArAnalysisManager::SLArAnalysisManager(G4bool isMaster)
     fgMasterInstance = this;
     fAnaMsgr = new SLArAnalysisManagerMsgr();
   }
+  else if ( fgMasterInstance ) {
+    CopyConfigurationFromMaster();
+  }
   fgInstance = this;
 }
 
@@ -83,6 +184,7 @@ SLArAnalysisManager::SLArAnalysisManager(G4bool isMaster)
 SLArAnalysisManager::~SLArAnalysisManager()
 {
   G4cout << "Deleting SLArAnalysisManager" << G4endl;
+  WaitOutput(); 
   if (fRootFile) {
     if (fRootFile->IsOpen()) {
       fRootFile->cd();
@@ -98,56 +200,433 @@ SLArAnalysisManager::~SLArAnalysisManager()
   if (fChargeBacktrackerManager) delete fChargeBacktrackerManager;
   if (fVUVSiPMBacktrackerManager) delete fVUVSiPMBacktrackerManager;
   if (fSuperCellBacktrackerManager) delete fSuperCellBacktrackerManager;
+  ReleaseOutputStage(); 
   if (this->fIsMaster) fgMasterInstance = nullptr;
   if (fAnaMsgr) delete  fAnaMsgr; 
   fgInstance = nullptr;
   G4cout << "SLArAnalysisManager DONE" << G4endl;
 }
 
+/**
+ * @details Open the output file and create the output trees. In a
+ * multithreaded run each worker writes its events to a separate file
+ * (the output file name with the "_t<thread id>" suffix), which is
+ * registered to the master instance and merged at the end of the run
+ * (see MergeWorkerOutputs). The master only opens the output file, 
+ * the event trees are created when merging the workers' output. 
+ */
 G4bool SLArAnalysisManager::CreateFileStructure()
 {
+  const G4bool is_mt = G4Threading::IsMultithreadedApplication(); 
   G4String filepath = fOutputPath;
-  filepath.append(fOutputFileName);
-  fRootFile = new TFile(filepath, "recreate");
+  if (is_mt && !fIsMaster) {
+    G4String stem = fOutputFileName; 
+    if (G4StrUtil::ends_with(stem, ".root")) stem.erase(stem.size()-5); 
+    filepath.append( Form("%s_t%i.root", stem.data(), G4Threading::G4GetThreadId()) ); 
+  }
+  else {
+    filepath.append(fOutputFileName);
+  }
+  fRootFile = new TFile(filepath, "recreate", "", fCompressionSettings);
 
-  if (!fRootFile)
+  if (!fRootFile || fRootFile->IsZombie())
   {
     G4cout << "SLArAnalysisManager::CreateFileStructure\n" << G4endl;
     G4cout << "rootfile not created! Quit."              << G4endl;
     return false;
   }
+
+  // the events are processed by the workers in MT mode
+  fProfiler.Reset(); 
+  fProfiler.Activate( fEnableProfiling && !(is_mt && fIsMaster) ); 
+
+  if (is_mt && fIsMaster) {
+    fEventTree = nullptr; 
+    fGenTree = nullptr; 
+    fFlatOutput.SetPixelHitTree(nullptr); 
+    fFlatOutput.SetTrajectoryPointTree(nullptr); 
+#ifdef SLAR_EXTERNAL
+    fExternalsTree = nullptr;
+#endif // SLAR_EXTERNAL
+    return true;
+  }
+  // setup backtracker size
+  SetupBacktrackerRecords(); 
+
+  // bind the output trees either to the event objects or to the output buffer
+  Int_t* ev_number = &fEventNumber; 
+  SLArMCTruth* ev_mctruth = &fListMCPrimary; 
+  SLArListEventAnode* ev_anode = &fListEventAnode; 
+  SLArListEventPDS* ev_pds = &fListEventPDS; 
+  SLArGenRecordsVector* ev_gen_records = &fListGenRecords; 
+  if (SetupOutputStage()) {
+    ev_number = &fOutputBuffer->fEventNumber; 
+    ev_mctruth = &fOutputBuffer->fMCTruth; 
+    ev_anode = &fOutputBuffer->fEventAnode; 
+    ev_pds = &fOutputBuffer->fEventPDS; 
+    ev_gen_records = &fOutputBuffer->fGenRecords; 
+  }
+
   fEventTree = new TTree("EventTree", "SoLAr-sim Event Tree");
   fEventTree->SetDirectory(fRootFile);
-  printf("EventTree created with AutoFlush set to %lld\n", fEventTree->GetAutoFlush());
 
-  fEventTree->Branch("EvNumber", &fEventNumber, "EvNumber/I");
+  fEventTree->Branch("EvNumber", ev_number, "EvNumber/I");
 
   if (fEnableMCTruthOutput) {
-    fEventTree->Branch("MCTruth", &fListMCPrimary);
+    fEventTree->Branch("MCTruth", ev_mctruth, fBasketSize, fSplitLevel);
   }
 
   if (fEnableEventAnodeOutput) {
-    fEventTree->Branch("EventAnode", &fListEventAnode);
+    fEventTree->Branch("EventAnode", ev_anode, fBasketSize, fSplitLevel);
   }
 
   if (fEnableEventPDSOutput) {
-    fEventTree->Branch("EventPDS", &fListEventPDS);
+    fEventTree->Branch("EventPDS", ev_pds, fBasketSize, fSplitLevel);
   }
+  ApplyOutputTuning(fEventTree); 
+  printf("EventTree created with AutoFlush set to %lld\n", fEventTree->GetAutoFlush());
 
   if (fEnableGenTreeOutput) {
     fGenTree = new TTree("GenTree", "SoLAr-sim Gen Tree");
     fGenTree->SetDirectory(fRootFile);
-    fGenTree->Branch("GenRecords", &fListGenRecords); 
+    fGenTree->Branch("GenRecords", ev_gen_records, fBasketSize, fSplitLevel); 
+    ApplyOutputTuning(fGenTree); 
     printf("GenRecords tree created with AutoFlush set to %lld\n", fGenTree->GetAutoFlush());
   }
 
-  // setup backtracker size
-  SetupBacktrackerRecords(); 
+  if (fEnableFlatOutput) {
+    fFlatOutput.CreateTrees(fRootFile); 
+    ApplyOutputTuning(fFlatOutput.GetPixelHitTree()); 
+    ApplyOutputTuning(fFlatOutput.GetTrajectoryPointTree()); 
+  }
+  else {
+    fFlatOutput.SetPixelHitTree(nullptr); 
+    fFlatOutput.SetTrajectoryPointTree(nullptr); 
+  }
 
 #ifdef SLAR_EXTERNAL
   SetupExternalsTree(); 
 #endif // SLAR_EXTERNAL
 
+  if (is_mt && fgMasterInstance) fgMasterInstance->RegisterWorkerOutput(filepath); 
+
+  return true;
+}
+
+/**
+ * @details Allocate the buffers used by the output stage and start the
+ * writer. In kAsyncOutput mode a ring of fOutputQueueDepth event buffers
+ * is handed over to a background I/O thread; in kTaskOutput mode a 
+ * single buffer is written by a task of the G4TaskRunManager pool 
+ * (if not available, the events are written synchronously).
+ *
+ * @return true if the output stage is active
+ */
+G4bool SLArAnalysisManager::SetupOutputStage()
+{
+  ReleaseOutputStage(); 
+  if (fOutputMode == kSyncOutput) return false;
+
+#ifdef SLAR_EXTERNAL
+  // the ExternalTree is filled during the event: keep all the trees on the same thread
+  printf("SLArAnalysisManager::SetupOutputStage WARNING: output stage not available in SLAR_EXTERNAL mode. Writing events synchronously.\n"); 
+  return false;
+#endif // SLAR_EXTERNAL
+
+  if (fOutputMode == kAsyncOutput) {
+    // the I/O thread fills the trees of this thread's output file
+    ROOT::EnableThreadSafety(); 
+
+    fOutputBuffer = new SLArEventBuffer(fListEventAnode, fListEventPDS); 
+    fBufferPrototype = new SLArEventBuffer(fListEventAnode, fListEventPDS); 
+    const G4int depth = std::max(fOutputQueueDepth, 1); 
+    for (G4int i = 0; i < depth; i++) {
+      fBufferPool.push_back( new SLArEventBuffer(*fBufferPrototype) ); 
+      fFreeBuffers.push_back( fBufferPool.back() ); 
+    }
+    fStopWriter = false; 
+    fWriterBusy = false; 
+    fOutputStalls = 0; 
+    fOutputWriter = new std::thread(&SLArAnalysisManager::OutputWriterLoop, this); 
+    return true;
+  }
+
+#ifdef G4MULTITHREADED
+  auto task_rm = G4TaskRunManager::GetMasterRunManager(); 
+  if (task_rm && task_rm->GetThreadPool()) {
+    fOutputTaskGroup = new G4TaskGroup<void>( task_rm->GetThreadPool() ); 
+    fOutputBuffer = new SLArEventBuffer(fListEventAnode, fListEventPDS); 
+    fWriterBusy = false; 
+    fOutputStalls = 0; 
+    return true;
+  }
+#endif
+
+  printf("SLArAnalysisManager::SetupOutputStage WARNING: output task requires the task-based run manager. Writing events synchronously.\n"); 
+  return false;
+}
+
+void SLArAnalysisManager::ReleaseOutputStage()
+{
+  WaitOutput(); 
+
+  if (fOutputWriter) {
+    {
+      std::lock_guard<std::mutex> lock(fOutputMutex); 
+      fStopWriter = true; 
+    }
+    fOutputCondition.notify_all(); 
+    fOutputWriter->join(); 
+    delete fOutputWriter; fOutputWriter = nullptr;
+    printf("SLArAnalysisManager: %ld event(s) waited for a free output buffer (%lu buffers)\n", 
+        fOutputStalls, fBufferPool.size()); 
+  }
+#ifdef G4MULTITHREADED
+  if (fOutputTaskGroup) {
+    printf("SLArAnalysisManager: %ld event(s) waited for the output task\n", fOutputStalls); 
+    delete fOutputTaskGroup; fOutputTaskGroup = nullptr;
+  }
+  fOutputTaskClaim.reset(); 
+#endif
+
+  for (auto& buffer : fBufferPool) delete buffer;
+  fBufferPool.clear(); 
+  fFreeBuffers.clear(); 
+  fFilledBuffers.clear(); 
+  if (fBufferPrototype) {delete fBufferPrototype; fBufferPrototype = nullptr;}
+  if (fOutputBuffer) {delete fOutputBuffer; fOutputBuffer = nullptr;}
+  return;
+}
+
+/**
+ * @details Main loop of the background I/O thread. The oldest filled 
+ * buffer is swapped with the one bound to the output trees and given 
+ * back to the simulation before finalizing and writing the event, so 
+ * that the simulation only waits when all buffers are queued. 
+ */
+void SLArAnalysisManager::OutputWriterLoop()
+{
+  while (true) {
+    SLArEventBuffer* buffer = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(fOutputMutex); 
+      fOutputCondition.wait(lock, [this]() {return fStopWriter || !fFilledBuffers.empty();}); 
+      if (fFilledBuffers.empty()) break;
+      buffer = fFilledBuffers.front(); 
+      fFilledBuffers.pop_front(); 
+      fWriterBusy = true;
+    }
+
+    fOutputBuffer->Swap( *buffer ); 
+    {
+      std::lock_guard<std::mutex> lock(fOutputMutex); 
+      fFreeBuffers.push_back( buffer ); 
+    }
+    fOutputCondition.notify_all(); 
+
+    WriteOutputBuffer(); 
+
+    {
+      std::lock_guard<std::mutex> lock(fOutputMutex); 
+      fWriterBusy = false;
+    }
+    fOutputCondition.notify_all(); 
+  }
+  return;
+}
+
+/**
+ * @details Copy the readout configuration and the physics biasing
+ * setup from the master instance and create the event structure. 
+ * Called when the analysis manager of a worker thread is created, 
+ * i.e. after the geometry has been built by the master. 
+ */
+void SLArAnalysisManager::CopyConfigurationFromMaster()
+{
+  if (fIsMaster || fgMasterInstance == nullptr) return;
+
+  // cloning the TH2Poly readout maps touches the ROOT global state
+  G4AutoLock lock(&anaMgrMutex); 
+  fSeed = fgMasterInstance->fSeed; 
+  fBiasing = fgMasterInstance->fBiasing; 
+  fPDSysCfg = SLArCfgSystemSuperCell(fgMasterInstance->fPDSysCfg); 
+  fAnodeCfg.clear(); 
+  for (const auto& anode_cfg : fgMasterInstance->fAnodeCfg) {
+    fAnodeCfg.insert(std::make_pair(anode_cfg.first, SLArCfgAnode(anode_cfg.second))); 
+  }
+  lock.unlock(); 
+  if (fgMasterInstance->fCfgIndexFrozen) BuildCfgIndexTables(); 
+
+  CreateEventStructure(); 
+  return;
+}
+
+/**
+ * @details Copy the output and readout settings from the master instance. 
+ * The analysis manager messenger only exists on the master, so the 
+ * settings given via UI commands are propagated to the workers at the 
+ * beginning of each run. 
+ */
+void SLArAnalysisManager::CopySettingsFromMaster()
+{
+  if (fIsMaster || fgMasterInstance == nullptr) return;
+  const SLArAnalysisManager* master = fgMasterInstance;
+
+  fOutputPath = master->fOutputPath; 
+  fOutputFileName = master->fOutputFileName; 
+  fTrajectoryFull = master->fTrajectoryFull; 
+  fTrjPointPolicy = master->fTrjPointPolicy; 
+  fTrjPointTolerance = master->fTrjPointTolerance; 
+  fEnableMCTruthOutput = master->fEnableMCTruthOutput; 
+  fEnableEventAnodeOutput = master->fEnableEventAnodeOutput; 
+  fEnableEventPDSOutput = master->fEnableEventPDSOutput; 
+  fEnableGenTreeOutput = master->fEnableGenTreeOutput; 
+  fEnableFlatOutput = master->fEnableFlatOutput; 
+  fEnableProfiling = master->fEnableProfiling; 
+  fEnableDirectPhotonHits = master->fEnableDirectPhotonHits; 
+  fOutputMode = master->fOutputMode; 
+  fOutputQueueDepth = master->fOutputQueueDepth; 
+  fOutputBackPressure = master->fOutputBackPressure; 
+  fCompressionSettings = master->fCompressionSettings; 
+  fAutoFlush = master->fAutoFlush; 
+  fAutoSave = master->fAutoSave; 
+  fSplitLevel = master->fSplitLevel; 
+  fBasketSize = master->fBasketSize; 
+  fBranchBasketSize = master->fBranchBasketSize; 
+
+  // backtrackers
+  for (const auto& isys : {backtracker::kCharge, backtracker::kVUVSiPM, backtracker::kSuperCell}) {
+    const auto master_bkt_mgr = fgMasterInstance->GetBacktrackerManager(isys); 
+    if (master_bkt_mgr == nullptr || GetBacktrackerManager(isys) != nullptr) continue;
+    ConstructBacktracker(isys); 
+    GetBacktrackerManager(isys)->CloneBacktrackers(*master_bkt_mgr); 
+  }
+
+  // charge readout settings
+  const auto& master_anodes = master->fListEventAnode.GetConstAnodeMap(); 
+  for (auto& evAnode : fListEventAnode.GetAnodeMap()) {
+    const auto itr = master_anodes.find(evAnode.first); 
+    if (itr == master_anodes.end()) continue;
+    evAnode.second.SetZeroSuppressionThreshold( itr->second.GetZeroSuppressionThreshold() ); 
+    evAnode.second.SetHitStoragePolicy( itr->second.GetHitStoragePolicy() ); 
+  }
+  for (auto& anode_cfg : fAnodeCfg) {
+    const auto itr = master->fAnodeCfg.find(anode_cfg.first); 
+    if (itr == master->fAnodeCfg.end()) continue;
+    anode_cfg.second.SetUsePixelLookup( itr->second.UsePixelLookup() ); 
+  }
+
+  // sensitive detectors disabled via UI command
+  auto sd_mgr = G4SDManager::GetSDMpointerIfExist(); 
+  if (sd_mgr) {
+    for (const auto& sd_name : master->fDisabledSD) {
+      auto sd = sd_mgr->FindSensitiveDetector(sd_name, false); 
+      if (sd) sd->Activate( false ); 
+    }
+  }
+
+  return;
+}
+
+void SLArAnalysisManager::RegisterWorkerOutput(const G4String& filepath)
+{
+  G4AutoLock lock(&anaMgrMutex); 
+  fWorkerOutputs.push_back(filepath); 
+  return;
+}
+
+/**
+ * @details Merge the output files of the worker threads in the master
+ * output file. The EventTree entries are sorted by event number, so
+ * that the merged file does not depend on the scheduling of the events
+ * among the threads, and the GenTree entries follow the same order. 
+ * Configuration strings only written by the workers (e.g. the generator
+ * configuration) are copied to the master file. The workers' files are 
+ * deleted unless /SLAr/manager/keepWorkerOutput is set. 
+ */
+G4bool SLArAnalysisManager::MergeWorkerOutputs()
+{
+  if (!fIsMaster || fWorkerOutputs.empty()) return false;
+  if (!fRootFile || !fRootFile->IsOpen()) {
+    printf("SLArAnalysisManager::MergeWorkerOutputs ERROR: output file is not open. Cannot merge.\n"); 
+    return false;
+  }
+
+  std::vector<TFile*> inputs; 
+  for (const auto& path : fWorkerOutputs) {
+    TFile* file = TFile::Open(path, "read"); 
+    if (file == nullptr || file->IsZombie()) {
+      printf("SLArAnalysisManager::MergeWorkerOutputs WARNING: cannot open %s. Skip.\n", path.data());
+      delete file; 
+      continue;
+    }
+    inputs.push_back(file); 
+  }
+
+  std::vector<SLArMergeEntry_t> ev_order; 
+  G4bool gen_aligned = true;
+  for (size_t i = 0; i < inputs.size(); i++) {
+    TTree* ev_tree = inputs[i]->Get<TTree>("EventTree"); 
+    if (ev_tree == nullptr) continue;
+    Int_t ev_number = 0;
+    TBranch* b_ev_number = ev_tree->GetBranch("EvNumber"); 
+    b_ev_number->SetAddress(&ev_number); 
+    for (Long64_t j = 0; j < ev_tree->GetEntries(); j++) {
+      b_ev_number->GetEntry(j); 
+      ev_order.push_back({ev_number, i, j}); 
+    }
+    ev_tree->ResetBranchAddresses(); 
+
+    TTree* gen_tree = inputs[i]->Get<TTree>("GenTree"); 
+    if (gen_tree && gen_tree->GetEntries() != ev_tree->GetEntries()) gen_aligned = false;
+  }
+
+  std::stable_sort(ev_order.begin(), ev_order.end(), 
+      [](const SLArMergeEntry_t& a, const SLArMergeEntry_t& b) {
+        return a.fEvNumber < b.fEvNumber;
+      }); 
+
+  fEventTree = merge_tree("EventTree", inputs, ev_order, fRootFile); 
+  fGenTree = merge_tree("GenTree", inputs, 
+      gen_aligned ? ev_order : sequential_order(inputs, "GenTree"), fRootFile); 
+#ifdef SLAR_EXTERNAL
+  fExternalsTree = merge_tree("ExternalTree", inputs, 
+      sequential_order(inputs, "ExternalTree"), fRootFile); 
+#endif // SLAR_EXTERNAL
+  // flat trees carry the event number in each row: keep the workers' order
+  fFlatOutput.SetPixelHitTree( merge_tree("PixelHitTree", inputs, 
+        sequential_order(inputs, "PixelHitTree"), fRootFile) ); 
+  fFlatOutput.SetTrajectoryPointTree( merge_tree("TrajectoryPointTree", inputs, 
+        sequential_order(inputs, "TrajectoryPointTree"), fRootFile) ); 
+  fProfiler.SetProfileTree( merge_tree("ProfileTree", inputs, 
+        sequential_order(inputs, "ProfileTree"), fRootFile) ); 
+
+  if (!inputs.empty()) {
+    TIter next(inputs.front()->GetListOfKeys()); 
+    TKey* key = nullptr;
+    while ( (key = (TKey*)next()) ) {
+      if (strcmp(key->GetClassName(), "TObjString") != 0) continue;
+      if (fRootFile->GetListOfKeys()->FindObject(key->GetName())) continue;
+      TObject* obj = key->ReadObj(); 
+      fRootFile->cd(); 
+      obj->Write(key->GetName()); 
+      delete obj;
+    }
+  }
+
+  printf("SLArAnalysisManager::MergeWorkerOutputs: merged %lu events from %lu files\n", 
+      ev_order.size(), inputs.size()); 
+
+  for (auto& file : inputs) {
+    file->Close(); 
+    delete file;
+  }
+
+  if (!fKeepWorkerOutput) {
+    for (const auto& path : fWorkerOutputs) std::remove(path.data()); 
+  }
+  fWorkerOutputs.clear(); 
+
   return true;
 }
 
@@ -178,6 +657,8 @@ G4bool SLArAnalysisManager::CreateEventStructure()
 
 G4bool SLArAnalysisManager::Save()
 {
+  WaitOutput(); 
+
   if (!fRootFile) return false;
 
   auto write_tree = [&](TTree* t) {
@@ -193,26 +674,45 @@ G4bool SLArAnalysisManager::Save()
 
   write_tree(fEventTree);
   write_tree(fGenTree);
+  write_tree(fFlatOutput.GetPixelHitTree());
+  write_tree(fFlatOutput.GetTrajectoryPointTree());
 #ifdef SLAR_EXTERNAL
   write_tree(fExternalsTree);
 #endif // SLAR_EXTERNAL
+  if (fProfiler.IsEnabled()) {
+    fProfiler.FillProfileTree(fRootFile); 
+    fProfiler.PrintSummary(); 
+  }
+  write_tree(fProfiler.GetProfileTree());
 
   WriteSysCfg(); 
 
   fRootFile->Close();
 
+  ReleaseOutputStage(); 
+
   return true;
 }
 
 
 G4bool SLArAnalysisManager::LoadPDSCfg(SLArCfgSystemSuperCell& pdsCfg)
 {
+  if (fCfgIndexFrozen) {
+    printf("SLArAnalysisManager::LoadPDSCfg WARNING "); 
+    printf("the readout configuration index tables are frozen. skip.\n");
+    return false;
+  }
   fPDSysCfg = SLArCfgSystemSuperCell(pdsCfg);
   return true;
 }
 
 G4bool SLArAnalysisManager::LoadAnodeCfg(SLArCfgAnode& anodeCfg)
 {
+  if (fCfgIndexFrozen) {
+    printf("SLArAnalysisManager::LoadAnodeCfg WARNING "); 
+    printf("the readout configuration index tables are frozen. skip.\n");
+    return false;
+  }
   if (fAnodeCfg.count(anodeCfg.GetTPCID())) {
     printf("SLArAnalysisManager::LoadAnodeCfg WARNING "); 
     printf("an anode configuration with index %i is already registered. skip.\n",
@@ -225,8 +725,41 @@ G4bool SLArAnalysisManager::LoadAnodeCfg(SLArCfgAnode& anodeCfg)
   return true;
 }
 
+/**
+ * @details Build the dense lookup tables of the readout configuration 
+ * (anode -> megatile -> tile and SuperCell array -> SuperCell) and freeze 
+ * it. Called once the geometry is complete; the workers rebuild their 
+ * tables after copying the configuration from the master. The tables are 
+ * transient and are not written to the output file. 
+ */
+void SLArAnalysisManager::BuildCfgIndexTables()
+{
+  fPDSysCfg.BuildIndexTables(); 
+
+  fAnodeCfgByID.clear(); 
+  for (auto& anode_cfg : fAnodeCfg) {
+    auto& cfg = anode_cfg.second; 
+    cfg.BuildIndexTables(); 
+    if (cfg.GetIdx() < 0) {
+      printf("SLArAnalysisManager::BuildCfgIndexTables WARNING "); 
+      printf("anode %s has invalid index %i. skip.\n", cfg.GetName(), cfg.GetIdx());
+      continue;
+    }
+    if (static_cast<size_t>(cfg.GetIdx()) >= fAnodeCfgByID.size()) {
+      fAnodeCfgByID.resize(cfg.GetIdx() + 1, nullptr); 
+    }
+    fAnodeCfgByID[cfg.GetIdx()] = &cfg; 
+  }
+
+  fCfgIndexFrozen = true; 
+  return;
+}
+
 void SLArAnalysisManager::WriteSysCfg() 
 {
+  // the configuration is shared among threads: write it only once
+  if (!fIsMaster) return;
+
   if (!fRootFile) {
     G4cout << "SLArAnalysisManager::WriteSysCfg" << G4endl;
     G4cout << "rootfile has null ptr! Quit."   << G4endl;
@@ -252,6 +785,7 @@ G4bool SLArAnalysisManager::FillTree() {
 #ifdef SLAR_DEBUG
   printf("SLArAnalysisManager::FillTree...");
 #endif
+  SLArProfileScope profile_scope(fProfiler, SLArProfiler::kFillTree); 
 
   if (fEventTree) {
     if (fEventTree->IsZombie()) {
@@ -266,6 +800,168 @@ G4bool SLArAnalysisManager::FillTree() {
   return true;
 }
 
+/**
+ * @details Hand over the current event to the output stage. In kSyncOutput 
+ * mode the charge hits are finalized and the trees filled right away. 
+ * Otherwise the content of the event objects is swapped (without copies)
+ * with the one of an output buffer and the hit finalization, tree 
+ * filling and buffer cleanup are executed by the I/O thread (kAsyncOutput)
+ * or by a task of the G4TaskRunManager pool (kTaskOutput), overlapping 
+ * with the simulation of the next event. In kTaskOutput mode the single
+ * output buffer is guarded by the fWriterBusy flag: if the task of the 
+ * previous event is still queued it is written on the calling thread, 
+ * if it is running the call waits for its completion. 
+ *
+ * When all the buffers of the asynchronous writer are queued the call 
+ * either blocks until the I/O thread releases a buffer or allocates a
+ * new one, depending on the back-pressure policy. 
+ */
+G4bool SLArAnalysisManager::SubmitEvent()
+{
+  if (fOutputWriter) {
+    SLArEventBuffer* buffer = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(fOutputMutex); 
+      if (fFreeBuffers.empty()) {
+        fOutputStalls++; 
+        if (fOutputBackPressure == kGrowQueue) {
+          fBufferPool.push_back( new SLArEventBuffer(*fBufferPrototype) ); 
+          fFreeBuffers.push_back( fBufferPool.back() ); 
+        }
+        else {
+          fOutputCondition.wait(lock, [this]() {return !fFreeBuffers.empty();}); 
+        }
+      }
+      buffer = fFreeBuffers.front(); 
+      fFreeBuffers.pop_front(); 
+    }
+
+    buffer->SwapEvent(fEventNumber, fListMCPrimary, fListEventAnode, fListEventPDS, fListGenRecords); 
+
+    {
+      std::lock_guard<std::mutex> lock(fOutputMutex); 
+      fFilledBuffers.push_back( buffer ); 
+    }
+    fOutputCondition.notify_all(); 
+    return true;
+  }
+
+#ifdef G4MULTITHREADED
+  if (fOutputTaskGroup) {
+    // never join the task group from within the event task
+    ClaimOutputTask(); 
+    {
+      std::unique_lock<std::mutex> lock(fOutputMutex); 
+      if (fWriterBusy) {
+        fOutputStalls++; 
+        fOutputCondition.wait(lock, [this]() {return !fWriterBusy;}); 
+      }
+      fWriterBusy = true; 
+    }
+
+    fOutputBuffer->SwapEvent(fEventNumber, fListMCPrimary, fListEventAnode, fListEventPDS, fListGenRecords); 
+
+    auto claim = std::make_shared<std::atomic<G4bool>>(false); 
+    fOutputTaskClaim = claim; 
+    fOutputTaskGroup->exec( [this, claim]() {
+        if (claim->exchange(true)) return;
+        WriteOutputBuffer(); 
+        {
+          std::lock_guard<std::mutex> lock(fOutputMutex); 
+          fWriterBusy = false; 
+        }
+        fOutputCondition.notify_all(); 
+      }); 
+    return true;
+  }
+#endif
+
+  FinalizeEventAnode( fListEventAnode ); 
+  G4bool status = FillTree(); 
+  FillGenTree(); 
+  FillFlatOutput(fEventNumber, fListMCPrimary, fListEventAnode); 
+  return status;
+}
+
+void SLArAnalysisManager::WaitOutput()
+{
+  if (fOutputWriter) {
+    std::unique_lock<std::mutex> lock(fOutputMutex); 
+    fOutputCondition.wait(lock, [this]() {return fFilledBuffers.empty() && !fWriterBusy;}); 
+  }
+#ifdef G4MULTITHREADED
+  if (fOutputTaskGroup) {
+    ClaimOutputTask(); 
+    {
+      std::unique_lock<std::mutex> lock(fOutputMutex); 
+      fOutputCondition.wait(lock, [this]() {return !fWriterBusy;}); 
+    }
+    // end of run: no event task of this thread is running anymore
+    fOutputTaskGroup->join(); 
+  }
+#endif
+  return;
+}
+
+/**
+ * @details If the output task of the previous event has not been picked
+ * up by the thread pool yet, claim it and write the buffer on the calling
+ * thread, so that the event loop never waits for a task that is queued 
+ * behind event tasks blocked in the same wait. A task that is already 
+ * running is left alone: its completion is signalled by fWriterBusy. 
+ */
+void SLArAnalysisManager::ClaimOutputTask()
+{
+#ifdef G4MULTITHREADED
+  if (!fOutputTaskClaim) return;
+  auto claim = std::move(fOutputTaskClaim); 
+  if (claim->exchange(true)) return;
+
+  WriteOutputBuffer(); 
+  {
+    std::lock_guard<std::mutex> lock(fOutputMutex); 
+    fWriterBusy = false; 
+  }
+  fOutputCondition.notify_all(); 
+#endif
+  return;
+}
+
+void SLArAnalysisManager::WriteOutputBuffer()
+{
+  FinalizeEventAnode( fOutputBuffer->fEventAnode ); 
+  FillTree(); 
+  FillGenTree(); 
+  FillFlatOutput(fOutputBuffer->fEventNumber, fOutputBuffer->fMCTruth, fOutputBuffer->fEventAnode); 
+  fOutputBuffer->Reset(); 
+  return;
+}
+
+void SLArAnalysisManager::FinalizeEventAnode(SLArListEventAnode& ev_anode)
+{
+#ifndef SLAR_EXTERNAL
+  SLArProfileScope profile_scope(fProfiler, SLArProfiler::kZeroSuppression); 
+  // merge buffered hits and apply zero suppression to charge signal
+  for (auto &evAnode : ev_anode.GetAnodeMap()) {
+    evAnode.second.ConsolidateHits(); 
+    short thrs = evAnode.second.GetZeroSuppressionThreshold(); 
+    if (thrs > 0) {
+      evAnode.second.ApplyZeroSuppression();
+    }
+  }
+#endif // SLAR_EXTERNAL
+  return;
+}
+
+void SLArAnalysisManager::FillFlatOutput(const Int_t ev_number, 
+    SLArMCTruth& mc_truth, const SLArListEventAnode& ev_anode)
+{
+  if (!fEnableFlatOutput) return;
+  fFlatOutput.FillAnode(ev_number, ev_anode); 
+  fFlatOutput.FillTrajectories(ev_number, mc_truth); 
+  return;
+}
+
 G4bool SLArAnalysisManager::FillGenTree() 
 {
 #ifdef SLAR_DEBUG
@@ -390,6 +1086,174 @@ void SLArAnalysisManager::SetOutputPath(G4String path)
   }
 }
 
+/**
+ * @details Set the compression of the output file. The algorithm can 
+ * be one of "zlib", "lzma", "lz4", "zstd" or "default" (ROOT's compiled 
+ * default, the level is then ignored). Level 0 disables the compression.
+ *
+ * @param algorithm compression algorithm
+ * @param level compression level (0-9)
+ */
+G4bool SLArAnalysisManager::SetCompression(const G4String& algorithm, const G4int level) 
+{
+  G4String algo_name = algorithm; 
+  G4StrUtil::to_lower(algo_name); 
+  if (algo_name == "default") {
+    fCompressionSettings = ROOT::RCompressionSetting::EDefaults::kUseCompiledDefault; 
+    return true;
+  }
+
+  ROOT::RCompressionSetting::EAlgorithm::EValues algo = 
+    ROOT::RCompressionSetting::EAlgorithm::kUseGlobal; 
+  if (algo_name == "zlib") algo = ROOT::RCompressionSetting::EAlgorithm::kZLIB; 
+  else if (algo_name == "lzma") algo = ROOT::RCompressionSetting::EAlgorithm::kLZMA; 
+  else if (algo_name == "lz4") algo = ROOT::RCompressionSetting::EAlgorithm::kLZ4; 
+  else if (algo_name == "zstd") algo = ROOT::RCompressionSetting::EAlgorithm::kZSTD; 
+  else {
+    printf("SLArAnalysisManager::SetCompression WARNING: unknown algorithm %s (use zlib, lzma, lz4, zstd or default).\n", 
+        algorithm.data()); 
+    return false;
+  }
+
+  if (level < 0 || level > 9) {
+    printf("SLArAnalysisManager::SetCompression WARNING: compression level must be in [0, 9] (%i given).\n", 
+        level); 
+    return false;
+  }
+
+  fCompressionSettings = ROOT::CompressionSettings(algo, level); 
+  return true;
+}
+
+/**
+ * @details Set the basket size of the output branches. The branch name 
+ * can contain wildcards (as in TTree::SetBasketSize); "*" sets the 
+ * default basket size used when creating the branches. 
+ *
+ * @param branch branch name (or pattern)
+ * @param size basket size in bytes
+ */
+void SLArAnalysisManager::SetBasketSize(const G4String& branch, const G4int size) 
+{
+  if (size <= 0) {
+    printf("SLArAnalysisManager::SetBasketSize WARNING: invalid basket size %i for %s. Ignored.\n", 
+        size, branch.data()); 
+    return;
+  }
+
+  if (branch == "*") {
+    fBasketSize = size; 
+    return;
+  }
+
+  for (auto& bs : fBranchBasketSize) {
+    if (bs.first == branch) {
+      bs.second = size; 
+      return;
+    }
+  }
+  fBranchBasketSize.push_back( std::make_pair(branch, size) ); 
+  return;
+}
+
+void SLArAnalysisManager::ApplyOutputTuning(TTree* tree) 
+{
+  if (tree == nullptr) return;
+  tree->SetAutoFlush(fAutoFlush); 
+  tree->SetAutoSave(fAutoSave); 
+  for (const auto& bs : fBranchBasketSize) {
+    tree->SetBasketSize(bs.first, bs.second); 
+  }
+  return;
+}
+
+G4bool SLArAnalysisManager::LoadOutputConfig(const G4String& config_file_path) 
+{
+  if (!file_exists(config_file_path)) {
+    printf("SLArAnalysisManager::LoadOutputConfig ERROR: cannot find %s.\n", 
+        config_file_path.data()); 
+    return false;
+  }
+
+  FILE* config_file = std::fopen(config_file_path, "r"); 
+  char readBuffer[65536];
+  rapidjson::FileReadStream is(config_file, readBuffer, sizeof(readBuffer));
+
+  rapidjson::Document d; 
+  d.ParseStream<rapidjson::kParseCommentsFlag>(is);
+  std::fclose(config_file); 
+
+  if (d.HasParseError() || !d.IsObject()) {
+    printf("SLArAnalysisManager::LoadOutputConfig ERROR: cannot parse %s.\n", 
+        config_file_path.data()); 
+    return false;
+  }
+
+  if (d.HasMember("output")) return LoadOutputConfig(d["output"]); 
+  return LoadOutputConfig(d); 
+}
+
+/**
+ * @details Read the output tuning from a json block like
+ *
+ * ```
+ * "output": {
+ *   "compression": {"algorithm": "zstd", "level": 5}, 
+ *   "autoflush": -30000000, 
+ *   "autosave": -300000000, 
+ *   "split_level": 99, 
+ *   "basket_size": {"*": 32000, "EventAnode*": 256000}
+ * }
+ * ```
+ *
+ * All the fields are optional. 
+ */
+G4bool SLArAnalysisManager::LoadOutputConfig(const rapidjson::Value& config) 
+{
+  if (!config.IsObject()) {
+    printf("SLArAnalysisManager::LoadOutputConfig ERROR: output configuration must be a json object.\n"); 
+    return false;
+  }
+
+  G4bool status = true;
+  if (config.HasMember("compression")) {
+    const auto& jcomp = config["compression"]; 
+    G4String algo_name = "zlib"; 
+    G4int level = 1; 
+    if (jcomp.HasMember("algorithm")) algo_name = jcomp["algorithm"].GetString(); 
+    if (jcomp.HasMember("level")) level = jcomp["level"].GetInt(); 
+    status = SetCompression(algo_name, level) && status; 
+  }
+  if (config.HasMember("autoflush")) {
+    SetAutoFlush( config["autoflush"].GetInt64() ); 
+  }
+  if (config.HasMember("autosave")) {
+    SetAutoSave( config["autosave"].GetInt64() ); 
+  }
+  if (config.HasMember("split_level")) {
+    SetSplitLevel( config["split_level"].GetInt() ); 
+  }
+  if (config.HasMember("basket_size")) {
+    const auto& jbasket = config["basket_size"]; 
+    if (jbasket.IsInt()) {
+      SetBasketSize("*", jbasket.GetInt()); 
+    }
+    else {
+      for (const auto& jb : jbasket.GetObj()) {
+        SetBasketSize(jb.name.GetString(), jb.value.GetInt()); 
+      }
+    }
+  }
+
+  printf("SLArAnalysisManager::LoadOutputConfig: compression %i, autoflush %lld, autosave %lld, split level %i, basket size %i\n", 
+      fCompressionSettings, fAutoFlush, fAutoSave, fSplitLevel, fBasketSize); 
+  for (const auto& bs : fBranchBasketSize) {
+    printf("\tbasket size of %s: %i\n", bs.first.data(), bs.second); 
+  }
+
+  return status;
+}
+
 void SLArAnalysisManager::SetOutputName(G4String filename)
 {
   if (! G4StrUtil::contains(filename, ".root") ) filename.append(".root");
@@ -29,13 +29,26 @@ SLArAnalysisManagerMsgr::SLArAnalysisManagerMsgr() :
   fCmdGeoAnodeDepth(nullptr), 
   fCmdGeoFieldCageVis(nullptr),
   fCmdGeoCryoSupportVis(nullptr),
+  fCmdSetTrjPointPolicy(nullptr), fCmdSetTrjPointTolerance(nullptr),
   fCmdEnableMCTruthOutput(nullptr),
   fCmdEnableAnodeOutput(nullptr),
   fCmdEnablePDSOutput(nullptr),
+  fCmdEnableFlatOutput(nullptr),
+  fCmdEnableProfiling(nullptr),
+  fCmdEnableDirectPhotonHits(nullptr),
   fCmdDisableSD(nullptr),
   fCmdEnableBacktracker(nullptr),
   fCmdRegisterBacktracker(nullptr), 
   fCmdSetZeroSuppressionThrs(nullptr), 
+  fCmdSetHitStoragePolicy(nullptr), 
+  fCmdKeepWorkerOutput(nullptr), 
+  fCmdSetOutputMode(nullptr), 
+  fCmdSetOutputQueueDepth(nullptr), 
+  fCmdSetOutputBackPressure(nullptr), 
+  fCmdSetCompression(nullptr), 
+  fCmdSetAutoFlush(nullptr), fCmdSetAutoSave(nullptr), 
+  fCmdSetSplitLevel(nullptr), fCmdSetBasketSize(nullptr), 
+  fCmdLoadOutputConfig(nullptr), 
   fCmdXSecEMin(nullptr),
   fCmdXSecEMax(nullptr),
   fCmdXSecNPoints(nullptr),
@@ -83,6 +96,24 @@ SLArAnalysisManagerMsgr::SLArAnalysisManagerMsgr() :
     new G4UIcmdWithABool(UIManagerPath+"storeFullTrajectory", this);
   fCmdStoreFullTrajectory->SetGuidance("Store full track trajectory");
 
+  fCmdSetTrjPointPolicy = 
+    new G4UIcmdWithAString(UIManagerPath+"setTrajectoryPointPolicy", this);
+  fCmdSetTrjPointPolicy->SetGuidance("Select the trajectory points stored when storeFullTrajectory is on");
+  fCmdSetTrjPointPolicy->SetGuidance("all: one point per step");
+  fCmdSetTrjPointPolicy->SetGuidance("decimate: drop the points closer than the tolerance to the simplified path");
+  fCmdSetTrjPointPolicy->SetGuidance("lar: only the points in LAr");
+  fCmdSetTrjPointPolicy->SetGuidance("volume: only the first and the last point in each volume");
+  fCmdSetTrjPointPolicy->SetGuidance("(edep, n_ph and n_el of the dropped points are added to the next stored one, except for lar)");
+  fCmdSetTrjPointPolicy->SetParameterName("policy", false);
+  fCmdSetTrjPointPolicy->SetCandidates("all decimate lar volume");
+
+  fCmdSetTrjPointTolerance = 
+    new G4UIcmdWithADoubleAndUnit(UIManagerPath+"setTrajectoryPointTolerance", this);
+  fCmdSetTrjPointTolerance->SetGuidance("Set the spatial tolerance of the decimate trajectory point policy");
+  fCmdSetTrjPointTolerance->SetParameterName("tolerance", false);
+  fCmdSetTrjPointTolerance->SetRange("tolerance>=0");
+  fCmdSetTrjPointTolerance->SetDefaultUnit("mm");
+
   fCmdEnableMCTruthOutput = 
     new G4UIcmdWithABool(UIManagerPath+"enableMCTruthOutput", this);
   fCmdEnableMCTruthOutput->SetGuidance("Enable MC truth output");
@@ -95,6 +126,20 @@ SLArAnalysisManagerMsgr::SLArAnalysisManagerMsgr() :
     new G4UIcmdWithABool(UIManagerPath+"enablePDSOutput", this);
   fCmdEnablePDSOutput->SetGuidance("Enable PDS output");
 
+  fCmdEnableFlatOutput = 
+    new G4UIcmdWithABool(UIManagerPath+"enableFlatOutput", this);
+  fCmdEnableFlatOutput->SetGuidance("Enable flat (one row per pixel hit / trajectory point) output trees");
+
+  fCmdEnableProfiling = 
+    new G4UIcmdWithABool(UIManagerPath+"enableProfiling", this);
+  fCmdEnableProfiling->SetGuidance("Enable the timing and memory telemetry of the simulation");
+  fCmdEnableProfiling->SetGuidance("The per-event records are written in the ProfileTree of the output file");
+
+  fCmdEnableDirectPhotonHits = 
+    new G4UIcmdWithABool(UIManagerPath+"enableDirectPhotonHits", this);
+  fCmdEnableDirectPhotonHits->SetGuidance("Register the photon hits of the readout tiles and SuperCells");
+  fCmdEnableDirectPhotonHits->SetGuidance("directly in the output event, bypassing the Geant4 hits collections");
+
   fCmdDisableSD = 
     new G4UIcmdWithAString(UIManagerPath+"disableSD", this);
   fCmdDisableSD->SetGuidance("Disable sensitive detector");
@@ -118,6 +163,77 @@ SLArAnalysisManagerMsgr::SLArAnalysisManagerMsgr() :
   fCmdSetZeroSuppressionThrs->SetGuidance("Set charge readout zero suppression threshold");
   fCmdSetZeroSuppressionThrs->SetParameterName("threshold", false);
 
+  fCmdSetHitStoragePolicy = 
+    new G4UIcmdWithAString(UIManagerPath+"setHitStoragePolicy", this);
+  fCmdSetHitStoragePolicy->SetGuidance("Set storage policy for anode tile and pixel hits");
+  fCmdSetHitStoragePolicy->SetGuidance("map: count hits directly in the clock map");
+  fCmdSetHitStoragePolicy->SetGuidance("buffer: append hits to a flat buffer merged at the end of the event");
+  fCmdSetHitStoragePolicy->SetParameterName("policy", false);
+  fCmdSetHitStoragePolicy->SetCandidates("map buffer");
+
+  fCmdKeepWorkerOutput = 
+    new G4UIcmdWithABool(UIManagerPath+"keepWorkerOutput", this);
+  fCmdKeepWorkerOutput->SetGuidance("Keep the per-thread output files after merging (MT mode only)");
+  fCmdKeepWorkerOutput->SetParameterName("keep", false, true);
+
+  fCmdSetOutputMode = 
+    new G4UIcmdWithAString(UIManagerPath+"setOutputMode", this);
+  fCmdSetOutputMode->SetGuidance("Set how events are written to the output trees");
+  fCmdSetOutputMode->SetGuidance("sync: zero suppression and tree filling at the end of each event");
+  fCmdSetOutputMode->SetGuidance("task: zero suppression and tree filling in a separate task (task-based run manager only)");
+  fCmdSetOutputMode->SetGuidance("async: zero suppression and tree filling in a background I/O thread");
+  fCmdSetOutputMode->SetParameterName("mode", false);
+  fCmdSetOutputMode->SetCandidates("sync task async");
+
+  fCmdSetOutputQueueDepth = 
+    new G4UIcmdWithAnInteger(UIManagerPath+"setOutputQueueDepth", this);
+  fCmdSetOutputQueueDepth->SetGuidance("Set the number of event buffers of the asynchronous writer");
+  fCmdSetOutputQueueDepth->SetParameterName("depth", false);
+  fCmdSetOutputQueueDepth->SetRange("depth>0");
+
+  fCmdSetOutputBackPressure = 
+    new G4UIcmdWithAString(UIManagerPath+"setOutputBackPressure", this);
+  fCmdSetOutputBackPressure->SetGuidance("Set the behaviour of the asynchronous writer when all buffers are queued");
+  fCmdSetOutputBackPressure->SetGuidance("block: wait for the I/O thread to release a buffer");
+  fCmdSetOutputBackPressure->SetGuidance("grow: allocate a new buffer");
+  fCmdSetOutputBackPressure->SetParameterName("policy", false);
+  fCmdSetOutputBackPressure->SetCandidates("block grow");
+
+  fCmdSetCompression = 
+    new G4UIcmdWithAString(UIManagerPath+"setCompression", this);
+  fCmdSetCompression->SetGuidance("Set the compression of the output file");
+  fCmdSetCompression->SetGuidance("[algorithm]:[level] (algorithm: zlib, lzma, lz4, zstd or default)");
+  fCmdSetCompression->SetParameterName("compression", false);
+
+  fCmdSetAutoFlush = 
+    new G4UIcmdWithAnInteger(UIManagerPath+"setAutoFlush", this);
+  fCmdSetAutoFlush->SetGuidance("Set the AutoFlush of the output trees");
+  fCmdSetAutoFlush->SetGuidance("(>0: number of entries, <0: number of bytes, see TTree::SetAutoFlush)");
+  fCmdSetAutoFlush->SetParameterName("autoflush", false);
+
+  fCmdSetAutoSave = 
+    new G4UIcmdWithAnInteger(UIManagerPath+"setAutoSave", this);
+  fCmdSetAutoSave->SetGuidance("Set the AutoSave of the output trees");
+  fCmdSetAutoSave->SetGuidance("(>0: number of entries, <0: number of bytes, see TTree::SetAutoSave)");
+  fCmdSetAutoSave->SetParameterName("autosave", false);
+
+  fCmdSetSplitLevel = 
+    new G4UIcmdWithAnInteger(UIManagerPath+"setSplitLevel", this);
+  fCmdSetSplitLevel->SetGuidance("Set the split level of the output object branches");
+  fCmdSetSplitLevel->SetParameterName("split", false);
+  fCmdSetSplitLevel->SetRange("split>=0 && split<=99");
+
+  fCmdSetBasketSize = 
+    new G4UIcmdWithAString(UIManagerPath+"setBasketSize", this);
+  fCmdSetBasketSize->SetGuidance("Set the basket size of the output branches");
+  fCmdSetBasketSize->SetGuidance("[branch]:[size in bytes] (wildcards allowed, \"*\" sets the default)");
+  fCmdSetBasketSize->SetParameterName("basket", false);
+
+  fCmdLoadOutputConfig = 
+    new G4UIcmdWithAString(UIManagerPath+"loadOutputConfig", this);
+  fCmdLoadOutputConfig->SetGuidance("Load the output file settings from a json file");
+  fCmdLoadOutputConfig->SetParameterName("config_file", false);
+
   fCmdGeoAnodeDepth = 
     new G4UIcmdWithAnInteger(UIGeometryPath+"setAnodeVisDepth", this);
   fCmdGeoAnodeDepth->SetGuidance("Set visualization depth for SoLAr anode");
@@ -180,13 +296,29 @@ SLArAnalysisManagerMsgr::~SLArAnalysisManagerMsgr()
   if (fCmdGeoFieldCageVis    ) delete fCmdGeoFieldCageVis    ; 
   if (fCmdGeoCryoSupportVis  ) delete fCmdGeoCryoSupportVis  ;
   if (fCmdStoreFullTrajectory) delete fCmdStoreFullTrajectory;
+  if (fCmdSetTrjPointPolicy  ) delete fCmdSetTrjPointPolicy  ;
+  if (fCmdSetTrjPointTolerance) delete fCmdSetTrjPointTolerance;
   if (fCmdEnableMCTruthOutput) delete fCmdEnableMCTruthOutput;
   if (fCmdEnableAnodeOutput  ) delete fCmdEnableAnodeOutput  ;
   if (fCmdEnablePDSOutput    ) delete fCmdEnablePDSOutput    ;
+  if (fCmdEnableFlatOutput   ) delete fCmdEnableFlatOutput   ;
+  if (fCmdEnableProfiling    ) delete fCmdEnableProfiling    ;
+  if (fCmdEnableDirectPhotonHits) delete fCmdEnableDirectPhotonHits;
   if (fCmdDisableSD          ) delete fCmdDisableSD          ;
   if (fCmdEnableBacktracker  ) delete fCmdEnableBacktracker  ;
   if (fCmdRegisterBacktracker) delete fCmdRegisterBacktracker;
   if (fCmdSetZeroSuppressionThrs) delete fCmdSetZeroSuppressionThrs;
+  if (fCmdSetHitStoragePolicy) delete fCmdSetHitStoragePolicy;
+  if (fCmdKeepWorkerOutput   ) delete fCmdKeepWorkerOutput   ;
+  if (fCmdSetOutputMode      ) delete fCmdSetOutputMode      ;
+  if (fCmdSetOutputQueueDepth) delete fCmdSetOutputQueueDepth;
+  if (fCmdSetOutputBackPressure) delete fCmdSetOutputBackPressure;
+  if (fCmdSetCompression     ) delete fCmdSetCompression     ;
+  if (fCmdSetAutoFlush       ) delete fCmdSetAutoFlush       ;
+  if (fCmdSetAutoSave        ) delete fCmdSetAutoSave        ;
+  if (fCmdSetSplitLevel      ) delete fCmdSetSplitLevel      ;
+  if (fCmdSetBasketSize      ) delete fCmdSetBasketSize      ;
+  if (fCmdLoadOutputConfig   ) delete fCmdLoadOutputConfig   ;
   if (fCmdAddExtScorer       ) delete fCmdAddExtScorer       ; 
   if (fCmdXSecEMin           ) delete fCmdXSecEMin           ;
   if (fCmdXSecEMax           ) delete fCmdXSecEMax           ;
@@ -259,6 +391,16 @@ void SLArAnalysisManagerMsgr::SetNewValue
   else if (cmd == fCmdStoreFullTrajectory) {
     SLArAnaMgr->SetStoreTrajectoryFull( G4UIcmdWithABool::GetNewBoolValue(newVal) );
   }
+  else if (cmd == fCmdSetTrjPointPolicy) {
+    SLArAnalysisManager::ETrjPointPolicy policy = SLArAnalysisManager::kStoreAllPoints; 
+    if (newVal == "decimate") policy = SLArAnalysisManager::kDecimatePoints; 
+    else if (newVal == "lar") policy = SLArAnalysisManager::kStoreLArPoints; 
+    else if (newVal == "volume") policy = SLArAnalysisManager::kStoreVolumeEdges; 
+    SLArAnaMgr->SetTrajectoryPointPolicy( policy ); 
+  }
+  else if (cmd == fCmdSetTrjPointTolerance) {
+    SLArAnaMgr->SetTrajectoryPointTolerance( fCmdSetTrjPointTolerance->GetNewDoubleValue(newVal) ); 
+  }
   else if (cmd == fCmdEnableMCTruthOutput) {
     SLArAnaMgr->EnableMCTruthOutput( G4UIcmdWithABool::GetNewBoolValue(newVal) );
   }
@@ -268,7 +410,21 @@ void SLArAnalysisManagerMsgr::SetNewValue
   else if (cmd == fCmdEnablePDSOutput) {
     SLArAnaMgr->EnableEventPDSOutput( G4UIcmdWithABool::GetNewBoolValue(newVal) );
   }
+  else if (cmd == fCmdEnableFlatOutput) {
+    SLArAnaMgr->EnableFlatOutput( G4UIcmdWithABool::GetNewBoolValue(newVal) );
+  }
+  else if (cmd == fCmdEnableProfiling) {
+    SLArAnaMgr->EnableProfiling( G4UIcmdWithABool::GetNewBoolValue(newVal) );
+  }
+  else if (cmd == fCmdEnableDirectPhotonHits) {
+    SLArAnaMgr->EnableDirectPhotonHits( G4UIcmdWithABool::GetNewBoolValue(newVal) );
+  }
   else if (cmd == fCmdDisableSD) {
+    // in MT mode the SDs only exist on the worker threads, where they
+    // are disabled at the beginning of the run
+    SLArAnaMgr->RegisterDisabledSD(newVal); 
+    if (G4Threading::IsMultithreadedApplication()) return;
+
     auto SDman = G4SDManager::GetSDMpointer();
     auto sd = SDman->FindSensitiveDetector(newVal, true);
 
@@ -337,6 +493,74 @@ void SLArAnalysisManagerMsgr::SetNewValue
       anode_itr.second.SetZeroSuppressionThreshold( thrs ); 
     }
   }
+  else if (cmd == fCmdSetHitStoragePolicy) {
+    EHitStoragePolicy policy = kMapStorage; 
+    if (newVal == "buffer") policy = kBufferedStorage; 
+    for (auto& anode_itr : SLArAnaMgr->GetEventAnode().GetAnodeMap()) {
+      anode_itr.second.SetHitStoragePolicy( policy ); 
+    }
+  }
+  else if (cmd == fCmdKeepWorkerOutput) {
+    SLArAnaMgr->SetKeepWorkerOutput( G4UIcmdWithABool::GetNewBoolValue(newVal) ); 
+  }
+  else if (cmd == fCmdSetOutputMode) {
+    SLArAnalysisManager::EOutputMode mode = SLArAnalysisManager::kSyncOutput; 
+    if (newVal == "task") mode = SLArAnalysisManager::kTaskOutput; 
+    else if (newVal == "async") mode = SLArAnalysisManager::kAsyncOutput; 
+    SLArAnaMgr->SetOutputMode( mode ); 
+  }
+  else if (cmd == fCmdSetOutputQueueDepth) {
+    SLArAnaMgr->SetOutputQueueDepth( fCmdSetOutputQueueDepth->GetNewIntValue(newVal) ); 
+  }
+  else if (cmd == fCmdSetOutputBackPressure) {
+    SLArAnalysisManager::EOutputBackPressure bp = SLArAnalysisManager::kBlockOnFullQueue; 
+    if (newVal == "grow") bp = SLArAnalysisManager::kGrowQueue; 
+    SLArAnaMgr->SetOutputBackPressure( bp ); 
+  }
+  else if (cmd == fCmdSetCompression) {
+    std::stringstream input(newVal); 
+    G4String temp;
+
+    G4String _algorithm; 
+    G4int _level = 1;
+
+    G4int ifield = 0;
+    while ( getline(input, temp, ':') ) {
+      if (ifield == 0) _algorithm = temp;
+      else if (ifield == 1) _level = std::atoi(temp);
+      ifield++;
+    }
+
+    SLArAnaMgr->SetCompression(_algorithm, _level); 
+  }
+  else if (cmd == fCmdSetAutoFlush) {
+    SLArAnaMgr->SetAutoFlush( fCmdSetAutoFlush->GetNewIntValue(newVal) ); 
+  }
+  else if (cmd == fCmdSetAutoSave) {
+    SLArAnaMgr->SetAutoSave( fCmdSetAutoSave->GetNewIntValue(newVal) ); 
+  }
+  else if (cmd == fCmdSetSplitLevel) {
+    SLArAnaMgr->SetSplitLevel( fCmdSetSplitLevel->GetNewIntValue(newVal) ); 
+  }
+  else if (cmd == fCmdSetBasketSize) {
+    std::stringstream input(newVal); 
+    G4String temp;
+
+    G4String _branch; 
+    G4int _size = 0;
+
+    G4int ifield = 0;
+    while ( getline(input, temp, ':') ) {
+      if (ifield == 0) _branch = temp;
+      else if (ifield == 1) _size = std::atoi(temp);
+      ifield++;
+    }
+
+    SLArAnaMgr->SetBasketSize(_branch, _size); 
+  }
+  else if (cmd == fCmdLoadOutputConfig) {
+    SLArAnaMgr->LoadOutputConfig(newVal); 
+  }
   else if (cmd == fCmdXSecEMin) {
     SLArAnaMgr->SetXSecEmin(fCmdXSecEMin->GetNewDoubleValue(newVal));
   }
@@ -27,7 +27,7 @@ G4bool SLArBacktrackerManager::RegisterBacktracker(SLArBacktracker* bkt) {
 
 G4bool SLArBacktrackerManager::RegisterBacktracker(const EBacktracker id, const G4String name) {
   G4bool status = false;
-  G4String bkt_name = "";
+  G4String bkt_name = name;
 
   switch (id) {
     case kTrkID:
@@ -71,6 +71,33 @@ G4bool SLArBacktrackerManager::RegisterBacktracker(const EBacktracker id, const
   return status;
 }
 
+/**
+ * @details Register in this manager a new instance of each backtracker
+ * registered in the given manager, preserving order and names. Used to
+ * replicate on the worker threads the backtrackers configured on the master.
+ *
+ * @param other backtracker manager to be replicated
+ */
+G4bool SLArBacktrackerManager::CloneBacktrackers(const SLArBacktrackerManager& other) {
+  G4bool status = true;
+  for (const auto& bkt : other.GetConstBacktrackers()) {
+    EBacktracker id = kNoBacktracker;
+    if (dynamic_cast<const SLArBacktrackerTrkID*>(bkt)) id = kTrkID;
+    else if (dynamic_cast<const SLArBacktrackerAncestorID*>(bkt)) id = kAncestorID;
+    else if (dynamic_cast<const SLArBacktrackerOpticalProcess*>(bkt)) id = kOpticalProc;
+    else if (dynamic_cast<const SLArBacktrackerSiPMNr*>(bkt)) id = kSiPMNr;
+
+    if (id == kNoBacktracker) {
+      printf("SLArBacktrackerManager::CloneBacktrackers WARNING: unknown backtracker %s. Skip.\n", 
+          bkt->GetName().data());
+      status = false;
+      continue;
+    }
+    status = RegisterBacktracker(id, bkt->GetName()) && status;
+  }
+  return status;
+}
+
 G4bool SLArBacktrackerManager::IsNull() const {
   if (fBacktrackers.empty()) return true;
   else return false;
@@ -0,0 +1,124 @@
+/**
+ * @author      Daniele Guffanti (daniele.guffanti@mib.infn.it)
+ * @file        SLArFlatOutput.cc
+ * @created     Saturday Oct 17, 2026 18:14:09 CEST
+ */
+
+#include "SLArFlatOutput.hh"
+
+SLArFlatOutput::SLArFlatOutput()
+  : fPixelHitTree(nullptr), fTrjPointTree(nullptr), fPixelRow{}, fTrjPointRow{}
+{}
+
+/**
+ * @details Create the flat trees in the given file and bind the
+ * scalar branches to the row buffers.
+ */
+void SLArFlatOutput::CreateTrees(TFile* file)
+{
+  fPixelHitTree = new TTree("PixelHitTree", "SoLAr-sim pixel hits (flat)");
+  fPixelHitTree->SetDirectory(file);
+  fPixelHitTree->Branch("iEv", &fPixelRow.fEvNumber, "iEv/I");
+  fPixelHitTree->Branch("anode", &fPixelRow.fAnode, "anode/I");
+  fPixelHitTree->Branch("megatile", &fPixelRow.fMegaTile, "megatile/I");
+  fPixelHitTree->Branch("tile", &fPixelRow.fTile, "tile/I");
+  fPixelHitTree->Branch("pixel", &fPixelRow.fPixel, "pixel/I");
+  fPixelHitTree->Branch("tick", &fPixelRow.fTick, "tick/I");
+  fPixelHitTree->Branch("time", &fPixelRow.fTime, "time/F");
+  fPixelHitTree->Branch("count", &fPixelRow.fCount, "count/s");
+
+  fTrjPointTree = new TTree("TrajectoryPointTree", "SoLAr-sim trajectory points (flat)");
+  fTrjPointTree->SetDirectory(file);
+  fTrjPointTree->Branch("iEv", &fTrjPointRow.fEvNumber, "iEv/I");
+  fTrjPointTree->Branch("primaryID", &fTrjPointRow.fPrimaryID, "primaryID/I");
+  fTrjPointTree->Branch("trkID", &fTrjPointRow.fTrkID, "trkID/I");
+  fTrjPointTree->Branch("parentID", &fTrjPointRow.fParentID, "parentID/I");
+  fTrjPointTree->Branch("pdgID", &fTrjPointRow.fPDGCode, "pdgID/I");
+  fTrjPointTree->Branch("point", &fTrjPointRow.fPoint, "point/I");
+  fTrjPointTree->Branch("x", &fTrjPointRow.fX, "x/F");
+  fTrjPointTree->Branch("y", &fTrjPointRow.fY, "y/F");
+  fTrjPointTree->Branch("z", &fTrjPointRow.fZ, "z/F");
+  fTrjPointTree->Branch("kenergy", &fTrjPointRow.fKEnergy, "kenergy/F");
+  fTrjPointTree->Branch("edep", &fTrjPointRow.fEdep, "edep/F");
+  fTrjPointTree->Branch("n_ph", &fTrjPointRow.fNph, "n_ph/I");
+  fTrjPointTree->Branch("n_el", &fTrjPointRow.fNel, "n_el/I");
+  fTrjPointTree->Branch("copy", &fTrjPointRow.fCopy, "copy/I");
+  fTrjPointTree->Branch("lar", &fTrjPointRow.fLAr, "lar/O");
+  return;
+}
+
+/**
+ * @details Write one row for each non-empty clock tick of each pixel.
+ * The time column is the start of the clock tick (tick × clock unit).
+ *
+ * @return number of rows written
+ */
+size_t SLArFlatOutput::FillAnode(const Int_t ev_number, const SLArListEventAnode& ev_anode)
+{
+  if (fPixelHitTree == nullptr) return 0;
+
+  size_t n_rows = 0;
+  fPixelRow.fEvNumber = ev_number;
+  for (const auto& anode_itr : ev_anode.GetConstAnodeMap()) {
+    fPixelRow.fAnode = anode_itr.first;
+    for (const auto& mt_itr : anode_itr.second.GetConstMegaTilesMap()) {
+      fPixelRow.fMegaTile = mt_itr.first;
+      for (const auto& t_itr : mt_itr.second.GetConstTileMap()) {
+        fPixelRow.fTile = t_itr.first;
+        for (const auto& p_itr : t_itr.second.GetConstPixelEvents()) {
+          const auto& pix = p_itr.second;
+          fPixelRow.fPixel = p_itr.first;
+          for (const auto& qhit : pix.GetConstHits()) {
+            fPixelRow.fTick = qhit.first;
+            fPixelRow.fTime = qhit.first * pix.GetClockUnit();
+            fPixelRow.fCount = qhit.second;
+            fPixelHitTree->Fill();
+            n_rows++;
+          }
+        }
+      }
+    }
+  }
+
+  return n_rows;
+}
+
+/**
+ * @details Write one row for each point of the trajectories stored
+ * in the MC truth.
+ *
+ * @return number of rows written
+ */
+size_t SLArFlatOutput::FillTrajectories(const Int_t ev_number, SLArMCTruth& mc_truth)
+{
+  if (fTrjPointTree == nullptr) return 0;
+
+  size_t n_rows = 0;
+  fTrjPointRow.fEvNumber = ev_number;
+  for (const auto& primary : mc_truth.GetPrimaries()) {
+    fTrjPointRow.fPrimaryID = primary.GetTrackID();
+    for (const auto& trj : primary.GetConstTrajectories()) {
+      fTrjPointRow.fTrkID = trj->GetTrackID();
+      fTrjPointRow.fParentID = trj->GetParentID();
+      fTrjPointRow.fPDGCode = trj->GetPDGID();
+      Int_t ipoint = 0;
+      for (const auto& p : trj->GetConstPoints()) {
+        fTrjPointRow.fPoint = ipoint++;
+        fTrjPointRow.fX = p.fX;
+        fTrjPointRow.fY = p.fY;
+        fTrjPointRow.fZ = p.fZ;
+        fTrjPointRow.fKEnergy = p.fKEnergy;
+        fTrjPointRow.fEdep = p.fEdep;
+        fTrjPointRow.fNph = p.fNph;
+        fTrjPointRow.fNel = p.fNel;
+        fTrjPointRow.fCopy = p.fCopy;
+        fTrjPointRow.fLAr = p.fLAr;
+        fTrjPointTree->Fill();
+        n_rows++;
+      }
+    }
+  }
+
+  return n_rows;
+}
+
@@ -0,0 +1,210 @@
+/**
+ * @author      Daniele Guffanti (daniele.guffanti@mib.infn.it)
+ * @file        SLArProfiler.cc
+ * @created     Saturday Oct 17, 2026 22:52:08 CEST
+ */
+
+#include <cstdio>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#include "SLArProfiler.hh"
+#include "TString.h"
+
+#include "G4Threading.hh"
+
+G4ThreadLocal SLArProfiler* SLArProfiler::fgActive = nullptr;
+
+namespace {
+  const char* section_names[SLArProfiler::kNSections] = {
+    "LArSD", "ReadoutTileSD", "SuperCellSD", "ExtScorerSD", "ElectronDrift",
+    "Scintillation", "Stacking", "Backtracker", "ZeroSuppression", "FillTree"
+  };
+
+  const char* counter_names[SLArProfiler::kNCounters] = {
+    "NTrajectories", "NChargeHits", "NPhotonHits"
+  };
+}
+
+SLArProfiler::SLArProfiler()
+  : fEnabled(false), fEventStartTime{}, fEventStartCalls{}, fEventCounts{},
+    fProfileTree(nullptr)
+{
+  for (auto& t : fTotalTime) t = 0;
+  for (auto& n : fTotalCalls) n = 0;
+}
+
+SLArProfiler::~SLArProfiler()
+{
+  if (fgActive == this) fgActive = nullptr;
+}
+
+const char* SLArProfiler::GetSectionName(const ESection section)
+{
+  return (section < kNSections) ? section_names[section] : "";
+}
+
+const char* SLArProfiler::GetCounterName(const ECounter counter)
+{
+  return (counter < kNCounters) ? counter_names[counter] : "";
+}
+
+/**
+ * @details Resident set size of the process read from /proc/self/statm
+ * (shared by all the threads).
+ *
+ * @return resident memory in MB, zero if not available
+ */
+Double_t SLArProfiler::GetResidentMemory()
+{
+  FILE* statm = fopen("/proc/self/statm", "r");
+  if (statm == nullptr) return 0.;
+  long size = 0, resident = 0;
+  const int n = fscanf(statm, "%ld %ld", &size, &resident);
+  fclose(statm);
+  if (n != 2) return 0.;
+  return resident * static_cast<Double_t>(sysconf(_SC_PAGESIZE)) / (1024.*1024.);
+}
+
+/**
+ * @return peak resident memory of the process in MB
+ */
+Double_t SLArProfiler::GetPeakResidentMemory()
+{
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.;
+#ifdef __APPLE__
+  return usage.ru_maxrss / (1024.*1024.);
+#else
+  return usage.ru_maxrss / 1024.;
+#endif
+}
+
+/**
+ * @details Enable or disable the profiler and make it the active
+ * profiler of the calling thread, used by the SLArProfileScope timers.
+ * Must be called by the thread processing the events.
+ */
+void SLArProfiler::Activate(const G4bool enable)
+{
+  fEnabled = enable;
+  if (fEnabled) fgActive = this;
+  else if (fgActive == this) fgActive = nullptr;
+  return;
+}
+
+void SLArProfiler::Reset()
+{
+  for (auto& t : fTotalTime) t = 0;
+  for (auto& n : fTotalCalls) n = 0;
+  fEventStartTime.fill(0);
+  fEventStartCalls.fill(0);
+  fEventCounts.fill(0);
+  fRecords.clear();
+  fProfileTree = nullptr;
+  return;
+}
+
+void SLArProfiler::BeginEvent()
+{
+  if (!fEnabled) return;
+  for (size_t i = 0; i < kNSections; i++) {
+    fEventStartTime[i] = fTotalTime[i].load(std::memory_order_relaxed);
+    fEventStartCalls[i] = fTotalCalls[i].load(std::memory_order_relaxed);
+  }
+  fEventCounts.fill(0);
+  fEventStart = std::chrono::steady_clock::now();
+  return;
+}
+
+/**
+ * @details Store the telemetry of the event: the time of each section is
+ * the difference of the accumulated time with respect to BeginEvent.
+ * When the output is written by the output stage (task or async mode)
+ * the zero suppression and FillTree times of an event are accounted to
+ * the event being simulated while the output is written.
+ */
+void SLArProfiler::EndEvent(const Int_t ev_number)
+{
+  if (!fEnabled) return;
+  const auto dt = std::chrono::steady_clock::now() - fEventStart;
+
+  SLArProfileRecord record{};
+  record.fEvNumber = ev_number;
+  record.fThreadID = G4Threading::G4GetThreadId();
+  record.fEventTime = std::chrono::duration<Double_t, std::milli>(dt).count();
+  record.fRSS = GetResidentMemory();
+  record.fPeakRSS = GetPeakResidentMemory();
+  for (size_t i = 0; i < kNCounters; i++) record.fCounts[i] = fEventCounts[i];
+  for (size_t i = 0; i < kNSections; i++) {
+    record.fSectionTime[i] =
+      (fTotalTime[i].load(std::memory_order_relaxed) - fEventStartTime[i]) * 1e-6;
+    record.fSectionCalls[i] =
+      fTotalCalls[i].load(std::memory_order_relaxed) - fEventStartCalls[i];
+  }
+  fRecords.push_back( record );
+  return;
+}
+
+/**
+ * @details Create the ProfileTree in the given file and fill it with the
+ * records of the run. The tree is only filled at the end of the run,
+ * since in async output mode the I/O thread is writing the event trees
+ * of the same file during the event loop.
+ *
+ * @return the profile tree, nullptr if profiling is disabled
+ */
+TTree* SLArProfiler::FillProfileTree(TFile* file)
+{
+  if (!fEnabled || file == nullptr) return nullptr;
+
+  SLArProfileRecord row{};
+  fProfileTree = new TTree("ProfileTree", "SoLAr-sim timing and memory telemetry");
+  fProfileTree->SetDirectory(file);
+  fProfileTree->Branch("EvNumber", &row.fEvNumber, "EvNumber/I");
+  fProfileTree->Branch("ThreadID", &row.fThreadID, "ThreadID/I");
+  fProfileTree->Branch("EventTime", &row.fEventTime, "EventTime/D");
+  fProfileTree->Branch("RSS", &row.fRSS, "RSS/D");
+  fProfileTree->Branch("PeakRSS", &row.fPeakRSS, "PeakRSS/D");
+  for (size_t i = 0; i < kNCounters; i++) {
+    const TString name = counter_names[i];
+    fProfileTree->Branch(name, &row.fCounts[i], name + "/L");
+  }
+  for (size_t i = 0; i < kNSections; i++) {
+    const TString t_name = TString("t_") + section_names[i];
+    const TString n_name = TString("n_") + section_names[i];
+    fProfileTree->Branch(t_name, &row.fSectionTime[i], t_name + "/D");
+    fProfileTree->Branch(n_name, &row.fSectionCalls[i], n_name + "/L");
+  }
+
+  for (const auto& record : fRecords) {
+    row = record;
+    fProfileTree->Fill();
+  }
+  fProfileTree->ResetBranchAddresses();
+
+  return fProfileTree;
+}
+
+void SLArProfiler::PrintSummary() const
+{
+  if (!fEnabled || fRecords.empty()) return;
+
+  Double_t event_time = 0.;
+  for (const auto& record : fRecords) event_time += record.fEventTime;
+
+  printf("\nSLArProfiler summary (thread %i): %lu events, %.3f ms/event, peak RSS %.1f MB\n",
+      G4Threading::G4GetThreadId(), fRecords.size(), event_time / fRecords.size(),
+      GetPeakResidentMemory());
+  printf("%-18s %14s %14s %14s %10s\n", "section", "total [ms]", "calls", "ns/call", "% event");
+  for (size_t i = 0; i < kNSections; i++) {
+    const Long64_t calls = fTotalCalls[i].load(std::memory_order_relaxed);
+    if (calls == 0) continue;
+    const Double_t t_ms = fTotalTime[i].load(std::memory_order_relaxed) * 1e-6;
+    printf("%-18s %14.3f %14lld %14.1f %10.2f\n", section_names[i], t_ms, calls,
+        t_ms * 1e6 / calls, (event_time > 0.) ? 100. * t_ms / event_time : 0.);
+  }
+  printf("\n");
+  return;
+}
+
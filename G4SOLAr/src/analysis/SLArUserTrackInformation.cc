@@ -7,15 +7,18 @@
 #include "SLArUserTrackInformation.hh"
 
 SLArUserTrackInformation::SLArUserTrackInformation(SLArEventTrajectory* trj)
-  : G4VUserTrackInformation(), fTrajectory(trj), fStoreTrajectory(0)
+  : G4VUserTrackInformation(), fTrajectory(trj), fStoreTrajectory(0),
+    fAncestorID(-1), fAncestor(nullptr)
 {}
 
 SLArUserTrackInformation::SLArUserTrackInformation(SLArEventTrajectory* trj, const G4String& infoType) 
-  : G4VUserTrackInformation(infoType), fTrajectory(trj), fStoreTrajectory(0)
+  : G4VUserTrackInformation(infoType), fTrajectory(trj), fStoreTrajectory(0),
+    fAncestorID(-1), fAncestor(nullptr)
 {}
 
 SLArUserTrackInformation::SLArUserTrackInformation(const SLArUserTrackInformation& info)
-  : G4VUserTrackInformation(info), fTrajectory(info.fTrajectory)
+  : G4VUserTrackInformation(info), fTrajectory(info.fTrajectory), 
+    fAncestorID(info.fAncestorID), fAncestor(info.fAncestor)
 {
   fStoreTrajectory = info.fStoreTrajectory; 
 }
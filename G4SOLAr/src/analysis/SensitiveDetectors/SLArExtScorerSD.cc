@@ -11,6 +11,7 @@
 #include "SLArUserTrackInformation.hh"
 #include "SLArEventTrajectory.hh"
 #include "SLArRunAction.hh"
+#include "SLArProfiler.hh"
 #include <cstdio>
 #include "SensitiveDetectors/SLArExtScorerSD.hh"
 
@@ -37,6 +38,7 @@ void SLArExtScorerSD::Initialize(G4HCofThisEvent* hce) {
 }
 
 G4bool SLArExtScorerSD::ProcessHits(G4Step* step, G4TouchableHistory* ) {
+  SLArProfileScope profile_scope(SLArProfiler::kExtScorerSD); 
   auto track = step->GetTrack(); 
   auto thePrePoint = step->GetPreStepPoint(); 
   auto thePostPoint = step->GetPostStepPoint(); 
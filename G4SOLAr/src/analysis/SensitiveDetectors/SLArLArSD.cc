@@ -38,7 +38,7 @@
 
 SLArLArSD::SLArLArSD(G4String name, G4int tpcID)
   : G4VSensitiveDetector(name), fHitsCollection(0), 
-    fHCID(-4), fTPCID(tpcID)
+    fHCID(-4), fTPCID(tpcID), fPhysicsList(nullptr)
 {
   collectionName.insert("TPC"+std::to_string(tpcID)+"Coll");
 }
@@ -62,6 +62,15 @@ void SLArLArSD::Initialize(G4HCofThisEvent* hce)
 
   // Add single hit for the entire target volume
   fHitsCollection->insert(new SLArLArHit());
+
+  // resolve the physics list once instead of at each step
+  if (fPhysicsList == nullptr) {
+    fPhysicsList = dynamic_cast<const SLArPhysicsList*>(
+        G4RunManager::GetRunManager()->GetUserPhysicsList());
+    if (!fPhysicsList) {
+      G4Exception("SLArLArSD::Initialize", "InvalidCast", FatalException, "Failed to cast to SLArPhysicsList");
+    }
+  }
  
 }
 
@@ -69,6 +78,7 @@ void SLArLArSD::Initialize(G4HCofThisEvent* hce)
 
 G4bool SLArLArSD::ProcessHits(G4Step* step, G4TouchableHistory*)
 {
+  SLArProfileScope profile_scope(SLArProfiler::kLArSD); 
 
   G4StepPoint* preStepPoint  = step->GetPreStepPoint();
   G4StepPoint* postStepPoint = step->GetPostStepPoint();
@@ -103,24 +113,7 @@ G4bool SLArLArSD::ProcessHits(G4Step* step, G4TouchableHistory*)
 
     int n_ph = 0; 
     int n_el = 0; 
-    auto trackingAction = 
-      (SLArTrackingAction*)G4EventManager::GetEventManager()->GetUserTrackingAction(); 
-
-    auto stepMngr = trackingAction->GetTrackingManager()->GetSteppingManager(); 
-    if (stepMngr->GetfStepStatus() != fAtRestDoItProc) {
-      G4ProcessVector* process_vector = stepMngr->GetfPostStepDoItVector(); 
-      for (size_t iproc = 0; iproc < process_vector->size(); iproc++) {
-        G4VProcess* proc = (*process_vector)[iproc]; 
-        if (!proc) continue;
-        if (proc->GetProcessName() == "Scintillation")  {
-          SLArScintillation* scint_process = (SLArScintillation*)proc; 
-          n_ph = scint_process->GetNumPhotons(); 
-          n_el = scint_process->GetNumIonElectrons(); 
-
-          break;
-        } 
-      }
-    }
+    SLArScintillation::GetStepYield(step, n_ph, n_el); 
 
     try {
       auto& anodeCfg = anaMngr->GetAnodeCfgByTPC(fTPCID);  
@@ -133,27 +126,25 @@ G4bool SLArLArSD::ProcessHits(G4Step* step, G4TouchableHistory*)
           n_el);
 #endif
 
-      auto physicsList = dynamic_cast<const SLArPhysicsList*>(
-          G4RunManager::GetRunManager()->GetUserPhysicsList());
-      if (!physicsList) {
-        G4Exception("SLArLArSD::ProcessHits", "InvalidCast", FatalException, "Failed to cast to SLArPhysicsList");
-      }
-      const auto eventAction = (SLArEventAction*)
-        G4RunManager::GetRunManager()->GetUserEventAction(); 
-      auto ancestor_id = eventAction->FindAncestorID(step->GetTrack()->GetTrackID()); 
-      // Add edep in LAr to the primary 
+      // ancestor is resolved once at track creation by the stacking action
+      int ancestor_id = -1; 
       SLArMCPrimaryInfo* ancestor = nullptr;
-      auto& primaries = anaMngr->GetMCTruth().GetPrimaries();
-      for (auto &p : primaries) {
-        if (p.GetTrackID() == ancestor_id) {
-          ancestor = &p;
-          break;
-        }
+      auto trkInfo = (SLArUserTrackInformation*)step->GetTrack()->GetUserInformation(); 
+      if (trkInfo) {
+        ancestor_id = trkInfo->GetAncestorID(); 
+        ancestor = trkInfo->GetAncestor(); 
       }
+      else {
+        const auto eventAction = (SLArEventAction*)
+          G4RunManager::GetRunManager()->GetUserEventAction(); 
+        ancestor_id = eventAction->FindAncestorID(step->GetTrack()->GetTrackID()); 
+        ancestor = eventAction->GetAncestorPrimary(ancestor_id); 
+      }
+      // Add edep in LAr to the primary 
 
       if (ancestor) ancestor->IncrementLArEdep(edep); 
 
-      if (physicsList->DoDriftElectrons()) {
+      if (fPhysicsList->DoDriftElectrons()) {
         runAction->GetElectronDrift()->Drift(n_el, 
             step->GetTrack()->GetTrackID(), ancestor_id,
             preStepPoint->GetPosition(),
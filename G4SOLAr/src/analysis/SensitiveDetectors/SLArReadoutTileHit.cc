@@ -24,19 +24,15 @@ G4ThreadLocal G4Allocator<SLArReadoutTileHit>* SLArReadoutTileHitAllocator;
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 SLArReadoutTileHit::SLArReadoutTileHit()
-: G4VHit(), fAnodeIdx(0), fMegaTileReplicaNr(0), fRowTileReplicaNr(0), fTileReplicaNr(0), 
-  fRowCellNr(0), fCellNr(0),
-  fWavelength(-1), fTime(0.), fPhType(-1), fPhProducerID(-1),
-  fLocalPos(0), fWorldPos(0) 
+: G4VHit(), fChannelKey(0), fWavelength(-1), fTime(0.), 
+  fPhProducerID(-1), fPhType(kNoProcess), fLocalPos{0}, fWorldPos{0}
 {}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 SLArReadoutTileHit::SLArReadoutTileHit(G4double z)
-: G4VHit(), fAnodeIdx(0), fMegaTileReplicaNr(0), fRowTileReplicaNr(0), fTileReplicaNr(0), 
-  fRowCellNr(0), fCellNr(0),
-  fWavelength(z), fTime(0.), fPhType(-1), fPhProducerID(-1),
-  fLocalPos(0), fWorldPos(0) 
+: G4VHit(), fChannelKey(0), fWavelength(z), fTime(0.), 
+  fPhProducerID(-1), fPhType(kNoProcess), fLocalPos{0}, fWorldPos{0}
 {}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -48,36 +44,22 @@ SLArReadoutTileHit::~SLArReadoutTileHit()
 
 SLArReadoutTileHit::SLArReadoutTileHit(const SLArReadoutTileHit &right)
 : G4VHit() {
-    fWavelength   = right.fWavelength;
-    fWorldPos     = right.fWorldPos;
-    fLocalPos     = right.fLocalPos;
-    fPhProducerID = right.fPhProducerID;
-    fTime         = right.fTime;
-    fAnodeIdx      = right.fAnodeIdx;
-    fMegaTileReplicaNr = right.fMegaTileReplicaNr;
-    fRowTileReplicaNr  = right.fRowTileReplicaNr; 
-    fTileReplicaNr     = right.fTileReplicaNr; 
-    fRowCellNr    = right.fRowCellNr; 
-    fCellNr       = right.fCellNr;
-    fPhType       = right.fPhType;
+    *this = right;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 const SLArReadoutTileHit& SLArReadoutTileHit::operator=(const SLArReadoutTileHit &right)
 {
+    fChannelKey   = right.fChannelKey;
     fWavelength   = right.fWavelength;
-    fWorldPos     = right.fWorldPos;
-    fLocalPos     = right.fLocalPos;
     fTime         = right.fTime;
-    fAnodeIdx      = right.fAnodeIdx;
-    fMegaTileReplicaNr = right.fMegaTileReplicaNr;
-    fRowTileReplicaNr  = right.fRowTileReplicaNr; 
-    fTileReplicaNr     = right.fTileReplicaNr; 
-    fRowCellNr    = right.fRowCellNr; 
-    fCellNr       = right.fCellNr; 
-    fPhType       = right.fPhType;
     fPhProducerID = right.fPhProducerID;
+    fPhType       = right.fPhType;
+    for (int i = 0; i < 3; i++) {
+      fLocalPos[i] = right.fLocalPos[i];
+      fWorldPos[i] = right.fWorldPos[i];
+    }
     return *this;
 }
 
@@ -95,7 +77,7 @@ void SLArReadoutTileHit::Draw()
     G4VVisManager* pVVisManager = G4VVisManager::GetConcreteInstance();
     if(pVVisManager)
     {
-        G4Circle circle(fWorldPos);
+        G4Circle circle(GetWorldPos());
         circle.SetScreenSize(2);
         circle.SetFillStyle(G4Circle::filled);
         G4Colour colour(1.,1.,0.);
@@ -166,19 +148,19 @@ std::vector<G4AttValue>* SLArReadoutTileHit::CreateAttValues() const
     values
       ->push_back(G4AttValue("Time", G4BestUnit(fTime,"Time"), ""));
     values
-      ->push_back(G4AttValue("Pos", G4BestUnit(fWorldPos,"Length"),""));
+      ->push_back(G4AttValue("Pos", G4BestUnit(GetWorldPos(),"Length"),""));
     values
-      ->push_back(G4AttValue("AnodeID", G4UIcommand::ConvertToString(fAnodeIdx), ""));
+      ->push_back(G4AttValue("AnodeID", G4UIcommand::ConvertToString(GetAnodeIdx()), ""));
     values
-      ->push_back(G4AttValue("MegaTileReplicaNr", G4UIcommand::ConvertToString(fMegaTileReplicaNr), ""));
+      ->push_back(G4AttValue("MegaTileReplicaNr", G4UIcommand::ConvertToString(GetMegaTileReplicaNr()), ""));
     values
-      ->push_back(G4AttValue("RowTileReplicaNr", G4UIcommand::ConvertToString(fRowTileReplicaNr), ""));
+      ->push_back(G4AttValue("RowTileReplicaNr", G4UIcommand::ConvertToString(GetRowTileReplicaNr()), ""));
     values
-      ->push_back(G4AttValue("TileReplicaNr", G4UIcommand::ConvertToString(fTileReplicaNr), ""));
+      ->push_back(G4AttValue("TileReplicaNr", G4UIcommand::ConvertToString(GetTileReplicaNr()), ""));
     values
-      ->push_back(G4AttValue("RowCellNr", G4UIcommand::ConvertToString(fRowCellNr), ""));
+      ->push_back(G4AttValue("RowCellNr", G4UIcommand::ConvertToString(GetRowCellNr()), ""));
     values
-      ->push_back(G4AttValue("CellNr", G4UIcommand::ConvertToString(fCellNr), ""));
+      ->push_back(G4AttValue("CellNr", G4UIcommand::ConvertToString(GetCellNr()), ""));
 
     values
       ->push_back(G4AttValue("PhType", G4UIcommand::ConvertToString(fPhType), ""));
@@ -193,22 +175,27 @@ std::vector<G4AttValue>* SLArReadoutTileHit::CreateAttValues() const
 void SLArReadoutTileHit::Print()
 {
 
-    G4cout << " Tile: "<<fAnodeIdx<<"/"<<fMegaTileReplicaNr<<"/"<<fRowTileReplicaNr<<"/"<<fTileReplicaNr<< "\n"
+    G4cout << " Tile: "<<GetAnodeIdx()<<"/"<<GetMegaTileReplicaNr()<<"/"<<GetRowTileReplicaNr()<<"/"<<GetTileReplicaNr()<< "\n"
            << GetPhotonProcessName()
            << " Ph wavelength" << fWavelength << "[nm]"
            << " : time "         << fTime/CLHEP::ns << " (nsec)"
-           << " --- global (x,y) "<< G4BestUnit(fWorldPos.x(), "Length")
-           << ", " << G4BestUnit(fWorldPos.y(), "Length") << G4endl;
+           << " --- global (x,y) "<< G4BestUnit(fWorldPos[0], "Length")
+           << ", " << G4BestUnit(fWorldPos[1], "Length") << G4endl;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+SLArReadoutTileHit::EPhotonProcess SLArReadoutTileHit::GetPhotonProcessType(const G4String& prname)
+{
+  if       (G4StrUtil::contains(prname, "Cerenkov")) return kCerenkov;
+  else if  (G4StrUtil::contains(prname, "Scint"   )) return kScintillation;
+  else if  (G4StrUtil::contains(prname, "WLS"     )) return kWLS;
+  else                                               return kOtherProcess;
+}
+
 void SLArReadoutTileHit::SetPhotonProcess(G4String prname)
 {
-  if       (G4StrUtil::contains(prname, "Cerenkov")) fPhType = 1;
-  else if  (G4StrUtil::contains(prname, "Scint"   )) fPhType = 2;
-  else if  (G4StrUtil::contains(prname, "WLS"     )) fPhType = 3;
-  else                                   fPhType = 4;
+  fPhType = GetPhotonProcessType(prname);
 }
 
 G4int SLArReadoutTileHit::GetPhotonProcessId() const
@@ -219,9 +206,37 @@ G4int SLArReadoutTileHit::GetPhotonProcessId() const
 G4String SLArReadoutTileHit::GetPhotonProcessName() const
 {
   G4String prname;
-  if      (fPhType == 1) prname = "Cerenkov";
-  else if (fPhType == 2) prname = "Scint";
-  else if (fPhType == 3) prname = "WLS";
+  if      (fPhType == kCerenkov) prname = "Cerenkov";
+  else if (fPhType == kScintillation) prname = "Scint";
+  else if (fPhType == kWLS) prname = "WLS";
   else                   prname = "Other";
   return prname;
 }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SLArReadoutTileHit::IsValidChannel(const G4int anode, const G4int mt_row, const G4int mt, 
+    const G4int tile_row, const G4int tile, const G4int cell_row, const G4int cell)
+{
+  const G4int fields[kNChannelFields] = {cell, cell_row, tile, tile_row, mt, mt_row, anode};
+  for (int i = 0; i < kNChannelFields; i++) {
+    if (fields[i] < 0 || static_cast<uint64_t>(fields[i]) > kChannelMask[i]) return false;
+  }
+  return true;
+}
+
+/**
+ * @details Pack the replica numbers of the touchable in the channel key. 
+ * Each number is truncated to the width of its field (see kChannelMask): 
+ * use IsValidChannel to check the input. 
+ */
+uint64_t SLArReadoutTileHit::PackChannel(const G4int anode, const G4int mt_row, const G4int mt, 
+    const G4int tile_row, const G4int tile, const G4int cell_row, const G4int cell)
+{
+  const G4int fields[kNChannelFields] = {cell, cell_row, tile, tile_row, mt, mt_row, anode};
+  uint64_t key = 0; 
+  for (int i = 0; i < kNChannelFields; i++) {
+    key |= (static_cast<uint64_t>(fields[i]) & kChannelMask[i]) << kChannelShift[i]; 
+  }
+  return key;
+}
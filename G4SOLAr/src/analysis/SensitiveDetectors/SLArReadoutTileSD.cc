@@ -7,6 +7,11 @@
 
 #include "SensitiveDetectors/SLArReadoutTileSD.hh"
 #include "SensitiveDetectors/SLArReadoutTileHit.hh"
+#include "SLArProfiler.hh"
+#include "SLArAnalysisManager.hh"
+#include "SLArBacktrackerManager.hh"
+#include "detector/SLArDetectorConstruction.hh"
+#include "event/SLArEventPhotonHit.hh"
 
 #include "G4HCofThisEvent.hh"
 #include "G4TouchableHistory.hh"
@@ -18,11 +23,13 @@
 #include "G4ios.hh"
 #include "G4PhysicalConstants.hh"
 #include "G4OpticalPhoton.hh"
+#include "G4RunManager.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 SLArReadoutTileSD::SLArReadoutTileSD(G4String name)
-: G4VSensitiveDetector(name), fHitsCollection(0), fHCID(-2)
+: G4VSensitiveDetector(name), fHitsCollection(0), fHCID(-2), 
+  fDirectHits(false), fNCellRow(1)
 {
     collectionName.insert("ReadoutTileColl");
 }
@@ -43,6 +50,18 @@ void SLArReadoutTileSD::Initialize(G4HCofThisEvent* hce)
     }
 
     hce->AddHitsCollection(fHCID,fHitsCollection);
+
+    // the event tiles of the previous event have been reset (or swapped 
+    // to the output buffers): the references must be rebuilt
+    fEventTiles.clear(); 
+    auto anaMngr = SLArAnalysisManager::Instance(); 
+    fDirectHits = anaMngr->IsDirectPhotonHitsEnabled() && 
+      anaMngr->IsAnodeOutputEnabled() && !anaMngr->GetAnodeCfg().empty(); 
+    if (fDirectHits) {
+      const auto detector = static_cast<const SLArDetectorConstruction*>(
+          G4RunManager::GetRunManager()->GetUserDetectorConstruction()); 
+      fNCellRow = detector->GetReadoutTile()->GetNumberOfCellRows(); 
+    }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -69,6 +88,7 @@ G4bool SLArReadoutTileSD::ProcessHits(G4Step* step, G4TouchableHistory*)
 
 G4bool SLArReadoutTileSD::ProcessHits_constStep(const G4Step* step,
                                        G4TouchableHistory* ){
+  SLArProfileScope profile_scope(SLArProfiler::kReadoutTileSD); 
 
   G4Track* track = step->GetTrack();
   if(track->GetDefinition()
@@ -95,36 +115,58 @@ G4bool SLArReadoutTileSD::ProcessHits_constStep(const G4Step* step,
     = touchable->GetHistory()
       ->GetTopTransform().TransformPoint(worldPos);
  
-  SLArReadoutTileHit* hit = nullptr;
   // Get the creation process of optical photon
-  G4String procName = "";
-  
+  SLArReadoutTileHit::EPhotonProcess procType = SLArReadoutTileHit::kOtherProcess;
   if (track->GetTrackID() != 1) // make sure consider only secondaries
   {
-    auto creator = track->GetCreatorProcess(); 
-    if (creator) procName = creator->GetProcessName();
+    procType = GetCreatorType( track->GetCreatorProcess() ); 
   }
   phEne = track->GetTotalEnergy();
 
-  hit = new SLArReadoutTileHit(); //so create new hit
+  const G4int anode_idx = touchable->GetCopyNumber(9); 
+  const G4int mtrow_nr = touchable->GetCopyNumber(8); 
+  const G4int mgtile_nr = touchable->GetCopyNumber(7); 
+  const G4int rowtile_nr = touchable->GetCopyNumber(6); 
+  const G4int tile_nr = touchable->GetCopyNumber(5); 
+  const G4int rowcell_nr = touchable->GetCopyNumber(3); 
+  const G4int cell_nr = touchable->GetCopyNumber(2); 
+  if (SLArReadoutTileHit::IsValidChannel(anode_idx, mtrow_nr, mgtile_nr, 
+        rowtile_nr, tile_nr, rowcell_nr, cell_nr) == false) {
+    printf("SLArReadoutTileSD::ProcessHits_constStep WARNING: ");
+    printf("replica numbers [%i, %i, %i, %i, %i, %i, %i] do not fit in the channel key. Hit skipped.\n", 
+        anode_idx, mtrow_nr, mgtile_nr, rowtile_nr, tile_nr, rowcell_nr, cell_nr);
+    return false;
+  }
+
+  if (fDirectHits) {
+    SLArEventPhotonHit dstHit(postStepPoint->GetGlobalTime() / CLHEP::ns, procType, 
+        CLHEP::h_Planck * CLHEP::c_light / phEne * 1e6); 
+    dstHit.SetLocalPos(localPos.x(), localPos.y(), localPos.z());
+    dstHit.SetTileInfo(mtrow_nr, mgtile_nr, rowtile_nr, tile_nr); 
+    dstHit.SetRowCellNr(rowcell_nr); 
+    // unique identifier of the SiPM replacing the cell nr (as in SLArEventAction)
+    dstHit.SetCellNr(fNCellRow * rowcell_nr + cell_nr); 
+    dstHit.SetProducerTrkID( track->GetParentID() ); 
+
+    const uint64_t channel = SLArReadoutTileHit::PackChannel(
+        anode_idx, mtrow_nr, mgtile_nr, rowtile_nr, tile_nr, rowcell_nr, cell_nr); 
+    RegisterEventHit(dstHit, SLArReadoutTileHit::GetTileKey(channel), anode_idx); 
+    return true;
+  }
+
+  SLArReadoutTileHit* hit = new SLArReadoutTileHit(); //so create new hit
   hit->SetPhotonWavelength( CLHEP::h_Planck * CLHEP::c_light / phEne * 1e6);
   hit->SetWorldPos(worldPos);
   hit->SetLocalPos(localPos);
   hit->SetTime(postStepPoint->GetGlobalTime());
-  hit->SetAnodeIdx(touchable->GetCopyNumber(9));
-  hit->SetRowMegaTileReplicaNr(touchable->GetCopyNumber(8)); 
-  hit->SetMegaTileReplicaNr(touchable->GetCopyNumber(7));
-  hit->SetRowTileReplicaNr(touchable->GetCopyNumber(6));
-  hit->SetTileReplicaNr(touchable->GetCopyNumber(5));
-  hit->SetRowCellNr(touchable->GetCopyNumber(3)); 
-  hit->SetCellNr(touchable->GetCopyNumber(2)); 
-  hit->SetPhotonProcess(procName);
+  hit->SetChannel(anode_idx, mtrow_nr, mgtile_nr, rowtile_nr, tile_nr, rowcell_nr, cell_nr); 
+  hit->SetPhotonProcessType(procType);
   hit->SetProducerID( track->GetParentID() ); 
 
 
 #ifdef SLAR_DEBUG
   printf("SLArReadoutTileSD::ProcessHits_constStep\n");
-  printf("%s photon hit at t = %g ns\n", procName.c_str(), hit->GetTime());
+  printf("%s photon hit at t = %g ns\n", hit->GetPhotonProcessName().c_str(), hit->GetTime());
   //if (hit->GetTime() < 1*CLHEP::ns) getchar(); 
 #endif
   fHitsCollection->insert(hit);
@@ -133,3 +175,84 @@ G4bool SLArReadoutTileSD::ProcessHits_constStep(const G4Step* step,
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/**
+ * @details Return the hit process type of the photon creator process. The 
+ * classification of the process name is done once per process: the 
+ * photon detectors see very few distinct creator processes. 
+ */
+SLArReadoutTileHit::EPhotonProcess SLArReadoutTileSD::GetCreatorType(const G4VProcess* creator)
+{
+  if (creator == nullptr) return SLArReadoutTileHit::kOtherProcess;
+  for (const auto& creator_type : fCreatorTypes) {
+    if (creator_type.first == creator) return creator_type.second;
+  }
+  const auto type = SLArReadoutTileHit::GetPhotonProcessType( creator->GetProcessName() ); 
+  fCreatorTypes.push_back( std::make_pair(creator, type) ); 
+  return type;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/**
+ * @details Return the output event tile of the channel, creating it at 
+ * the first hit of the event. The anode configuration lookups are done 
+ * once per tile and event; the references stay valid until the event 
+ * anode is reset, since the nodes of the megatile and tile maps do not move.
+ * Return nullptr if the channel is not found in the anode configuration. 
+ */
+SLArReadoutTileSD::SLArEventTileRef* SLArReadoutTileSD::GetEventTile(const uint64_t tile_key, 
+    const G4int anode_idx, const SLArEventPhotonHit& hit)
+{
+  auto it = fEventTiles.find(tile_key); 
+  if (it != fEventTiles.end()) return &it->second;
+
+  auto anaMngr = SLArAnalysisManager::Instance(); 
+  const auto anodeCfg = anaMngr->FindAnodeCfgByID( anode_idx ); 
+  const auto mtCfg = anodeCfg ? anodeCfg->FindBaseElementByID( hit.GetMegaTileID() ) : nullptr; 
+  const auto tCfg = mtCfg ? mtCfg->FindBaseElementByID( hit.GetTileID() ) : nullptr; 
+  if (tCfg == nullptr) {
+    printf("SLArReadoutTileSD::GetEventTile WARNING: ");
+    printf("tile [%i, %i, %i] not found in the anode configuration. Hit skipped.\n", 
+        anode_idx, hit.GetMegaTileID(), hit.GetTileID());
+    return nullptr;
+  }
+
+  auto& ev_anode = anaMngr->GetEventAnode().GetEventAnodeByID( anode_idx ); 
+  SLArEventTileRef& ref = fEventTiles[tile_key]; 
+  ref.fMegaTile = &ev_anode.GetOrCreateEventMegatile( mtCfg->GetIdx() ); 
+  ref.fTile = &ref.fMegaTile->GetOrCreateEventTile( tCfg->GetIdx() ); 
+  return &ref;
+}
+
+/**
+ * @details Register the photon hit in the output event and evaluate the 
+ * backtrackers, as done by SLArEventAction::RecordEventReadoutTile for the
+ * hits collected in the hits collection. 
+ */
+void SLArReadoutTileSD::RegisterEventHit(SLArEventPhotonHit& hit, 
+    const uint64_t tile_key, const G4int anode_idx)
+{
+  SLArEventTileRef* ref = GetEventTile(tile_key, anode_idx, hit); 
+  if (ref == nullptr) return;
+  auto& ev_tile = ref->fMegaTile->RegisterHit(hit, *ref->fTile); 
+  SLArProfiler::CountActive(SLArProfiler::kNPhotonHits, 1); 
+
+  auto bktManager = 
+    SLArAnalysisManager::Instance()->GetBacktrackerManager( backtracker::kVUVSiPM ); 
+  if (bktManager) {
+    if (bktManager->IsNull() == false) {
+      SLArProfileScope profile_scope(SLArProfiler::kBacktracker); 
+      auto& records = 
+        ev_tile.GetBacktrackerVector( ev_tile.ConvertToClock(hit.GetTime()) );
+
+      for (size_t ib = 0; ib < bktManager->GetBacktrackers().size(); ib++) {
+        bktManager->GetBacktrackers().at(ib)->Eval(&hit, 
+            &records.GetRecords().at(ib));
+      }
+    }
+  }
+  return;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
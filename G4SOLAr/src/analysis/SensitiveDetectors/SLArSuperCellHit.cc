@@ -207,12 +207,17 @@ void SLArSuperCellHit::Print()
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+G4int SLArSuperCellHit::GetPhotonProcessType(const G4String& prname)
+{
+  if       (G4StrUtil::contains(prname,"Cerenkov")) return 1;
+  else if  (G4StrUtil::contains(prname,"Scint"   )) return 2;
+  else if  (G4StrUtil::contains(prname,"WLS"     )) return 3;
+  else     return 4;
+}
+
 void SLArSuperCellHit::SetPhotonProcess(G4String prname)
 {
-  if       (G4StrUtil::contains(prname,"Cerenkov")) fPhType = 1;
-  else if  (G4StrUtil::contains(prname,"Scint"   )) fPhType = 2;
-  else if  (G4StrUtil::contains(prname,"WLS"     )) fPhType = 3;
-  else     fPhType = 4;
+  fPhType = GetPhotonProcessType(prname);
 }
 
 G4int SLArSuperCellHit::GetPhotonProcessId() const
@@ -30,6 +30,10 @@
 
 #include "SensitiveDetectors/SLArSuperCellSD.hh"
 #include "SensitiveDetectors/SLArSuperCellHit.hh"
+#include "SLArProfiler.hh"
+#include "SLArAnalysisManager.hh"
+#include "SLArBacktrackerManager.hh"
+#include "event/SLArEventPhotonHit.hh"
 
 #include "G4HCofThisEvent.hh"
 #include "G4TouchableHistory.hh"
@@ -45,7 +49,7 @@
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 SLArSuperCellSD::SLArSuperCellSD(G4String name)
-: G4VSensitiveDetector(name), fHitsCollection(0), fHCID(-1)
+: G4VSensitiveDetector(name), fHitsCollection(0), fHCID(-1), fDirectHits(false)
 {
     collectionName.insert("SuperCellColl");
 }
@@ -66,6 +70,12 @@ void SLArSuperCellSD::Initialize(G4HCofThisEvent* hce)
   }
 
   hce->AddHitsCollection(fHCID,fHitsCollection);
+
+  // the event SuperCells of the previous event have been reset (or 
+  // swapped to the output buffers): the references must be rebuilt
+  fEventSuperCells.clear(); 
+  auto anaMngr = SLArAnalysisManager::Instance(); 
+  fDirectHits = anaMngr->IsDirectPhotonHitsEnabled() && anaMngr->IsPDSOutputEnabled(); 
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -113,6 +123,7 @@ G4bool SLArSuperCellSD::ProcessHits(G4Step* step, G4TouchableHistory*)
 
 G4bool SLArSuperCellSD::ProcessHits_constStep(const G4Step* step,
                                        G4TouchableHistory* ){
+  SLArProfileScope profile_scope(SLArProfiler::kSuperCellSD); 
 
   G4Track* track = step->GetTrack();
   //G4cout << "SLArSuperCellSD::ProcessHits_constStep" << G4endl;
@@ -155,6 +166,18 @@ G4bool SLArSuperCellSD::ProcessHits_constStep(const G4Step* step,
     }
     phEne = track->GetTotalEnergy();
 
+    if (fDirectHits) {
+      SLArEventPhotonHit dstHit(preStepPoint->GetGlobalTime() / CLHEP::ns, 
+          SLArSuperCellHit::GetPhotonProcessType(procName), 
+          CLHEP::h_Planck * CLHEP::c_light / phEne * 1e6); 
+      dstHit.SetLocalPos(localPos.x(), localPos.y(), localPos.z());
+      dstHit.SetTileInfo(0, touchable->GetCopyNumber(3), 
+          touchable->GetCopyNumber(2), touchable->GetCopyNumber(1)); 
+      dstHit.SetProducerTrkID( track->GetParentID() ); 
+      RegisterEventHit(dstHit, touchable->GetCopyNumber(3)); 
+      return true;
+    }
+
     hit = new SLArSuperCellHit(); //so create new hit
     hit->SetPhotonEnergy( phEne );
     hit->SetPhotonWavelength( CLHEP::h_Planck * CLHEP::c_light / phEne *1e6); 
@@ -183,3 +206,64 @@ G4bool SLArSuperCellSD::ProcessHits_constStep(const G4Step* step,
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/**
+ * @details Return the output event SuperCell hit by the photon, creating 
+ * it at the first hit of the event. The PDS configuration lookups are done
+ * once per SuperCell and event. Return nullptr if the SuperCell is not 
+ * found in the PDS configuration. 
+ */
+SLArSuperCellSD::SLArEventSuperCellRef* SLArSuperCellSD::GetEventSuperCell(
+    const G4int array_nr, const SLArEventPhotonHit& hit)
+{
+  const uint64_t key = 
+    (static_cast<uint64_t>(static_cast<uint32_t>(array_nr)) << 32) | static_cast<uint32_t>(hit.GetTileID()); 
+  auto it = fEventSuperCells.find(key); 
+  if (it != fEventSuperCells.end()) return &it->second;
+
+  auto anaMngr = SLArAnalysisManager::Instance(); 
+  const auto cfgArray = anaMngr->GetPDSCfg().FindBaseElement(array_nr);
+  const int cell_idx = cfgArray ? cfgArray->GetElementIdxByID( hit.GetTileID() ) : -1; 
+  if (cell_idx < 0) {
+    printf("SLArSuperCellSD::GetEventSuperCell WARNING: ");
+    printf("SuperCell [%i, %i] not found in the PDS configuration. Hit skipped.\n", 
+        array_nr, hit.GetTileID());
+    return nullptr;
+  }
+
+  SLArEventSuperCellRef& ref = fEventSuperCells[key]; 
+  ref.fArray = &anaMngr->GetEventPDS().GetOpDetArrayByID(array_nr); 
+  ref.fSuperCell = &ref.fArray->GetOrCreateEventSuperCell(cell_idx); 
+  return &ref;
+}
+
+/**
+ * @details Register the photon hit in the output event and evaluate the 
+ * backtrackers, as done by SLArEventAction::RecordEventSuperCell for the 
+ * hits collected in the hits collection. 
+ */
+void SLArSuperCellSD::RegisterEventHit(SLArEventPhotonHit& hit, const G4int array_nr)
+{
+  SLArEventSuperCellRef* ref = GetEventSuperCell(array_nr, hit); 
+  if (ref == nullptr) return;
+  auto& ev_sc = ref->fArray->RegisterHit(hit, *ref->fSuperCell); 
+  SLArProfiler::CountActive(SLArProfiler::kNPhotonHits, 1); 
+
+  auto bktManager = 
+    SLArAnalysisManager::Instance()->GetBacktrackerManager( backtracker::kSuperCell ); 
+  if (bktManager) {
+    if (bktManager->IsNull() == false) {
+      SLArProfileScope profile_scope(SLArProfiler::kBacktracker); 
+      SLArEventBacktrackerVector& records = 
+        ev_sc.GetBacktrackerVector( ev_sc.ConvertToClock<float>(hit.GetTime()) );
+
+      for (size_t ib = 0; ib < bktManager->GetBacktrackers().size(); ib++) {
+        bktManager->GetBacktrackers().at(ib)->Eval(&hit, 
+            &records.GetRecords().at(ib));
+      }
+    }
+  }
+  return;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
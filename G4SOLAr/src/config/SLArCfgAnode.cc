@@ -6,25 +6,31 @@
 
 #include "config/SLArCfgAnode.hh"
 #include "TList.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
 
 
 ClassImp(SLArCfgAnode)
 
 SLArCfgAnode::SLArCfgAnode() 
   : SLArCfgAssembly<SLArCfgMegaTile>(), 
-  fTPCID(0), fAnodeLevelsMap(3)
+  fTPCID(0), fAnodeLevelsMap(3), fUsePixelLookup(true), fPixelLookupBuilt(false)
 {} 
 
 SLArCfgAnode::SLArCfgAnode(const SLArCfgAssembly<SLArCfgMegaTile>& cfg) 
- : SLArCfgAssembly<SLArCfgMegaTile>(cfg), fTPCID(0), fAnodeLevelsMap(3)
+ : SLArCfgAssembly<SLArCfgMegaTile>(cfg), fTPCID(0), fAnodeLevelsMap(3), 
+  fUsePixelLookup(true), fPixelLookupBuilt(false)
 {}
 
 SLArCfgAnode::SLArCfgAnode(TString name) 
-  : SLArCfgAssembly<SLArCfgMegaTile>(name), fTPCID(0), fAnodeLevelsMap(3)
+  : SLArCfgAssembly<SLArCfgMegaTile>(name), fTPCID(0), fAnodeLevelsMap(3), 
+  fUsePixelLookup(true), fPixelLookupBuilt(false)
 {}
 
 SLArCfgAnode::SLArCfgAnode(const SLArCfgAnode& ref) 
-  : SLArCfgAssembly<SLArCfgMegaTile>(ref), fTPCID(ref.fTPCID), fAnodeLevelsMap(3)
+  : SLArCfgAssembly<SLArCfgMegaTile>(ref), fTPCID(ref.fTPCID), fAnodeLevelsMap(3), 
+  fUsePixelLookup(ref.fUsePixelLookup), fPixelLookupBuilt(ref.fPixelLookupBuilt), 
+  fLevelLookup(ref.fLevelLookup), fMegaTileNode(ref.fMegaTileNode), fTileNode(ref.fTileNode)
 {
   
   for (int i=0; i<3; i++) {
@@ -86,7 +92,7 @@ SLArCfgAnode::SLArPixIdx SLArCfgAnode::GetPixelBinIndex(const double& x0, const
   return pidx; 
 }
 
-SLArCfgAnode::SLArPixIdx SLArCfgAnode::GetPixelIndex(const double& x0, const double& x1) {
+SLArCfgAnode::SLArPixIdx SLArCfgAnode::GetPixelIndexTH2Poly(const double& x0, const double& x1) {
   SLArCfgAnode::SLArPixIdx pidx = {-9}; 
 
   //printf("original coordinates: %g, %g\n", x0, x1);
@@ -138,7 +144,197 @@ SLArCfgAnode::SLArPixIdx SLArCfgAnode::GetPixelIndex(const double& x0, const dou
   return pidx; 
 }
 
+/**
+ * @details Constant-time equivalent of SLArCfgAnode::GetPixelIndexTH2Poly. 
+ * The megatile and tile positions projected on the anode axes are taken 
+ * from the tables filled by SLArCfgAnode::BuildPixelLookup and the bin 
+ * search at each level is performed by the corresponding SLArPolyBinLookup.
+ */
+SLArCfgAnode::SLArPixIdx SLArCfgAnode::GetPixelIndexLookup(const double& x0, const double& x1) const {
+  SLArCfgAnode::SLArPixIdx pidx = {-9}; 
+
+  int ibin = fLevelLookup[0].FindBin(x0, x1); 
+  if (ibin <= 0 || ibin > static_cast<int>(fMegaTileNode.size())) return pidx;
+
+  const auto& megatile = fMegaTileNode[ibin-1]; 
+  pidx[0] = megatile.fIdx; 
+
+  const auto& tiles = fTileNode[ibin-1]; 
+  ibin = fLevelLookup[1].FindBin(x0-megatile.fX0, x1-megatile.fX1); 
+  if (ibin <= 0 || ibin > static_cast<int>(tiles.size())) return pidx; 
+
+  const auto& tile = tiles[ibin-1]; 
+  pidx[1] = tile.fIdx; 
+  pidx[2] = fLevelLookup[2].FindBin(x0-tile.fX0, x1-tile.fX1); 
+
+  return pidx; 
+}
+
+/**
+ * @details Find the pixel at the given position and compute its edges 
+ * on the anode axes from the pixel lookup tables. 
+ *
+ * @return false if the lookup is not built or if the position is not on a pixel
+ */
+bool SLArCfgAnode::FindPixelCell(const double& x0, const double& x1, SLArPixCell& cell) const {
+  if (fPixelLookupBuilt == false) return false;
+
+  int ibin = fLevelLookup[0].FindBin(x0, x1); 
+  if (ibin <= 0 || ibin > static_cast<int>(fMegaTileNode.size())) return false;
+  const auto& megatile = fMegaTileNode[ibin-1]; 
+
+  const auto& tiles = fTileNode[ibin-1]; 
+  ibin = fLevelLookup[1].FindBin(x0-megatile.fX0, x1-megatile.fX1); 
+  if (ibin <= 0 || ibin > static_cast<int>(tiles.size())) return false; 
+  const auto& tile = tiles[ibin-1]; 
+
+  const int pix_bin = fLevelLookup[2].FindBin(x0-tile.fX0, x1-tile.fX1); 
+  if (pix_bin <= 0) return false;
+  if (!fLevelLookup[2].GetBinEdges(pix_bin, cell.fX0min, cell.fX0max, cell.fX1min, cell.fX1max)) {
+    return false;
+  }
+  cell.fX0min += tile.fX0; cell.fX0max += tile.fX0; 
+  cell.fX1min += tile.fX1; cell.fX1max += tile.fX1; 
+  cell.fIdx = {megatile.fIdx, tile.fIdx, pix_bin}; 
+  return true;
+}
+
+/**
+ * @details Get the pitch of the pixel lattice along the two anode axes. 
+ *
+ * @return false if the pixels are not laid out on a regular lattice
+ */
+bool SLArCfgAnode::GetPixelPitch(double& pitch0, double& pitch1) const {
+  if (fPixelLookupBuilt == false || fLevelLookup[2].IsRegular() == false) return false;
+  pitch0 = fLevelLookup[2].GetCellSizeX(); 
+  pitch1 = fLevelLookup[2].GetCellSizeY(); 
+  return (pitch0 > 0 && pitch1 > 0);
+}
+
+/**
+ * @details Build the lookup grids of the three levels of the anode map 
+ * and cache the positions of megatiles and tiles projected on the 
+ * anode axes. Must be called after the three maps have been registered 
+ * with SLArCfgAnode::RegisterMap. 
+ */
+void SLArCfgAnode::BuildPixelLookup() {
+  ClearPixelLookup(); 
+
+  for (size_t ilevel = 0; ilevel < fAnodeLevelsMap.size(); ilevel++) {
+    if (fAnodeLevelsMap.at(ilevel) == nullptr) {
+      printf("SLArCfgAnode::BuildPixelLookup WARNING: level %lu map is not registered. Skip.\n", ilevel);
+      return;
+    }
+    fLevelLookup.at(ilevel).Build( fAnodeLevelsMap.at(ilevel).get() ); 
+    if (fLevelLookup.at(ilevel).IsBuilt() == false) {
+      ClearPixelLookup(); 
+      return;
+    }
+  }
+
+  const size_t n_megatiles = fElementsMap.size(); 
+  fMegaTileNode.reserve(n_megatiles); 
+  fTileNode.resize(n_megatiles); 
+  for (size_t imt = 0; imt < n_megatiles; imt++) {
+    const auto& megatile = fElementsMap.at(imt); 
+    const TVector3 mt_pos(megatile.GetPhysX(), megatile.GetPhysY(), megatile.GetPhysZ()); 
+    fMegaTileNode.push_back( {megatile.GetIdx(), mt_pos.Dot(fAxis0), mt_pos.Dot(fAxis1)} ); 
+
+    const auto& tiles = megatile.GetConstMap(); 
+    fTileNode.at(imt).reserve( tiles.size() ); 
+    for (const auto& tile : tiles) {
+      const TVector3 tile_pos(tile.GetPhysX(), tile.GetPhysY(), tile.GetPhysZ()); 
+      fTileNode.at(imt).push_back( {tile.GetIdx(), tile_pos.Dot(fAxis0), tile_pos.Dot(fAxis1)} ); 
+    }
+  }
+
+  fPixelLookupBuilt = true; 
+
+  printf("SLArCfgAnode::BuildPixelLookup: %s lookup grids: megatile %ix%i (%s), tile %ix%i (%s), pixel %ix%i (%s)\n", 
+      fName.Data(), 
+      fLevelLookup[0].GetNCellsX(), fLevelLookup[0].GetNCellsY(), fLevelLookup[0].IsRegular() ? "regular" : "polygon", 
+      fLevelLookup[1].GetNCellsX(), fLevelLookup[1].GetNCellsY(), fLevelLookup[1].IsRegular() ? "regular" : "polygon", 
+      fLevelLookup[2].GetNCellsX(), fLevelLookup[2].GetNCellsY(), fLevelLookup[2].IsRegular() ? "regular" : "polygon");
+  return;
+}
+
+void SLArCfgAnode::ClearPixelLookup() {
+  fPixelLookupBuilt = false; 
+  for (auto& lookup : fLevelLookup) lookup.Clear(); 
+  fMegaTileNode.clear(); 
+  fTileNode.clear(); 
+}
+
+/**
+ * @details Cross-check the pixel lookup against the TH2Poly-based search 
+ * on random points uniformly distributed over the anode surface (plus a 
+ * 5% margin to probe the overflow codes). Mismatches are printed and 
+ * the time spent by both methods is reported. 
+ *
+ * @param n_points number of random points
+ * @param seed seed of the random generator
+ *
+ * @return number of points for which the two methods disagree
+ */
+size_t SLArCfgAnode::ValidatePixelLookup(const size_t n_points, const unsigned int seed) {
+  if (fPixelLookupBuilt == false) {
+    printf("SLArCfgAnode::ValidatePixelLookup WARNING: pixel lookup of %s not built.\n", fName.Data());
+    return n_points;
+  }
+
+  const TH2Poly* hmap = fAnodeLevelsMap.at(0).get(); 
+  const double xmin = hmap->GetXaxis()->GetXmin(); 
+  const double xmax = hmap->GetXaxis()->GetXmax(); 
+  const double ymin = hmap->GetYaxis()->GetXmin(); 
+  const double ymax = hmap->GetYaxis()->GetXmax(); 
+  const double margin_x = 0.05*(xmax - xmin); 
+  const double margin_y = 0.05*(ymax - ymin); 
+
+  TRandom3 rndm(seed); 
+  std::vector<double> xx(n_points); 
+  std::vector<double> yy(n_points); 
+  for (size_t i = 0; i < n_points; i++) {
+    xx[i] = rndm.Uniform(xmin - margin_x, xmax + margin_x); 
+    yy[i] = rndm.Uniform(ymin - margin_y, ymax + margin_y); 
+  }
+
+  std::vector<SLArPixIdx> ref_idx(n_points); 
+  std::vector<SLArPixIdx> lkp_idx(n_points); 
+
+  TStopwatch timer; 
+  timer.Start(); 
+  for (size_t i = 0; i < n_points; i++) ref_idx[i] = GetPixelIndexTH2Poly(xx[i], yy[i]); 
+  timer.Stop(); 
+  const double t_ref = timer.RealTime(); 
+
+  timer.Start(true); 
+  for (size_t i = 0; i < n_points; i++) lkp_idx[i] = GetPixelIndexLookup(xx[i], yy[i]); 
+  timer.Stop(); 
+  const double t_lkp = timer.RealTime(); 
+
+  size_t n_mismatch = 0; 
+  size_t n_pixel = 0; 
+  for (size_t i = 0; i < n_points; i++) {
+    if (ref_idx[i][2] > 0) n_pixel++; 
+    if (ref_idx[i] == lkp_idx[i]) continue;
+    if (n_mismatch < 10) {
+      printf("SLArCfgAnode::ValidatePixelLookup MISMATCH at (%g, %g): TH2Poly [%i, %i, %i] - lookup [%i, %i, %i]\n", 
+          xx[i], yy[i], 
+          ref_idx[i][0], ref_idx[i][1], ref_idx[i][2], 
+          lkp_idx[i][0], lkp_idx[i][1], lkp_idx[i][2]);
+    }
+    n_mismatch++; 
+  }
+
+  printf("SLArCfgAnode::ValidatePixelLookup: %s - %lu points (%lu on pixels), %lu mismatches\n", 
+      fName.Data(), n_points, n_pixel, n_mismatch); 
+  printf("\tTH2Poly: %g s, lookup: %g s\n", t_ref, t_lkp); 
+
+  return n_mismatch; 
+}
+
 void SLArCfgAnode::RegisterMap(size_t ilevel, TH2Poly* hmap) {
+  ClearPixelLookup(); 
   fAnodeLevelsMap.at(ilevel) = std::unique_ptr<TH2Poly>(hmap); 
   return;
 }
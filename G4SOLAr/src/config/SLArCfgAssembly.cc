@@ -12,13 +12,16 @@
 #include "config/SLArCfgReadoutTile.hh"
 #include "config/SLArCfgSuperCell.hh"
 #include <cstdio>
+#include <stdexcept>
+#include <type_traits>
 #include "config/SLArCfgAssembly.hh"
 
 templateClassImp(SLArCfgAssembly)
 
 template<class TBaseModule>
 SLArCfgAssembly<TBaseModule>::SLArCfgAssembly() 
-  : SLArCfgBaseModule()/*, fH2Bins(nullptr)*/, fNElements(0)
+  : SLArCfgBaseModule()/*, fH2Bins(nullptr)*/, fNElements(0), 
+  fIndexFrozen(false), fIDOffset(0), fBinOffset(0)
 {
   SetName("aAssemblyHasNoName");
   fElementsMap.reserve(50); 
@@ -26,7 +29,8 @@ SLArCfgAssembly<TBaseModule>::SLArCfgAssembly()
 
 template<class TBaseModule>
 SLArCfgAssembly<TBaseModule>::SLArCfgAssembly(TString name, int serie) 
-  : SLArCfgBaseModule(serie)/*, fH2Bins(nullptr)*/, fNElements(0)
+  : SLArCfgBaseModule(serie)/*, fH2Bins(nullptr)*/, fNElements(0), 
+  fIndexFrozen(false), fIDOffset(0), fBinOffset(0)
 {
   SetName(name);
   fElementsMap.reserve(50);
@@ -37,7 +41,9 @@ SLArCfgAssembly<TBaseModule>::SLArCfgAssembly(TString name, int serie)
 
 template<class TBaseModule>
 SLArCfgAssembly<TBaseModule>::SLArCfgAssembly(const SLArCfgAssembly &cfg)
-  : SLArCfgBaseModule(cfg)/*, fH2Bins(0)*/, fNElements(0)
+  : SLArCfgBaseModule(cfg)/*, fH2Bins(0)*/, fNElements(0), 
+  fIndexFrozen(cfg.fIndexFrozen), fIDOffset(cfg.fIDOffset), fBinOffset(cfg.fBinOffset), 
+  fIDtoIdxTable(cfg.fIDtoIdxTable), fBinToIdxTable(cfg.fBinToIdxTable)
 {
   SLArCfgAssembly<TBaseModule>();
   SetName(cfg.fName);
@@ -94,6 +100,11 @@ void SLArCfgAssembly<TBaseModule>::DumpInfo() const
 template<class TBaseModule>
 void SLArCfgAssembly<TBaseModule>::RegisterElement(TBaseModule& element)
 {
+  if (fIndexFrozen) {
+    fprintf(stderr, "SLArCfgAssembly::RegisterElement ERROR: %s index tables are frozen. Element %i not registered.\n", 
+        fName.Data(), element.GetID());
+    return;
+  }
   int id = element.GetID();
   if (fIDtoIdxMap.count(id)) 
   {
@@ -140,9 +151,86 @@ TH2Poly* SLArCfgAssembly<TBaseModule>::BuildPolyBinHist(
   }
 
   h2Bins->ChangePartition(n, m); 
+
+  // the element bin indices have changed: keep the frozen table in sync
+  if (fIndexFrozen) BuildBinIndexTable(); 
   return h2Bins;
 }
 
+/**
+ * @details Build the dense ID -> index and bin -> index tables replacing 
+ * the std::map lookups of GetBaseElementByID and GetBaseElementByBin, and 
+ * freeze the element list. Called once the geometry (and the TH2Poly 
+ * binning) is complete. Nested assemblies are indexed recursively. 
+ * The tables are transient: an assembly read back from file falls back 
+ * on the maps until BuildIndexTables is called. 
+ */
+template<class TBaseModule>
+void SLArCfgAssembly<TBaseModule>::BuildIndexTables()
+{
+  fIDtoIdxTable.clear(); 
+  fIDOffset = 0; 
+  if (fIDtoIdxMap.empty() == false) {
+    // std::map is sorted: first and last keys give the table range
+    fIDOffset = fIDtoIdxMap.begin()->first; 
+    const int id_max = fIDtoIdxMap.rbegin()->first; 
+    fIDtoIdxTable.assign(id_max - fIDOffset + 1, -1); 
+    for (const auto& p : fIDtoIdxMap) {
+      fIDtoIdxTable[p.first - fIDOffset] = p.second; 
+    }
+  }
+  BuildBinIndexTable(); 
+
+  if constexpr (std::is_base_of<SLArCfgAssembly<SLArCfgReadoutTile>, TBaseModule>::value) {
+    for (auto& el : fElementsMap) el.BuildIndexTables(); 
+  }
+
+  fIndexFrozen = true; 
+  return;
+}
+
+template<class TBaseModule>
+void SLArCfgAssembly<TBaseModule>::BuildBinIndexTable()
+{
+  fBinToIdxTable.clear(); 
+  fBinOffset = 0; 
+  if (fBinToIdxMap.empty()) return;
+
+  fBinOffset = fBinToIdxMap.begin()->first; 
+  const int bin_max = fBinToIdxMap.rbegin()->first; 
+  fBinToIdxTable.assign(bin_max - fBinOffset + 1, -1); 
+  for (const auto& p : fBinToIdxMap) {
+    fBinToIdxTable[p.first - fBinOffset] = p.second; 
+  }
+  return;
+}
+
+template<class TBaseModule>
+void SLArCfgAssembly<TBaseModule>::ClearIndexTables()
+{
+  fIDtoIdxTable.clear(); 
+  fBinToIdxTable.clear(); 
+  fIDOffset = 0; 
+  fBinOffset = 0; 
+  fIndexFrozen = false; 
+
+  if constexpr (std::is_base_of<SLArCfgAssembly<SLArCfgReadoutTile>, TBaseModule>::value) {
+    for (auto& el : fElementsMap) el.ClearIndexTables(); 
+  }
+  return;
+}
+
+template<class TBaseModule>
+void SLArCfgAssembly<TBaseModule>::ThrowMissingElement(
+    const char* method, const char* key, const int value) const
+{
+  char err_msg[200]; 
+  snprintf(err_msg, sizeof(err_msg), 
+      "SLArCfgAssembly::%s ERROR: Module with %s %i not found in %s records\n", 
+      method, key, value, fName.Data());
+  throw std::runtime_error(err_msg); 
+}
+
 /*
  *template<class TBaseModule>
  *TH2Poly* SLArCfgAssembly<TBaseModule>::GetTH2()
@@ -23,6 +23,7 @@ templateClassImp(SLArCfgBaseSystem)
 template<class TAssemblyModule>
 SLArCfgBaseSystem<TAssemblyModule>::SLArCfgBaseSystem() 
   : SLArCfgBaseModule()//, fH2Bins(nullptr)
+  , fNElements(0), fIndexFrozen(false), fIdxOffset(0)
 {
   fName = "aMapHasNoName"; 
 }
@@ -30,19 +31,22 @@ SLArCfgBaseSystem<TAssemblyModule>::SLArCfgBaseSystem()
 template<class TAssemblyModule>
 SLArCfgBaseSystem<TAssemblyModule>::SLArCfgBaseSystem(TString name) 
   : SLArCfgBaseModule()//, fH2Bins(nullptr)
+  , fNElements(0), fIndexFrozen(false), fIdxOffset(0)
 {
   fName = name; 
 }
 
 template<class TAssemblyModule>
 SLArCfgBaseSystem<TAssemblyModule>::SLArCfgBaseSystem(const SLArCfgBaseSystem<TAssemblyModule>& cfg) 
-  : SLArCfgBaseModule(cfg) 
+  : SLArCfgBaseModule(cfg), fIndexFrozen(false), fIdxOffset(0) 
 {
   fNElements = cfg.fNElements; 
   for (const auto &mod : cfg.fElementsMap) {
     fElementsMap.insert(
         std::make_pair(mod.first, TAssemblyModule(mod.second))); 
   }
+  // the index table points to the elements: rebuild it for the copy
+  if (cfg.fIndexFrozen) BuildIndexTables(); 
 
   //fH2Bins = nullptr; 
   //if (cfg.fH2Bins) {
@@ -67,6 +71,25 @@ SLArCfgBaseSystem<TAssemblyModule>::~SLArCfgBaseSystem() {
   //if (fH2Bins) {delete fH2Bins;}
 }
 
+template<class TAssemblyModule>
+SLArCfgBaseSystem<TAssemblyModule>& SLArCfgBaseSystem<TAssemblyModule>::operator=(
+    const SLArCfgBaseSystem<TAssemblyModule>& cfg)
+{
+  if (this == &cfg) return *this;
+
+  SLArCfgBaseModule::operator=(cfg); 
+  ClearIndexTables(); 
+  fNElements = cfg.fNElements; 
+  fElementsMap.clear(); 
+  for (const auto &mod : cfg.fElementsMap) {
+    fElementsMap.insert(
+        std::make_pair(mod.first, TAssemblyModule(mod.second))); 
+  }
+  if (cfg.fIndexFrozen) BuildIndexTables(); 
+
+  return *this;
+}
+
 template<class TAssemblyModule>
 TAssemblyModule& SLArCfgBaseSystem<TAssemblyModule>::GetBaseElement(const char* name)
 {
@@ -86,13 +109,60 @@ TAssemblyModule& SLArCfgBaseSystem<TAssemblyModule>::GetBaseElement(const char*
 template<class TAssemblyModule>
 TAssemblyModule& SLArCfgBaseSystem<TAssemblyModule>::GetBaseElement(int idx)
 {
-  return fElementsMap.find(idx)->second;
+  TAssemblyModule* mod = FindBaseElement(idx); 
+  if (mod == nullptr) {
+    char err_msg[100]; 
+    snprintf(err_msg, sizeof(err_msg), 
+        "SLArCfgBaseSystem::GetBaseElement() ERROR: Element %i not found in register\n\n", 
+        idx);
+    throw std::runtime_error(err_msg); 
+  }
+  return *mod;
+}
+
+/**
+ * @details Build the dense index table replacing the std::map lookup of 
+ * GetBaseElement(int) and the index tables of the registered assemblies, 
+ * then freeze the element list. The table points to the map nodes and 
+ * is transient: it is rebuilt when the system is copied. 
+ */
+template<class TAssemblyModule>
+void SLArCfgBaseSystem<TAssemblyModule>::BuildIndexTables()
+{
+  fIdxTable.clear(); 
+  fIdxOffset = 0; 
+  if (fElementsMap.empty() == false) {
+    fIdxOffset = fElementsMap.begin()->first; 
+    const int idx_max = fElementsMap.rbegin()->first; 
+    fIdxTable.assign(idx_max - fIdxOffset + 1, nullptr); 
+    for (auto& mod : fElementsMap) {
+      mod.second.BuildIndexTables(); 
+      fIdxTable[mod.first - fIdxOffset] = &mod.second; 
+    }
+  }
+  fIndexFrozen = true; 
+  return;
+}
+
+template<class TAssemblyModule>
+void SLArCfgBaseSystem<TAssemblyModule>::ClearIndexTables()
+{
+  fIdxTable.clear(); 
+  fIdxOffset = 0; 
+  fIndexFrozen = false; 
+  for (auto& mod : fElementsMap) mod.second.ClearIndexTables(); 
+  return;
 }
 
 
 template<class TAssemblyModule>
 void SLArCfgBaseSystem<TAssemblyModule>::RegisterElement(TAssemblyModule& mod) 
 {
+  if (fIndexFrozen) {
+    fprintf(stderr, "SLArCfgBaseSystem::RegisterElement ERROR: %s index table is frozen. Element %s not registered.\n", 
+        fName.Data(), mod.GetName());
+    return;
+  }
   int idx = mod.GetIdx();
   if (fElementsMap.count(idx)) 
   {
@@ -0,0 +1,247 @@
+/**
+ * @author      Daniele Guffanti (daniele.guffanti@mib.infn.it)
+ * @file        SLArPolyBinLookup.cc
+ * @created     Saturday Oct 17, 2026 10:31:07 CEST
+ */
+
+#include <cstdio>
+#include <algorithm>
+
+#include "TH2Poly.h"
+#include "TGraph.h"
+#include "TMath.h"
+#include "config/SLArPolyBinLookup.hh"
+
+namespace {
+  //! Upper limit for the number of grid cells along each axis
+  const int kMaxCellsPerAxis = 4096;
+}
+
+SLArPolyBinLookup::SLArPolyBinLookup()
+  : fIsBuilt(false), fIsRegular(false),
+  fXmin(0), fXmax(0), fYmin(0), fYmax(0),
+  fX0(0), fY0(0), fInvDx(0), fInvDy(0), fNx(0), fNy(0)
+{}
+
+void SLArPolyBinLookup::Clear() {
+  fIsBuilt = false;
+  fIsRegular = false;
+  fNx = 0; fNy = 0;
+  fBins.clear();
+  fCellOffset.clear();
+  fCellBins.clear();
+}
+
+bool SLArPolyBinLookup::IsInsidePolygon(const SBinShape& b, const double x, const double y) {
+  if (x < b.fXmin || x > b.fXmax || y < b.fYmin || y > b.fYmax) return false;
+  // same crossing-number test used by TH2PolyBin::IsInside
+  return TMath::IsInside(x, y, static_cast<Int_t>(b.fVx.size()),
+      const_cast<double*>(b.fVx.data()), const_cast<double*>(b.fVy.data()));
+}
+
+/**
+ * @details Check whether the lower edges of the bins along one axis
+ * lie on a regular lattice whose pitch is not smaller than the widest bin.
+ *
+ * @param lo lower edges of the bins
+ * @param max_width largest bin width
+ * @param origin lattice origin (output)
+ * @param pitch lattice pitch (output)
+ */
+bool SLArPolyBinLookup::FindLattice(std::vector<double> lo, const double max_width,
+    double& origin, double& pitch)
+{
+  if (lo.empty() || max_width <= 0) return false;
+
+  const double tol = 1e-6*max_width;
+  std::sort(lo.begin(), lo.end());
+  std::vector<double> edges;
+  edges.reserve(lo.size());
+  for (const auto& v : lo) {
+    if (edges.empty() || v - edges.back() > tol) edges.push_back(v);
+  }
+
+  origin = edges.front();
+  if (edges.size() == 1) {
+    pitch = max_width;
+    return true;
+  }
+
+  pitch = edges.back() - edges.front();
+  for (size_t i = 1; i < edges.size(); i++) {
+    pitch = std::min(pitch, edges[i] - edges[i-1]);
+  }
+  if (pitch < max_width - tol) return false;
+
+  for (const auto& v : edges) {
+    const double r = (v - origin) / pitch;
+    if (std::fabs(r - std::round(r))*pitch > tol) return false;
+  }
+  return true;
+}
+
+/**
+ * @details Extract the bins shape from the given TH2Poly and sort them
+ * into the cells of the lookup grid. If the bins are rectangles laid
+ * out on a regular lattice the grid is aligned to the lattice (one bin
+ * per cell), otherwise the cell size is set to the size of the smallest bin.
+ *
+ * @param h2 TH2Poly map to be indexed
+ */
+void SLArPolyBinLookup::Build(TH2Poly* h2) {
+  Clear();
+  if (h2 == nullptr || h2->GetBins() == nullptr) return;
+  if (h2->GetNumberOfBins() == 0) return;
+
+  fXmin = h2->GetXaxis()->GetXmin();
+  fXmax = h2->GetXaxis()->GetXmax();
+  fYmin = h2->GetYaxis()->GetXmin();
+  fYmax = h2->GetYaxis()->GetXmax();
+
+  bool all_rect = true;
+  double min_w = fXmax - fXmin; double max_w = 0.;
+  double min_h = fYmax - fYmin; double max_h = 0.;
+  std::vector<double> xlo; std::vector<double> ylo;
+
+  fBins.reserve( h2->GetNumberOfBins() );
+  for (const auto& obj : *(h2->GetBins())) {
+    auto bin = static_cast<TH2PolyBin*>(obj);
+    auto g = dynamic_cast<TGraph*>(bin->GetPolygon());
+    if (g == nullptr || g->GetN() < 3) {
+      fprintf(stderr, "SLArPolyBinLookup::Build WARNING: bin %i of %s is not a TGraph polygon. Lookup disabled.\n",
+          bin->GetBinNumber(), h2->GetName());
+      Clear();
+      return;
+    }
+
+    SBinShape shape;
+    shape.fBin = bin->GetBinNumber();
+    shape.fVx.assign(g->GetX(), g->GetX()+g->GetN());
+    shape.fVy.assign(g->GetY(), g->GetY()+g->GetN());
+    shape.fXmin = *std::min_element(shape.fVx.begin(), shape.fVx.end());
+    shape.fXmax = *std::max_element(shape.fVx.begin(), shape.fVx.end());
+    shape.fYmin = *std::min_element(shape.fVy.begin(), shape.fVy.end());
+    shape.fYmax = *std::max_element(shape.fVy.begin(), shape.fVy.end());
+
+    // axis-aligned rectangle: every vertex is a corner of the bounding box
+    // and consecutive vertices differ in one coordinate only
+    shape.fIsRect = true;
+    const size_t n = shape.fVx.size();
+    for (size_t i = 0; i < n; i++) {
+      const size_t j = (i+1) % n;
+      const bool x_ok = shape.fVx[i] == shape.fXmin || shape.fVx[i] == shape.fXmax;
+      const bool y_ok = shape.fVy[i] == shape.fYmin || shape.fVy[i] == shape.fYmax;
+      const bool edge_ok = shape.fVx[i] == shape.fVx[j] || shape.fVy[i] == shape.fVy[j];
+      if (!x_ok || !y_ok || !edge_ok) {shape.fIsRect = false; break;}
+    }
+    if (n > 5) shape.fIsRect = false;
+    if (shape.fIsRect) {shape.fVx.clear(); shape.fVy.clear();}
+    all_rect = all_rect && shape.fIsRect;
+
+    const double w = shape.fXmax - shape.fXmin;
+    const double h = shape.fYmax - shape.fYmin;
+    if (w > 0) min_w = std::min(min_w, w);
+    if (h > 0) min_h = std::min(min_h, h);
+    max_w = std::max(max_w, w);
+    max_h = std::max(max_h, h);
+    xlo.push_back(shape.fXmin);
+    ylo.push_back(shape.fYmin);
+
+    fBins.push_back( std::move(shape) );
+  }
+
+  double dx = 0.; double dy = 0.;
+  fIsRegular = all_rect &&
+    FindLattice(xlo, max_w, fX0, dx) && FindLattice(ylo, max_h, fY0, dy);
+
+  if (!fIsRegular) {
+    fX0 = fXmin; dx = min_w;
+    fY0 = fYmin; dy = min_h;
+  }
+  if (dx <= 0) dx = (fXmax > fXmin) ? fXmax - fXmin : 1.0;
+  if (dy <= 0) dy = (fYmax > fYmin) ? fYmax - fYmin : 1.0;
+
+  fNx = std::max(1, static_cast<int>(std::ceil( (fXmax - fX0) / dx )));
+  fNy = std::max(1, static_cast<int>(std::ceil( (fYmax - fY0) / dy )));
+  if (fNx > kMaxCellsPerAxis) {fNx = kMaxCellsPerAxis; dx = (fXmax - fX0) / fNx; fIsRegular = false;}
+  if (fNy > kMaxCellsPerAxis) {fNy = kMaxCellsPerAxis; dy = (fYmax - fY0) / fNy; fIsRegular = false;}
+  fInvDx = 1.0 / dx;
+  fInvDy = 1.0 / dy;
+
+  // assign bins to cells. The cell range is computed with the same
+  // (monotonic) expression used in FindBin, so any point inside a bin
+  // is guaranteed to fall in one of the cells the bin is assigned to.
+  auto cell_range = [](const double lo, const double hi, const double origin,
+      const double inv_d, const int n, int& ilo, int& ihi) {
+    ilo = static_cast<int>( std::floor( (lo-origin)*inv_d ) );
+    ihi = static_cast<int>( std::floor( (hi-origin)*inv_d ) );
+    ilo = std::min(std::max(ilo, 0), n-1);
+    ihi = std::min(std::max(ihi, 0), n-1);
+  };
+
+  std::vector<std::vector<int>> cell_bins(fNx*fNy);
+  for (size_t ib = 0; ib < fBins.size(); ib++) {
+    const auto& b = fBins[ib];
+    int ix_lo = 0, ix_hi = 0, iy_lo = 0, iy_hi = 0;
+    cell_range(b.fXmin, b.fXmax, fX0, fInvDx, fNx, ix_lo, ix_hi);
+    cell_range(b.fYmin, b.fYmax, fY0, fInvDy, fNy, iy_lo, iy_hi);
+    for (int ix = ix_lo; ix <= ix_hi; ix++) {
+      for (int iy = iy_lo; iy <= iy_hi; iy++) {
+        cell_bins[ix*fNy + iy].push_back(ib);
+      }
+    }
+  }
+
+  // Candidates are tested in bin order, as done by TH2Poly. On a regular
+  // lattice the bins are disjoint, so the bin owning the cell can be
+  // tested first without changing the result.
+  fCellOffset.resize(fNx*fNy + 1, 0);
+  for (int ic = 0; ic < fNx*fNy; ic++) {
+    auto& cb = cell_bins[ic];
+    if (fIsRegular && cb.size() > 1) {
+      const int ix = ic / fNy; const int iy = ic % fNy;
+      const double cx0 = fX0 + ix*dx; const double cy0 = fY0 + iy*dy;
+      auto overlap = [&](const int ib) {
+        const auto& b = fBins[ib];
+        const double ox = std::min(b.fXmax, cx0+dx) - std::max(b.fXmin, cx0);
+        const double oy = std::min(b.fYmax, cy0+dy) - std::max(b.fYmin, cy0);
+        return std::max(ox, 0.) * std::max(oy, 0.);
+      };
+      std::stable_sort(cb.begin(), cb.end(),
+          [&](const int a, const int b) {return overlap(a) > overlap(b);});
+    }
+    fCellOffset[ic+1] = fCellOffset[ic] + cb.size();
+    fCellBins.insert(fCellBins.end(), cb.begin(), cb.end());
+  }
+
+  fIsBuilt = true;
+  return;
+}
+
+/**
+ * @details Get the bounding box of the given bin (exact for rectangular bins).
+ *
+ * @return false if the bin is not found
+ */
+bool SLArPolyBinLookup::GetBinEdges(const int bin, double& xmin, double& xmax,
+    double& ymin, double& ymax) const
+{
+  if (!fIsBuilt || bin <= 0) return false;
+
+  // bins are stored in TH2Poly order, i.e. usually by bin number
+  const SBinShape* shape = nullptr;
+  if (bin <= static_cast<int>(fBins.size()) && fBins[bin-1].fBin == bin) {
+    shape = &fBins[bin-1];
+  }
+  else {
+    for (const auto& b : fBins) {
+      if (b.fBin == bin) {shape = &b; break;}
+    }
+  }
+  if (shape == nullptr) return false;
+
+  xmin = shape->fXmin; xmax = shape->fXmax;
+  ymin = shape->fYmin; ymax = shape->fYmax;
+  return true;
+}
+
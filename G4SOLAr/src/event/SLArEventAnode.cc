@@ -13,7 +13,7 @@ ClassImp(SLArEventAnode)
 SLArEventAnode::SLArEventAnode() : TNamed(),
     fID(0), fNhits(0), fIsActive(true), 
     fLightBacktrackerRecordSize(0), fChargeBacktrackerRecordSize(0), 
-    fZeroSuppressionThreshold(0)
+    fZeroSuppressionThreshold(0), fHitStoragePolicy(kMapStorage)
 {}
 
 SLArEventAnode::SLArEventAnode(const SLArEventAnode& right) 
@@ -25,6 +25,7 @@ SLArEventAnode::SLArEventAnode(const SLArEventAnode& right)
   fLightBacktrackerRecordSize = right.fLightBacktrackerRecordSize;
   fChargeBacktrackerRecordSize = right.fChargeBacktrackerRecordSize;
   fZeroSuppressionThreshold = right.fZeroSuppressionThreshold;
+  fHitStoragePolicy = right.fHitStoragePolicy; 
   for (const auto &mgev : right.fMegaTilesMap) {
     fMegaTilesMap[mgev.first] = SLArEventMegatile(mgev.second);
   }
@@ -71,6 +72,7 @@ SLArEventMegatile& SLArEventAnode::GetOrCreateEventMegatile(const int mtIdx) {
     mt_event.SetIdx(mtIdx); 
     mt_event.SetLightBacktrackerRecordSize( fLightBacktrackerRecordSize); 
     mt_event.SetChargeBacktrackerRecordSize( fChargeBacktrackerRecordSize ); 
+    mt_event.SetHitStoragePolicy( fHitStoragePolicy ); 
     //printf("SLArEventAnode::CreateEventMegatile(%i): Creating new Megatile nr %i in anode %i register with bktracker record size %u[q] - %u[l]\n",
         //mtIdx, mtIdx, fID, fChargeBacktrackerRecordSize, fLightBacktrackerRecordSize);
     //getchar();
@@ -92,14 +94,14 @@ SLArEventTile& SLArEventAnode::RegisterHit(const SLArEventPhotonHit& hit, int mg
   //}
 }
 
-SLArEventChargePixel& SLArEventAnode::RegisterChargeHit(const SLArCfgAnode::SLArPixIdx& pixIdx, const SLArEventChargeHit& hit) {
+SLArEventChargePixel& SLArEventAnode::RegisterChargeHit(const SLArCfgAnode::SLArPixIdx& pixIdx, const SLArEventChargeHit& hit, const UShort_t n) {
   const int& mgtile_idx = pixIdx.at(0);
   const int& tile_idx = pixIdx.at(1); 
   const int& pix_idx = pixIdx.at(2); 
 
   auto& mt_event = GetOrCreateEventMegatile(mgtile_idx); 
   auto& t_event = mt_event.GetOrCreateEventTile(tile_idx);
-  auto& p_event = t_event.RegisterChargeHit(pix_idx, hit); 
+  auto& p_event = t_event.RegisterChargeHit(pix_idx, hit, n); 
 
   return p_event;
   //} else {
@@ -122,6 +124,18 @@ int SLArEventAnode::ResetHits() {
   return nn; 
 }
 
+/**
+ * @details Merge the hits buffered during the event (kBufferedStorage policy)
+ * in the clock maps of tiles and pixels. 
+ */
+int SLArEventAnode::ConsolidateHits() {
+  int n_ticks = 0; 
+  for (auto &mgtile : fMegaTilesMap) {
+    n_ticks += mgtile.second.ConsolidateHits(); 
+  }
+  return n_ticks; 
+}
+
 void SLArEventAnode::SetActive(bool is_active) {
   fIsActive = is_active; 
   for (auto &mgtile : fMegaTilesMap) {
@@ -6,6 +6,73 @@
 
 #include "event/SLArEventBacktrackerRecord.hh"
 #include <cstdio>
+#include <algorithm>
+
+UShort_t SLArBacktrackerCounter::Get(const Int_t key) const
+{
+  for (const auto entry : *this) {
+    if (entry.first == key) return entry.second;
+  }
+  return 0;
+}
+
+/**
+ * @details Add val to the counter of key and return the updated count. 
+ * The entries are kept sorted by key; when a new key does not fit in the 
+ * inline storage all the entries are moved to the spill vector. 
+ */
+UShort_t SLArBacktrackerCounter::Add(const Int_t key, const UShort_t val)
+{
+  if (IsSpilled()) {
+    auto pos = std::lower_bound(fSpill.begin(), fSpill.end(), key, 
+        [](const Entry_t& entry, const Int_t k) {return entry.first < k;}); 
+    if (pos != fSpill.end() && pos->first == key) {
+      pos->second += val; 
+      return pos->second;
+    }
+    fSpill.insert(pos, Entry_t(key, val)); 
+    return val;
+  }
+
+  UShort_t ipos = 0; 
+  while (ipos < fNInline && fKey[ipos] < key) ipos++; 
+  if (ipos < fNInline && fKey[ipos] == key) {
+    fVal[ipos] += val; 
+    return fVal[ipos];
+  }
+
+  if (fNInline == kInlineSize) {
+    fSpill.reserve(2*kInlineSize); 
+    for (UShort_t i = 0; i < fNInline; i++) {
+      if (i == ipos) fSpill.emplace_back(key, val); 
+      fSpill.emplace_back(fKey[i], fVal[i]); 
+    }
+    if (ipos == fNInline) fSpill.emplace_back(key, val); 
+    ClearInline(); 
+    return val;
+  }
+  for (UShort_t i = fNInline; i > ipos; i--) {
+    fKey[i] = fKey[i-1]; 
+    fVal[i] = fVal[i-1]; 
+  }
+  fKey[ipos] = key; 
+  fVal[ipos] = val; 
+  fNInline++; 
+  return val;
+}
+
+void SLArBacktrackerCounter::ClearInline()
+{
+  fNInline = 0; 
+  std::fill(fKey, fKey + kInlineSize, 0); 
+  std::fill(fVal, fVal + kInlineSize, 0); 
+}
+
+void SLArBacktrackerCounter::clear()
+{
+  ClearInline(); 
+  fSpill.clear(); 
+}
 
 ClassImp(SLArEventBacktrackerRecord) 
 
@@ -17,11 +84,9 @@ void SLArEventBacktrackerRecord::Reset() {
 
 UShort_t SLArEventBacktrackerRecord::UpdateCounter(const int key, const UShort_t val)
 {
-  fCounter[key] += val;
-  return fCounter[key];
+  return fCounter.Add(key, val);
 }
 
-
 ClassImp(SLArEventBacktrackerVector)
 
 SLArEventBacktrackerVector::SLArEventBacktrackerVector()
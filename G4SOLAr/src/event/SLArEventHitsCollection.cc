@@ -4,6 +4,8 @@
  * @created     : Fri Nov 11, 2022 14:28:03 CET
  */
 
+#include <algorithm>
+#include <tuple>
 #include "event/SLArEventHitsCollection.hh"
 #include "event/SLArEventChargeHit.hh"
 #include "event/SLArEventPhotonHit.hh"
@@ -12,18 +14,20 @@ templateClassImp(SLArEventHitsCollection)
 
 template<class T>
 SLArEventHitsCollection<T>::SLArEventHitsCollection() 
-  : TNamed(), fIdx(0), fIsActive(true), fNhits(0), fClockUnit(1), fBacktrackerRecordSize(0)
+  : TNamed(), fIdx(0), fIsActive(true), fNhits(0), fClockUnit(1), fBacktrackerRecordSize(0), 
+    fStoragePolicy(kMapStorage), fScratchClock(0), fScratchPending(false)
 {}
 
 template<class T>
 SLArEventHitsCollection<T>::SLArEventHitsCollection(const int idx) 
-  : TNamed(), fIdx(idx), fIsActive(true), fNhits(0), fClockUnit(1), fBacktrackerRecordSize(0) {}
+  : TNamed(), fIdx(idx), fIsActive(true), fNhits(0), fClockUnit(1), fBacktrackerRecordSize(0), 
+    fStoragePolicy(kMapStorage), fScratchClock(0), fScratchPending(false) {}
 
 
 template<class T>
 SLArEventHitsCollection<T>::SLArEventHitsCollection(const int idx, const UShort_t clock) 
   : TNamed(), fIdx(idx), fIsActive(true), fNhits(0), fClockUnit(clock), 
-    fBacktrackerRecordSize(0){}
+    fBacktrackerRecordSize(0), fStoragePolicy(kMapStorage), fScratchClock(0), fScratchPending(false) {}
 
 template<class T>
 SLArEventHitsCollection<T>::SLArEventHitsCollection(const SLArEventHitsCollection<T>& other)
@@ -34,6 +38,12 @@ SLArEventHitsCollection<T>::SLArEventHitsCollection(const SLArEventHitsCollectio
   fNhits = other.fNhits; 
   fClockUnit = other.fClockUnit;
   fBacktrackerRecordSize = other.fBacktrackerRecordSize;
+  fStoragePolicy = other.fStoragePolicy; 
+  fHitBuffer = other.fHitBuffer; 
+  fBacktrackerBuffer = other.fBacktrackerBuffer; 
+  other.AppendBacktrackerScratch( fBacktrackerBuffer ); 
+  fScratchClock = 0; 
+  fScratchPending = false; 
 
   if (!other.fHits.empty()) {
     fHits = HitsCollection_t(other.fHits); 
@@ -54,25 +64,97 @@ void SLArEventHitsCollection<T>::Copy(SLArEventHitsCollection& record) const
   record.SetActive( fIsActive ); 
   record.SetClockUnit( fClockUnit ); 
   record.SetNhits( fNhits ); 
+  record.SetStoragePolicy( fStoragePolicy ); 
 
   for (const auto &hit : fHits) {
     record.GetHits()[hit.first] = hit.second;
   }   
 
+  for (const auto &clock : fHitBuffer) {
+    record.GetHits()[clock]++;
+  }
+
   for (const auto &bktv : fBacktrackerCollections) {
     record.GetBacktrackerRecordCollection()[bktv.first] = bktv.second;
   }
 
+  if (fBacktrackerBuffer.empty() == false || fScratchPending) {
+    std::vector<SLArBacktrackerBufferEntry> buffer( fBacktrackerBuffer ); 
+    AppendBacktrackerScratch( buffer ); 
+    MergeBacktrackerBuffer( buffer, record.GetBacktrackerRecordCollection(), fBacktrackerRecordSize ); 
+  }
+
   return;
 }
 
 template<class T>
 int SLArEventHitsCollection<T>::RegisterHit(const T hit) {
-  fHits[ConvertToClock<float>(hit.GetTime())]++; 
+  if (fStoragePolicy == kBufferedStorage) {
+    fHitBuffer.push_back( ConvertToClock<float>(hit.GetTime()) ); 
+  }
+  else {
+    fHits[ConvertToClock<float>(hit.GetTime())]++; 
+  }
   fNhits++; 
   return fNhits;
 }
 
+/**
+ * @details Register n hits falling in the same clock tick of the given 
+ * hit with a single map access (or buffer insertion). 
+ */
+template<class T>
+int SLArEventHitsCollection<T>::RegisterHits(const T& hit, const UShort_t n) {
+  if (n == 0) return fNhits;
+  const Int_t clock = ConvertToClock<float>(hit.GetTime()); 
+  if (fStoragePolicy == kBufferedStorage) {
+    fHitBuffer.insert(fHitBuffer.end(), n, clock); 
+  }
+  else {
+    fHits[clock] += n; 
+  }
+  fNhits += n; 
+  return fNhits;
+}
+
+/**
+ * @details Merge the hits stored in the flat buffer (kBufferedStorage policy)
+ * into the clock map. The buffer is sorted and run-length encoded, so that 
+ * each clock tick is inserted in the map only once and in increasing order. 
+ * The buffered backtracker counts are merged in the same way, with a 
+ * single map insertion per clock tick. 
+ * Must be called before zero suppression and before writing the event. 
+ *
+ * @return number of distinct clock ticks merged in the map
+ */
+template<class T>
+int SLArEventHitsCollection<T>::ConsolidateHits() {
+  FlushBacktrackerScratch(); 
+  if (fBacktrackerBuffer.empty() == false) {
+    MergeBacktrackerBuffer( fBacktrackerBuffer, fBacktrackerCollections, fBacktrackerRecordSize ); 
+    fBacktrackerBuffer.clear(); 
+  }
+
+  if (fHitBuffer.empty()) return 0; 
+
+  std::sort(fHitBuffer.begin(), fHitBuffer.end()); 
+
+  int n_ticks = 0; 
+  auto hint = fHits.begin(); 
+  auto it = fHitBuffer.begin(); 
+  while (it != fHitBuffer.end()) {
+    auto it_end = std::upper_bound(it, fHitBuffer.end(), *it); 
+    hint = fHits.emplace_hint(hint, *it, 0); 
+    hint->second += static_cast<UShort_t>(it_end - it); 
+    ++hint; 
+    it = it_end; 
+    n_ticks++; 
+  }
+
+  fHitBuffer.clear(); 
+  return n_ticks; 
+}
+
 //template<class T>
 //bool SLArEventHitsCollection<T>::SortHits() {
   //std::sort(fHits.begin(), fHits.end(), T::CompareHitPtrs); 
@@ -82,6 +164,10 @@ int SLArEventHitsCollection<T>::RegisterHit(const T hit) {
 template<class T>
 int SLArEventHitsCollection<T>::ResetHits() {
   fHits.clear(); 
+  fHitBuffer.clear(); 
+  fBacktrackerBuffer.clear(); 
+  fBacktrackerScratch.Reset(); 
+  fScratchPending = false; 
   for (auto &b : fBacktrackerCollections) {
     b.second.Reset();
   }
@@ -97,23 +183,45 @@ void SLArEventHitsCollection<T>::PrintHits() const {
   for (auto &hit : fHits) {
     printf("[%u] : %i\n", hit.first*fClockUnit, hit.second);
   }
+  if (!fHitBuffer.empty()) {
+    printf("(%lu hits buffered, not yet consolidated)\n", fHitBuffer.size());
+  }
+  if (!fBacktrackerBuffer.empty() || fScratchPending) {
+    printf("(backtracker counts buffered, not yet consolidated)\n");
+  }
   printf("\n");
 }
 
+/**
+ * @details Return the backtracker records of the given clock tick. 
+ * Under the kBufferedStorage policy the records are a scratch vector 
+ * that collects the backtracker counts of consecutive hits in the same 
+ * clock tick: its counts are moved to the flat backtracker buffer when 
+ * a different clock tick is requested (or by ConsolidateHits), so that 
+ * no map node is created during the event. 
+ */
 template<class T>
 SLArEventBacktrackerVector& SLArEventHitsCollection<T>::GetBacktrackerVector(UShort_t key) {
-  //printf("SLArEventHitsCollection[%i]::GetBacktrackerVector[%u]\n", fIdx, key);
-  auto& bkt_vector = fBacktrackerCollections[key];
-  if (bkt_vector.IsEmpty() == false) {
-    //printf("[%i] Already have a backtrackervector at key: %u\n", fIdx, key);
-    return bkt_vector;
-  }
-  else if (bkt_vector.IsEmpty() && fBacktrackerRecordSize <= 0) {
+  if (fBacktrackerRecordSize <= 0) {
     //printf("BacktrackerRecordSize is %u. I should not be here...\n", 
         //fBacktrackerRecordSize);
     throw 4;
   }
-  else if (bkt_vector.IsEmpty() && fBacktrackerRecordSize > 0) {
+
+  if (fStoragePolicy == kBufferedStorage) {
+    if (fScratchPending && fScratchClock == key) return fBacktrackerScratch; 
+    FlushBacktrackerScratch(); 
+    if (fBacktrackerScratch.GetConstRecords().size() != fBacktrackerRecordSize) {
+      fBacktrackerScratch.InitRecords(fBacktrackerRecordSize); 
+    }
+    fScratchClock = key; 
+    fScratchPending = true; 
+    return fBacktrackerScratch;
+  }
+
+  //printf("SLArEventHitsCollection[%i]::GetBacktrackerVector[%u]\n", fIdx, key);
+  auto& bkt_vector = fBacktrackerCollections[key];
+  if (bkt_vector.IsEmpty()) {
     //printf("initializing backtracker records vector to size %u\n", 
         //fBacktrackerRecordSize);
     bkt_vector.InitRecords(fBacktrackerRecordSize);
@@ -122,9 +230,87 @@ SLArEventBacktrackerVector& SLArEventHitsCollection<T>::GetBacktrackerVector(USh
   return bkt_vector;
 }
 
+/**
+ * @details Move the counts of the scratch backtracker records to the flat
+ * backtracker buffer and reset the scratch records. 
+ */
+template<class T>
+void SLArEventHitsCollection<T>::FlushBacktrackerScratch() {
+  if (fScratchPending == false) return;
+  AppendBacktrackerScratch( fBacktrackerBuffer ); 
+  fBacktrackerScratch.Reset(); 
+  fScratchPending = false; 
+  return;
+}
+
+template<class T>
+void SLArEventHitsCollection<T>::AppendBacktrackerScratch(
+    std::vector<SLArBacktrackerBufferEntry>& buffer) const {
+  if (fScratchPending == false) return;
+  const auto& records = fBacktrackerScratch.GetConstRecords(); 
+  for (size_t ir = 0; ir < records.size(); ir++) {
+    for (const auto entry : records[ir].GetConstCounter()) {
+      buffer.push_back( {fScratchClock, static_cast<UShort_t>(ir), entry.first, entry.second} ); 
+    }
+  }
+  return;
+}
+
+/**
+ * @details Merge a buffer of backtracker counts in a backtracker collection. 
+ * The buffer is sorted by clock tick (counting sort when the tick range 
+ * is comparable with the buffer size), so that each clock tick is 
+ * inserted in the map only once and in increasing order. 
+ */
+template<class T>
+void SLArEventHitsCollection<T>::MergeBacktrackerBuffer(
+    std::vector<SLArBacktrackerBufferEntry>& buffer, 
+    BacktrackerVectorCollection_t& collection, const UShort_t record_size) {
+  if (buffer.empty()) return;
+
+  // counting sort on the clock tick (the order within a tick is irrelevant)
+  const auto clock_range = std::minmax_element(buffer.begin(), buffer.end(), 
+      [](const SLArBacktrackerBufferEntry& a, const SLArBacktrackerBufferEntry& b) {
+        return a.fClock < b.fClock;
+      }); 
+  const Int_t clock_min = clock_range.first->fClock; 
+  const size_t nbins = static_cast<size_t>(clock_range.second->fClock - clock_min) + 1; 
+  if (nbins <= 4*buffer.size()) {
+    std::vector<UInt_t> offset(nbins + 1, 0); 
+    for (const auto& entry : buffer) offset[entry.fClock - clock_min + 1]++;
+    for (size_t ib = 1; ib <= nbins; ib++) offset[ib] += offset[ib-1];
+    std::vector<SLArBacktrackerBufferEntry> sorted(buffer.size()); 
+    for (const auto& entry : buffer) sorted[offset[entry.fClock - clock_min]++] = entry;
+    buffer.swap(sorted); 
+  }
+  else {
+    std::sort(buffer.begin(), buffer.end(), 
+        [](const SLArBacktrackerBufferEntry& a, const SLArBacktrackerBufferEntry& b) {
+          return a.fClock < b.fClock;
+        }); 
+  }
+
+  auto hint = collection.begin(); 
+  for (size_t i = 0; i < buffer.size(); ) {
+    const Int_t clock = buffer[i].fClock; 
+    hint = collection.emplace_hint(hint, std::piecewise_construct, 
+        std::forward_as_tuple(clock), std::forward_as_tuple()); 
+    auto& bkt_vector = hint->second; 
+    if (bkt_vector.IsEmpty()) bkt_vector.InitRecords(record_size); 
+    auto& records = bkt_vector.GetRecords(); 
+    for ( ; i < buffer.size() && buffer[i].fClock == clock; i++) {
+      const auto& entry = buffer[i]; 
+      records.at(entry.fRecord).UpdateCounter(entry.fKey, entry.fCount); 
+    }
+    ++hint; 
+  }
+  return;
+}
+
 template<class T> 
 int SLArEventHitsCollection<T>::ZeroSuppression(const UShort_t threshold) {
   int hits_erased = 0; 
+  ConsolidateHits(); 
   //printf("ZeroSuppression threshold = %u\n", threshold);
   for (auto it = fHits.begin(); it != fHits.end(); ) {
     if (it->second < threshold) {
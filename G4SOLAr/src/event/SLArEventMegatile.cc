@@ -12,7 +12,8 @@ ClassImp(SLArEventMegatile)
 
 SLArEventMegatile::SLArEventMegatile() 
   : fIdx(0), fIsActive(true), fNhits(0), 
-    fLightBacktrackerRecordSize(0), fChargeBacktrackerRecordSize(0)
+    fLightBacktrackerRecordSize(0), fChargeBacktrackerRecordSize(0), 
+    fHitStoragePolicy(kMapStorage)
 {}
 
 SLArEventMegatile::SLArEventMegatile(const SLArEventMegatile& right) 
@@ -23,6 +24,7 @@ SLArEventMegatile::SLArEventMegatile(const SLArEventMegatile& right)
   fIsActive = right.fIsActive; 
   fLightBacktrackerRecordSize = right.fLightBacktrackerRecordSize;
   fChargeBacktrackerRecordSize = right.fChargeBacktrackerRecordSize;
+  fHitStoragePolicy = right.fHitStoragePolicy; 
   for (const auto &evtile : right.fTilesMap) {
     fTilesMap[evtile.first] = evtile.second;
   }
@@ -52,6 +54,15 @@ int SLArEventMegatile::ResetHits() {
 }
 
 
+int SLArEventMegatile::ConsolidateHits() {
+  int n_ticks = 0; 
+  for (auto &tile : fTilesMap) {
+    n_ticks += tile.second.ConsolidateHits(); 
+  }
+  return n_ticks; 
+}
+
+
 SLArEventMegatile::~SLArEventMegatile()
 {
   ResetHits();
@@ -82,6 +93,7 @@ SLArEventTile& SLArEventMegatile::GetOrCreateEventTile(const int& tileId)
     auto& t_event = fTilesMap[tileId];
     t_event.SetBacktrackerRecordSize( fLightBacktrackerRecordSize ); 
     t_event.SetChargeBacktrackerRecordSize( fChargeBacktrackerRecordSize ); 
+    t_event.SetStoragePolicy( fHitStoragePolicy ); 
     return t_event;
   }
 }
@@ -100,6 +112,16 @@ SLArEventTile& SLArEventMegatile::RegisterHit(const SLArEventPhotonHit& hit, con
   return tile_ev;
 }
 
+/**
+ * @details Register the hit in a tile of this megatile already retrieved 
+ * with GetOrCreateEventTile, skipping the tile map lookup. 
+ */
+SLArEventTile& SLArEventMegatile::RegisterHit(const SLArEventPhotonHit& hit, SLArEventTile& tile_ev) {
+  fNhits++; 
+  tile_ev.RegisterHit(hit);
+  return tile_ev;
+}
+
 int SLArEventMegatile::GetNPhotonHits() const {
   int nhits = 0;
   for (const auto &tile : fTilesMap) {
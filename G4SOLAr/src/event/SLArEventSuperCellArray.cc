@@ -72,6 +72,16 @@ SLArEventSuperCell& SLArEventSuperCellArray::RegisterHit(const SLArEventPhotonHi
   //}
 }
 
+/**
+ * @details Register the hit in a SuperCell of this array already retrieved 
+ * with GetOrCreateEventSuperCell, skipping the SuperCell map lookup. 
+ */
+SLArEventSuperCell& SLArEventSuperCellArray::RegisterHit(const SLArEventPhotonHit& hit, SLArEventSuperCell& sc_event) {
+  sc_event.RegisterHit(hit); 
+  fNhits++;
+  return sc_event;
+}
+
 int SLArEventSuperCellArray::ResetHits() {
   int nn = 0; 
   for (auto &sc : fSuperCellMap) {
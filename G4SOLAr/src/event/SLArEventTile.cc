@@ -48,6 +48,19 @@ int SLArEventTile::ResetHits()
 }
 
 
+/**
+ * @details Merge the buffered photon hits of the tile and the buffered 
+ * charge hits of its pixels in the respective clock maps
+ */
+int SLArEventTile::ConsolidateHits()
+{
+  int n_ticks = SLArEventHitsCollection::ConsolidateHits(); 
+  for (auto &pix : fPixelHits) {
+    n_ticks += pix.second.ConsolidateHits(); 
+  }
+  return n_ticks; 
+}
+
 SLArEventTile::~SLArEventTile() {
   ResetHits();
 }
@@ -108,13 +121,14 @@ void SLArEventTile::PrintHits() const
   return;
 }
 
-SLArEventChargePixel& SLArEventTile::RegisterChargeHit(const int& pixID, const SLArEventChargeHit& qhit) {
+SLArEventChargePixel& SLArEventTile::RegisterChargeHit(const int& pixID, const SLArEventChargeHit& qhit, const UShort_t n) {
   
   auto it = fPixelHits.find(pixID);
 
   if (it != fPixelHits.end()) {
     //printf("SLArEventTile::RegisterChargeHit(%i): pixel %i already hit.\n", pixID, pixID);
-    it->second.RegisterHit(qhit); 
+    if (n == 1) it->second.RegisterHit(qhit); 
+    else it->second.RegisterHits(qhit, n); 
     return it->second;
   }
   else {
@@ -122,6 +136,8 @@ SLArEventChargePixel& SLArEventTile::RegisterChargeHit(const int& pixID, const S
     fPixelHits.insert(std::make_pair(pixID, SLArEventChargePixel(pixID, qhit)));
     auto& pixEv = fPixelHits[pixID];
     pixEv.SetBacktrackerRecordSize( fChargeBacktrackerRecordSize ); 
+    pixEv.SetStoragePolicy( fStoragePolicy ); 
+    if (n > 1) pixEv.RegisterHits(qhit, n-1); 
     return pixEv;  
   }
 
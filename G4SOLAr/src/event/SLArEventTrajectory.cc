@@ -16,13 +16,13 @@ SLArEventTrajectory::SLArEventTrajectory() :
   fPDGID(0), fTrackID(-1), fParentID(-1), 
   fInitKineticEnergy(0.), fOriginVolCopyNo(0), fTrackLength(0.), fTime(0.), fWeight(1.),
   fInitMomentum(TVector3(0,0,0)), 
-  fTotalEdep(0.), fTotalNph(0.), fTotalNel(0.)
+  fTotalEdep(0.), fTotalNph(0.), fTotalNel(0.), fPooled(false)
 {
   fTrjPoints.reserve(500);
 }
 
 SLArEventTrajectory::SLArEventTrajectory(const SLArEventTrajectory& trj) 
-  : TObject(trj)
+  : TObject(trj), fPooled(false)
 {
   //printf("Creating new SLArEventTrajectory with copy costructor\n");
   //printf("trk ID %i, PDG ID %i - trj size %lu\n", 
@@ -52,6 +52,20 @@ SLArEventTrajectory::SLArEventTrajectory(const SLArEventTrajectory& trj)
   
 }
 
+SLArEventTrajectory::SLArEventTrajectory(SLArEventTrajectory&& trj) 
+  : TObject(trj), 
+  fStoreTrajectoryPts(trj.fStoreTrajectoryPts),
+  fParticleName(std::move(trj.fParticleName)), 
+  fCreatorProcess(std::move(trj.fCreatorProcess)), 
+  fEndProcess(std::move(trj.fEndProcess)), 
+  fPDGID(trj.fPDGID), fTrackID(trj.fTrackID), fParentID(trj.fParentID), 
+  fOriginVolCopyNo(trj.fOriginVolCopyNo), fInitKineticEnergy(trj.fInitKineticEnergy), 
+  fTrackLength(trj.fTrackLength), fTime(trj.fTime), fWeight(trj.fWeight), 
+  fInitMomentum(trj.fInitMomentum), fTrjPoints(std::move(trj.fTrjPoints)), 
+  fTotalEdep(trj.fTotalEdep), fTotalNph(trj.fTotalNph), fTotalNel(trj.fTotalNel), 
+  fPooled(false)
+{}
+
 SLArEventTrajectory::~SLArEventTrajectory()
 {
   fParticleName = "noName";
@@ -63,6 +77,33 @@ SLArEventTrajectory::~SLArEventTrajectory()
   fTrjPoints.clear();
 }
 
+/**
+ * @details Restore the default values of a trajectory handed out again 
+ * by a SLArEventTrajectoryArena. The points are cleared but the capacity
+ * of the point buffer is kept. 
+ */
+void SLArEventTrajectory::Reset()
+{
+  fStoreTrajectoryPts = false;
+  fParticleName = "noName";
+  fCreatorProcess = "noCreator";
+  fEndProcess = "noDestroyer";
+  fPDGID = 0;
+  fTrackID = -1;
+  fParentID = -1;
+  fOriginVolCopyNo = 0;
+  fInitKineticEnergy = 0.;
+  fTrackLength = 0.;
+  fTime = 0.;
+  fWeight = 1.;
+  fInitMomentum.SetXYZ(0, 0, 0);
+  fTrjPoints.clear();
+  fTotalEdep = 0.;
+  fTotalNph = 0.;
+  fTotalNel = 0.;
+  return;
+}
+
 void SLArEventTrajectory::RegisterPoint(const trj_point& point) {
   fTrjPoints.push_back( point ); 
   return; 
@@ -74,6 +115,36 @@ void SLArEventTrajectory::RegisterPoint(double x, double y, double z, double ene
   return;
 }
 
+/**
+ * @details Hand out the next free slot of the arena, allocating a new 
+ * trajectory only when all the slots kept from the previous events are
+ * in use. The returned trajectory is reset to its default values. 
+ */
+SLArEventTrajectory* SLArEventTrajectoryArena::Acquire()
+{
+  if (fNext == fSlots.size()) {
+    fSlots.emplace_back(); 
+    fSlots.back().fPooled = true;
+  }
+  SLArEventTrajectory* trj = &fSlots[fNext++]; 
+  trj->Reset(); 
+  return trj;
+}
+
+/**
+ * @details Pre-allocate n trajectory slots, using the number of 
+ * trajectories of the previous event as a hint (see SLArMCTruth::Swap). 
+ * The slots already handed out are not moved. 
+ */
+void SLArEventTrajectoryArena::Reserve(const size_t n)
+{
+  while (fSlots.size() < n) {
+    fSlots.emplace_back(); 
+    fSlots.back().fPooled = true;
+  }
+  return;
+}
+
 ClassImp(SLArEventTrajectoryLite)
 
 SLArEventTrajectoryLite::SLArEventTrajectoryLite() 
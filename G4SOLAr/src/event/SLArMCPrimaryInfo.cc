@@ -130,4 +130,15 @@ int SLArMCPrimaryInfo::RegisterTrajectory(const SLArEventTrajectory& trj)
   return (int)fTrajectories.size();
 }
 
+/**
+ * @details Register a trajectory without copying it. Trajectories handed
+ * out by a SLArEventTrajectoryArena are not deleted when the primary is 
+ * cleared, the others are owned by the primary. 
+ */
+int SLArMCPrimaryInfo::RegisterTrajectory(SLArEventTrajectory* trj)
+{
+  fTotalEdep += trj->GetTotalEdep(); 
+  fTrajectories.push_back( trj );
+  return (int)fTrajectories.size();
+}
 
@@ -0,0 +1,225 @@
+/**
+ * @author      : Daniele Guffanti (daniele.guffanti@mib.infn.it)
+ * @file        : SLArAliasSampler.cc
+ * @created     : Saturday Oct 17, 2026 21:12:40 CEST
+ */
+
+#include <cstdio>
+#include <cmath>
+
+#include "gen/SLArAliasSampler.hh"
+
+SLArAliasSampler::SLArAliasSampler()
+  : fDimension(0), fInterpolation(kUniform), fNBinsX(0),
+    fSourceNCells(0), fSourceEntries(0.)
+{}
+
+SLArAliasSampler::SLArAliasSampler(const TH1& h, const EInterpolation interp)
+  : SLArAliasSampler()
+{
+  Build(h, interp);
+}
+
+/**
+ * @details Build the alias tables (Vose's algorithm) from the content of
+ * the histogram bins, under/overflows excluded. Only the bins with a
+ * positive content enter the tables; negative contents are treated as
+ * zero, as a probability cannot be negative.
+ *
+ * With the linear interpolation, the density inside each bin goes linearly
+ * from the average of the bin and of the previous one (density, i.e.
+ * content over bin area) to the average with the next one, flat at the
+ * histogram borders. The probability of each bin is always its content,
+ * so the interpolation only reshapes the distribution inside the bin.
+ * For 2D histograms the interpolation is applied separately along the
+ * two axes, using the neighbours in the same row and column.
+ *
+ * @return true if the tables have been built
+ */
+bool SLArAliasSampler::Build(const TH1& h, const EInterpolation interp)
+{
+  fProb.clear(); fAlias.clear(); fCell.clear();
+  fSlopeX.clear(); fSlopeY.clear();
+  fEdgesX.clear(); fEdgesY.clear();
+
+  fDimension = h.GetDimension();
+  fInterpolation = interp;
+  fSourceNCells = h.GetNcells();
+  fSourceEntries = h.GetEntries();
+
+  if (fDimension > 2) {
+    printf("SLArAliasSampler::Build ERROR: %s has dimension %i, only 1D and 2D histograms are supported\n",
+        h.GetName(), fDimension);
+    return false;
+  }
+
+  const TAxis* xaxis = h.GetXaxis();
+  const TAxis* yaxis = h.GetYaxis();
+  fNBinsX = xaxis->GetNbins();
+  const int nbins_y = (fDimension == 2) ? yaxis->GetNbins() : 1;
+
+  for (int i = 1; i <= fNBinsX+1; i++) fEdgesX.push_back( xaxis->GetBinLowEdge(i) );
+  if (fDimension == 2) {
+    for (int i = 1; i <= nbins_y+1; i++) fEdgesY.push_back( yaxis->GetBinLowEdge(i) );
+  }
+
+  // bin contents (as probability masses) and densities
+  const size_t n_cells = (size_t)fNBinsX * nbins_y;
+  std::vector<double> mass(n_cells, 0.);
+  std::vector<double> density(n_cells, 0.);
+  double total = 0.;
+  size_t n_negative = 0;
+  size_t n_positive = 0;
+  for (int iy = 0; iy < nbins_y; iy++) {
+    const double wy = (fDimension == 2) ? fEdgesY[iy+1] - fEdgesY[iy] : 1.;
+    for (int ix = 0; ix < fNBinsX; ix++) {
+      const size_t cell = ix + (size_t)fNBinsX*iy;
+      const int bin = (fDimension == 2) ? h.GetBin(ix+1, iy+1) : h.GetBin(ix+1);
+      double content = h.GetBinContent(bin);
+      if (content < 0) {n_negative++; content = 0.;}
+      if (content > 0) n_positive++;
+      mass[cell] = content;
+      density[cell] = content / ((fEdgesX[ix+1] - fEdgesX[ix]) * wy);
+      total += content;
+    }
+  }
+
+  if (n_negative > 0) {
+    printf("SLArAliasSampler::Build WARNING: %lu bins of %s with negative content set to zero\n",
+        n_negative, h.GetName());
+  }
+  if (total <= 0.) {
+    printf("SLArAliasSampler::Build ERROR: %s has no positive bin content\n", h.GetName());
+    return false;
+  }
+
+  fProb.reserve(n_positive);
+  fAlias.reserve(n_positive);
+  fCell.reserve(n_positive);
+  for (size_t cell = 0; cell < n_cells; cell++) {
+    if (mass[cell] > 0) fCell.push_back( cell );
+  }
+
+  // Vose's alias method
+  const size_t n = fCell.size();
+  std::vector<double> scaled(n);
+  std::vector<uint32_t> small, large;
+  small.reserve(n); large.reserve(n);
+  for (size_t i = 0; i < n; i++) {
+    scaled[i] = mass[fCell[i]] * n / total;
+    if (scaled[i] < 1.) small.push_back(i);
+    else large.push_back(i);
+  }
+  fProb.assign(n, 1.);
+  fAlias.resize(n);
+  for (size_t i = 0; i < n; i++) fAlias[i] = i;
+
+  while (!small.empty() && !large.empty()) {
+    const uint32_t s = small.back(); small.pop_back();
+    const uint32_t l = large.back();
+    fProb[s] = scaled[s];
+    fAlias[s] = l;
+    scaled[l] = (scaled[l] + scaled[s]) - 1.;
+    if (scaled[l] < 1.) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  // what is left has probability one up to rounding errors, which
+  // fProb already holds
+
+  if (fInterpolation == kLinear) {
+    fSlopeX.resize(n);
+    if (fDimension == 2) fSlopeY.resize(n);
+    for (size_t i = 0; i < n; i++) {
+      const size_t cell = fCell[i];
+      const int ix = cell % fNBinsX;
+      const int iy = cell / fNBinsX;
+      const double d = density[cell];
+
+      double lo = (ix > 0) ? 0.5*(d + density[cell-1]) : d;
+      double hi = (ix < fNBinsX-1) ? 0.5*(d + density[cell+1]) : d;
+      fSlopeX[i] = (hi - lo) / (hi + lo);
+
+      if (fDimension == 2) {
+        lo = (iy > 0) ? 0.5*(d + density[cell-fNBinsX]) : d;
+        hi = (iy < nbins_y-1) ? 0.5*(d + density[cell+fNBinsX]) : d;
+        fSlopeY[i] = (hi - lo) / (hi + lo);
+      }
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @details Check whether the histogram looks like the one used to build
+ * the tables (same number of cells and entries). Any SetBinContent or
+ * Fill call changes the number of entries, while a Scale does not change
+ * the sampled distribution.
+ */
+bool SLArAliasSampler::IsBuiltFrom(const TH1& h) const
+{
+  return h.GetDimension() == fDimension &&
+    h.GetNcells() == fSourceNCells &&
+    h.GetEntries() == fSourceEntries;
+}
+
+size_t SLArAliasSampler::SampleCell(TRandom* engine) const
+{
+  const size_t n = fProb.size();
+  size_t i = static_cast<size_t>( engine->Rndm() * n );
+  if (i >= n) i = n-1;
+  return (engine->Rndm() < fProb[i]) ? i : fAlias[i];
+}
+
+/**
+ * @details Invert the cumulative of the in-bin density 1 + slope*(2t-1),
+ * t in [0, 1]. The form used avoids the division by the slope.
+ */
+double SLArAliasSampler::SampleInBin(const double u, const double slope)
+{
+  const double b = 1. - slope;
+  const double den = b + std::sqrt(b*b + 4.*slope*u);
+  return (den > 0.) ? 2.*u / den : 0.;
+}
+
+/**
+ * @details Sample a value from a 1D histogram (or the x value of a 2D
+ * histogram). Returns zero if the tables are empty, as TH1::GetRandom.
+ */
+double SLArAliasSampler::Sample(TRandom* engine) const
+{
+  if (fProb.empty()) return 0.;
+
+  const size_t i = SampleCell(engine);
+  const int ix = fCell[i] % fNBinsX;
+  const double u = engine->Rndm();
+  const double t = (fInterpolation == kLinear) ? SampleInBin(u, fSlopeX[i]) : u;
+  return fEdgesX[ix] + t*(fEdgesX[ix+1] - fEdgesX[ix]);
+}
+
+void SLArAliasSampler::Sample(TRandom* engine, double& x, double& y) const
+{
+  x = 0.; y = 0.;
+  if (fProb.empty()) return;
+  if (fDimension != 2) {
+    x = Sample(engine);
+    return;
+  }
+
+  const size_t i = SampleCell(engine);
+  const int ix = fCell[i] % fNBinsX;
+  const int iy = fCell[i] / fNBinsX;
+  const double ux = engine->Rndm();
+  const double uy = engine->Rndm();
+  double tx = ux, ty = uy;
+  if (fInterpolation == kLinear) {
+    tx = SampleInBin(ux, fSlopeX[i]);
+    ty = SampleInBin(uy, fSlopeY[i]);
+  }
+  x = fEdgesX[ix] + tx*(fEdgesX[ix+1] - fEdgesX[ix]);
+  y = fEdgesY[iy] + ty*(fEdgesY[iy+1] - fEdgesY[iy]);
+  return;
+}
+
@@ -290,7 +290,7 @@ G4double SLArBaseGenerator::SampleEnergy(EnergyConfig_t& ene_config) {
       G4Exception("SLArBaseGenerator::SampleEnergy", "NoEnergySpectrum", FatalException, 
           "Attempting to sample from an external energy spectrum but no spectrum has been configured.");
     }
-    ene_config.energy_tmp = fEnergySpectrum->GetRandom( slar_random->GetEngine().get() ) * ene_config.energy_unit; 
+    ene_config.energy_tmp = slar_random->SampleFromHist( fEnergySpectrum.get() ) * ene_config.energy_unit; 
   }
 
   return ene_config.energy_tmp;
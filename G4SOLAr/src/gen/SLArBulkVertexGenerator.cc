@@ -31,9 +31,14 @@ SLArBulkVertexGenerator::SLArBulkVertexGenerator(const SLArBulkVertexGenerator&
   fNoDaughters = origin.fNoDaughters; 
   fFVFraction = origin.fFVFraction; 
 
+  fUseVoxelMap = origin.fUseVoxelMap; 
+  fVoxelSize = origin.fVoxelSize; 
+  fVoxelMapCacheDir = origin.fVoxelMapCacheDir; 
+
   fSolid = origin.fSolid; 
   fBulkInverseRotation = origin.fBulkInverseRotation; 
   fCounter = origin.fCounter; 
+  fVoxelMap = origin.fVoxelMap; 
 }
 
 SLArBulkVertexGenerator::~SLArBulkVertexGenerator()
@@ -131,21 +136,41 @@ void SLArBulkVertexGenerator::ShootVertex(G4ThreeVector & vertex_)
     //printf("delta = %g\n", delta);
   }
 
-  auto navigator = G4TransportationManager::GetTransportationManager()->GetNavigator("World"); 
-
   //G4ThreeVector localVertex;
   G4Point3D localVertex;
-  G4String localMaterial; 
   G4int maxtries=100000, itry=1;
-  do {
-    localVertex.set(
-        lo.x() + 0.5*delta + G4UniformRand()*(hi.x()-lo.x()-delta),
-        lo.y() + 0.5*delta + G4UniformRand()*(hi.y()-lo.y()-delta),
-        lo.z() + 0.5*delta + G4UniformRand()*(hi.z()-lo.z()-delta));
+  if (fUseVoxelMap) {
+    if (fVoxelMap == nullptr) {
+      const G4ThreeVector half_delta(0.5*delta, 0.5*delta, 0.5*delta); 
+      BuildVoxelMap(lo + half_delta, hi - half_delta); 
+    }
 
-    G4VPhysicalVolume* vol = navigator->LocateGlobalPointAndSetup(localVertex);
-    localMaterial = vol->GetLogicalVolume()->GetMaterial()->GetName();
-  } while (!fSolid->Inside(localVertex) && ++itry < maxtries && strcmp(fMaterial, localMaterial) != 0) ;
+    // only the points in partially accepted voxels need to be checked
+    G4ThreeVector point; 
+    G4bool is_partial = false; 
+    do {
+      fVoxelMap->SamplePoint(point, is_partial); 
+      localVertex.set(point.x(), point.y(), point.z()); 
+    } while (is_partial && !IsValidVertex(localVertex) && ++itry < maxtries);
+  }
+  else {
+    auto navigator = G4TransportationManager::GetTransportationManager()->GetNavigator("World"); 
+
+    G4String localMaterial; 
+    do {
+      localVertex.set(
+          lo.x() + 0.5*delta + G4UniformRand()*(hi.x()-lo.x()-delta),
+          lo.y() + 0.5*delta + G4UniformRand()*(hi.y()-lo.y()-delta),
+          lo.z() + 0.5*delta + G4UniformRand()*(hi.z()-lo.z()-delta));
+
+      G4VPhysicalVolume* vol = navigator->LocateGlobalPointAndSetup(localVertex);
+      localMaterial = vol->GetLogicalVolume()->GetMaterial()->GetName();
+    } while (!fSolid->Inside(localVertex) && ++itry < maxtries && strcmp(fMaterial, localMaterial) != 0) ;
+  }
+
+  if (itry >= maxtries) {
+    printf("SLArBulkVertexGenerator::ShootVertex WARNING: no valid vertex found after %i tries\n", maxtries); 
+  }
 
   HepGeom::Point3D<G4double> vtx(localVertex.x(), localVertex.y(), localVertex.z());
   //Randomizer
@@ -165,6 +190,68 @@ void SLArBulkVertexGenerator::ShootVertex(G4ThreeVector & vertex_)
   fCounter++;
 }
 
+/**
+ * @brief Build (or read from the cache) the voxel occupancy map of the volume
+ *
+ * @param lo lower corner of the sampling box (solid frame)
+ * @param hi upper corner of the sampling box (solid frame)
+ */
+void SLArBulkVertexGenerator::BuildVoxelMap(const G4ThreeVector& lo, const G4ThreeVector& hi)
+{
+  const G4String material = fRequireMaterialMatch ? fMaterial : G4String(); 
+  const size_t hash = SLArVoxelAcceptanceMap::ComputeGeometryHash(
+      fLogVol, lo, hi, fVoxelSize, fNoDaughters, material); 
+
+  fVoxelMap = std::make_shared<SLArVoxelAcceptanceMap>(); 
+
+  G4String cache_path; 
+  if (fVoxelMapCacheDir.empty() == false) {
+    char file_name[300]; 
+    snprintf(file_name, sizeof(file_name), "%s/vtxmap_%s_%016lx.bin", 
+        fVoxelMapCacheDir.data(), fLogVol->GetName().data(), hash); 
+    cache_path = file_name; 
+    if (fVoxelMap->Load(cache_path, hash)) {
+      std::clog << "[log] SLArBulkVertexGenerator::BuildVoxelMap: voxel map read from " << cache_path << "\n";
+      return;
+    }
+  }
+
+  fVoxelMap->Build(fLogVol, lo, hi, fVoxelSize, fNoDaughters, material); 
+  if (fVoxelMap->IsEmpty()) {
+    char err_msg[200]; 
+    snprintf(err_msg, sizeof(err_msg),
+        "SLArBulkVertexGenerator::BuildVoxelMap Error.\nNo valid voxel found in %s.\n", fLogVol->GetName().data());
+    throw std::runtime_error(err_msg);
+  }
+
+  if (cache_path.empty() == false) fVoxelMap->Save(cache_path); 
+  return;
+}
+
+/**
+ * @brief Check if a point (solid frame) is a valid vertex
+ *
+ * The point must be inside the solid and, if required, outside the 
+ * daughter volumes and in a volume made of the requested material. 
+ * Daughters and materials are checked with the navigator at the position 
+ * of the point in the first placement of the volume. 
+ */
+G4bool SLArBulkVertexGenerator::IsValidVertex(const G4Point3D& localVertex) const
+{
+  if (fSolid->Inside(localVertex) == kOutside) return false; 
+  if (fNoDaughters == false && fRequireMaterialMatch == false) return true; 
+
+  auto navigator = G4TransportationManager::GetTransportationManager()->GetNavigator("World"); 
+  const G4Point3D globalVertex = fBulkTransformVec.at(0) * localVertex; 
+  const G4VPhysicalVolume* vol = navigator->LocateGlobalPointAndSetup(globalVertex); 
+  if (vol == nullptr) return false; 
+
+  const G4LogicalVolume* lv = vol->GetLogicalVolume(); 
+  if (fNoDaughters && lv != fLogVol) return false; 
+  if (fRequireMaterialMatch && lv->GetMaterial()->GetName() != fMaterial) return false; 
+  return true;
+}
+
 double SLArBulkVertexGenerator::ComputeDeltaX(
     const G4ThreeVector& lo, const G4ThreeVector& hi) const {
   return ComputeDeltaX(lo, hi, fFVFraction);
@@ -270,6 +357,23 @@ void SLArBulkVertexGenerator::Config(const rapidjson::Value& cfg) {
   if ( cfg.HasMember("time") ) {
     fTimeGen.SourceConfiguration( cfg["time"] );
   }
+  if (cfg.HasMember("sampler")) {
+    const G4String sampler = cfg["sampler"].GetString(); 
+    if (sampler == "voxel") fUseVoxelMap = true; 
+    else if (sampler == "rejection") fUseVoxelMap = false; 
+    else {
+      throw std::invalid_argument("Unknown bulk vtx generator \"sampler\" (must be \"rejection\" or \"voxel\").\n"); 
+    }
+  }
+  if (cfg.HasMember("voxel_size")) {
+    fVoxelSize = unit::ParseJsonVal( cfg["voxel_size"] ); 
+    if (fVoxelSize <= 0) {
+      throw std::invalid_argument("Invalid bulk vtx generator \"voxel_size\".\n"); 
+    }
+  }
+  if (cfg.HasMember("voxel_map_cache")) {
+    fVoxelMapCacheDir = cfg["voxel_map_cache"].GetString(); 
+  }
   if (cfg.HasMember("mother")) {
     fMotherVolumeName = cfg["mother"].GetString();
     Config(fTargetVolumeName, fMotherVolumeName);
@@ -307,6 +411,7 @@ const rapidjson::Document SLArBulkVertexGenerator::ExportConfig() const {
   vtx_info.AddMember("logical_volume", str_logic_vol, vtx_info.GetAllocator()); 
   
   vtx_info.AddMember("fiducial_volume_fraction", fFVFraction, vtx_info.GetAllocator()); 
+  vtx_info.AddMember("sampler", rapidjson::StringRef(fUseVoxelMap ? "voxel" : "rejection"), vtx_info.GetAllocator()); 
 
   rapidjson::Value volume_val( rapidjson::kObjectType ); 
   volume_val.AddMember("val", GetCubicVolumeGenerator()/CLHEP::cm3, vtx_info.GetAllocator()); 
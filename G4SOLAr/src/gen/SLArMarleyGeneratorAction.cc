@@ -20,6 +20,9 @@
 #include <iostream>
 #include <fstream>
 #include <cstdio>
+#include <algorithm>
+#include <iterator>
+#include <cmath>
 
 #include "G4Event.hh"
 #include "G4ParticleTable.hh"
@@ -55,8 +58,24 @@
 
 namespace gen {
 namespace marley {
+SLArOscillogramNeutrinoSource::SLArOscillogramNeutrinoSource(int pid, 
+    const std::vector<double>& edges, const std::vector<double>& envelope) 
+  : ::marley::NeutrinoSource(pid), fEdges(edges), fEnvelope(envelope), 
+    fActiveSource(nullptr)
+{}
+
+double SLArOscillogramNeutrinoSource::pdf(double E) const 
+{
+  if (fActiveSource) return fActiveSource->pdf(E); 
+
+  if (E < fEdges.front() || E > fEdges.back()) return 0.0;
+  size_t ibin = std::upper_bound(fEdges.begin(), fEdges.end(), E) - fEdges.begin(); 
+  ibin = std::min(std::max(ibin, size_t(1)), fEnvelope.size()) - 1;
+  return fEnvelope[ibin];
+}
+
 SLArMarleyGeneratorAction::SLArMarleyGeneratorAction(const G4String label) 
-  : SLArBaseGenerator(label)
+  : SLArBaseGenerator(label), fOscillogramSource(nullptr), fEPdfBound(0.0)
 {
   fHalfLifeTable = {
         //{ 0.0298299*CLHEP::MeV, 4.25*CLHEP::ns },
@@ -178,6 +197,170 @@ void SLArMarleyGeneratorAction::SetupMarleyGen()
   //fMarleyGenerator.reseed( run_seed ); 
 }
 
+/**
+ * @brief Build the energy spectrum and the MARLEY source of a nadir bin
+ */
+SLArMarleyGeneratorAction::NadirBinSource_t& SLArMarleyGeneratorAction::BuildNadirBinSource(const int ibin_nadir)
+{
+  auto& entry = fNadirCache.at(ibin_nadir); 
+  entry.spectrum = std::unique_ptr<TH1D>(
+      fOscillogram->ProjectionX(Form("energy_hist_nadir%i", ibin_nadir), ibin_nadir, ibin_nadir) );
+  entry.spectrum->SetDirectory(nullptr); 
+  entry.source = 
+    ::marley_root::make_root_neutrino_source( fMarleyGenerator.get_source().get_pid(), 
+        entry.spectrum.get() );
+  return entry; 
+}
+
+/**
+ * @brief Return the MARLEY source of the given nadir bin
+ *
+ * The sources are built on first use and kept in a cache with one slot per 
+ * nadir bin. When the cache holds more than `oscillogram_cache_size` bins 
+ * the least recently used one is released. 
+ */
+const ::marley::NeutrinoSource* SLArMarleyGeneratorAction::GetNadirBinSource(const int ibin_nadir)
+{
+  auto& entry = fNadirCache.at(ibin_nadir); 
+  if (entry.source) {
+    fNadirCacheLRU.splice(fNadirCacheLRU.begin(), fNadirCacheLRU, entry.lru_itr); 
+    return entry.source.get(); 
+  }
+
+  const size_t max_entries = (fConfig.oscillogram_cache_size > 0) ? 
+    fConfig.oscillogram_cache_size : fNadirCache.size(); 
+  while (fNadirCacheLRU.size() >= max_entries) {
+    auto& last = fNadirCache.at( fNadirCacheLRU.back() ); 
+    last.source.reset(); 
+    last.spectrum.reset(); 
+    fNadirCacheLRU.pop_back(); 
+  }
+
+  BuildNadirBinSource(ibin_nadir); 
+  fNadirCacheLRU.push_front(ibin_nadir); 
+  entry.lru_itr = fNadirCacheLRU.begin(); 
+  CheckNadirBinSource(ibin_nadir); 
+  return entry.source.get(); 
+}
+
+/**
+ * @brief Return the maximum of the MARLEY energy pdf (flux × cross section)
+ * of the current source on the lower edge, center and upper edge of each 
+ * energy bin of the oscillogram
+ */
+double SLArMarleyGeneratorAction::ScanEPdfMax()
+{
+  const TAxis* energy_axis = fOscillogram->GetXaxis(); 
+  double e_pdf_max = 0.0; 
+  for (int i = 1; i <= energy_axis->GetNbins(); i++) {
+    const double e_low = energy_axis->GetBinLowEdge(i); 
+    const double e_up = std::nextafter(energy_axis->GetBinUpEdge(i), e_low); 
+    for (const double energy : {e_low, energy_axis->GetBinCenter(i), e_up}) {
+      e_pdf_max = std::max(e_pdf_max, fMarleyGenerator.E_pdf(energy)); 
+    }
+  }
+  return e_pdf_max; 
+}
+
+/**
+ * @brief Verify that the energy pdf of a nadir bin stays below the bound 
+ * of the energy rejection sampling, which would be otherwise biased
+ */
+void SLArMarleyGeneratorAction::CheckNadirBinSource(const int ibin_nadir)
+{
+  auto& entry = fNadirCache.at(ibin_nadir); 
+  if (entry.checked || fEPdfBound <= 0.0 || !entry.source) return;
+
+  fOscillogramSource->SetActiveSource( entry.source.get() ); 
+  const double e_pdf_max = ScanEPdfMax(); 
+  fOscillogramSource->SetActiveSource( nullptr ); 
+  entry.checked = true; 
+
+  if (e_pdf_max > fEPdfBound * (1.0 + 1e-9)) {
+    G4Exception("SLArMarleyGeneratorAction::CheckNadirBinSource", "OscillogramBound", 
+        FatalException, 
+        Form("Energy pdf of nadir bin %i (max %g) exceeds the rejection sampling bound %g", 
+          ibin_nadir, e_pdf_max, fEPdfBound)); 
+  }
+  return;
+}
+
+/**
+ * @brief Hand the oscillogram source to the MARLEY generator
+ *
+ * The spectra of all the nadir bins are scanned once to tabulate their 
+ * envelope (on the edges and centers of the energy bins, where the 
+ * piecewise constant/linear spectra reach their maximum), raised by 
+ * kEnvelopeMargin. MARLEY computes the maximum of the energy pdf 
+ * (flux × cross section) lazily, at the first event after set_source(): 
+ * a first event is therefore generated here with no nadir bin selected, 
+ * so that the bound of the energy rejection sampling is set on the 
+ * envelope. The margin absorbs the tolerance of the numerical maximization
+ * of the (discontinuous) envelope pdf. 
+ * Each bin spectrum is checked against the bound when its source is built 
+ * for the first time: as long as the bound holds, selecting the bin 
+ * spectrum for each event samples the same energy distribution of a 
+ * generator set up from scratch with that spectrum. 
+ * With `oscillogram_prebuild` the scanned sources are kept in the cache 
+ * (up to the cache size), otherwise they are built again on first use. 
+ */
+void SLArMarleyGeneratorAction::SetupOscillogramSource()
+{
+  const int n_nadir_bins = fOscillogram->GetNbinsY(); 
+  const int n_energy_bins = fOscillogram->GetNbinsX(); 
+  const TAxis* energy_axis = fOscillogram->GetXaxis(); 
+
+  fNadirCacheLRU.clear(); 
+  fNadirCache.clear(); 
+  fNadirCache.resize(n_nadir_bins+2); 
+  const size_t max_entries = (fConfig.oscillogram_cache_size > 0) ? 
+    fConfig.oscillogram_cache_size : fNadirCache.size(); 
+
+  std::vector<double> edges(n_energy_bins+1, 0.0); 
+  std::vector<double> envelope(n_energy_bins, 0.0); 
+  for (int i = 0; i <= n_energy_bins; i++) edges[i] = energy_axis->GetBinLowEdge(i+1); 
+
+  for (int ibin_nadir = 0; ibin_nadir <= n_nadir_bins+1; ibin_nadir++) {
+    if (fOscillogram->Integral(1, n_energy_bins, ibin_nadir, ibin_nadir) <= 0) continue;
+
+    auto& entry = BuildNadirBinSource(ibin_nadir); 
+    for (int i = 0; i < n_energy_bins; i++) {
+      const double pdf_max = std::max( {entry.source->pdf(edges[i]), 
+          entry.source->pdf(energy_axis->GetBinCenter(i+1)), entry.source->pdf(edges[i+1])} ); 
+      envelope[i] = std::max(envelope[i], pdf_max); 
+    }
+
+    if (fConfig.oscillogram_prebuild && fNadirCacheLRU.size() < max_entries) {
+      fNadirCacheLRU.push_back(ibin_nadir); 
+      entry.lru_itr = std::prev(fNadirCacheLRU.end()); 
+    }
+    else {
+      entry.source.reset(); 
+      entry.spectrum.reset(); 
+    }
+  }
+
+  const double kEnvelopeMargin = 0.01; 
+  for (auto& pdf : envelope) pdf *= (1.0 + kEnvelopeMargin); 
+
+  auto source = std::make_unique<SLArOscillogramNeutrinoSource>(
+      fMarleyGenerator.get_source().get_pid(), edges, envelope); 
+  fOscillogramSource = source.get(); 
+  fMarleyGenerator.set_source( std::move(source) ); 
+
+  // fix the rejection sampling bound on the envelope
+  fOscillogramSource->SetActiveSource( nullptr ); 
+  fMarleyGenerator.create_event(); 
+  // the bin spectra must stay below the envelope without the margin, 
+  // which is left to the tolerance of the MARLEY maximization
+  fEPdfBound = ScanEPdfMax() / (1.0 + kEnvelopeMargin); 
+  for (const int ibin_nadir : fNadirCacheLRU) CheckNadirBinSource(ibin_nadir); 
+
+  printf("SLArMarleyGenerator::SetupOscillogramSource(): %i nadir bins, %lu sources cached\n", 
+      n_nadir_bins, fNadirCacheLRU.size()); 
+  return;
+}
+
 double SLArMarleyGeneratorAction::SampleDecayTime(const double half_life) const  {
   return CLHEP::RandExponential::shoot( half_life / log(2) ); 
 }
@@ -205,15 +388,9 @@ void SLArMarleyGeneratorAction::GeneratePrimaries(G4Event* anEvent)
     fDirGen->GetTmpDirection().z()};
 
   if (fOscillogram) {
-    // build neutrino energy pdf given cos(nadir)
+    // select the neutrino energy pdf given cos(nadir)
     const int ibin_nadir = fOscillogram->GetYaxis()->FindBin( fDirGen->GetTmpCosNadir() ); 
-    std::unique_ptr<TH1D> energy_hist = std::unique_ptr<TH1D>(
-        fOscillogram->ProjectionX("energy_hist", ibin_nadir, ibin_nadir) );
-    // setup generator
-    auto marley_source = 
-      ::marley_root::make_root_neutrino_source( fMarleyGenerator.get_source().get_pid(), 
-          energy_hist.get() );
-    fMarleyGenerator.set_source( std::move(marley_source) );
+    fOscillogramSource->SetActiveSource( GetNadirBinSource(ibin_nadir) ); 
   }
 
   fMarleyGenerator.set_neutrino_direction(dir); 
@@ -320,6 +497,8 @@ void SLArMarleyGeneratorAction::Configure() {
   }
 
   SetupMarleyGen(); 
+
+  if (fOscillogram) SetupOscillogramSource(); 
 }
 
 void SLArMarleyGeneratorAction::SourceConfiguration(const rapidjson::Value& config) {
@@ -363,7 +542,14 @@ void SLArMarleyGeneratorAction::SourceConfiguration(const rapidjson::Value& conf
   }
 
   if (config.HasMember("oscillogram")) {
-    fConfig.oscillogram_info.Configure( config["oscillogram"] ); 
+    const auto& josc = config["oscillogram"]; 
+    fConfig.oscillogram_info.Configure( josc ); 
+    if (josc.HasMember("cache_size")) {
+      fConfig.oscillogram_cache_size = josc["cache_size"].GetInt(); 
+    }
+    if (josc.HasMember("prebuild")) {
+      fConfig.oscillogram_prebuild = josc["prebuild"].GetBool(); 
+    }
   }
 
   if (fVtxGen == nullptr) {
@@ -74,3 +74,35 @@ std::array<G4ThreeVector,2> SLArRandom::SampleRandomDirectionAndPolarization() {
   return {p_dir, polarization}; 
 }
 
+
+/**
+ * @details Return the alias sampler of the given histogram, building it
+ * the first time the histogram is sampled or when its content changed.
+ * The samplers are cached by histogram address: call ClearHistSamplers()
+ * before deleting a histogram that could be replaced by a new one at the
+ * same address with the same binning and number of entries.
+ */
+const SLArAliasSampler& SLArRandom::GetHistSampler(const TH1& h) {
+  auto& sampler = fHistSamplers[&h];
+  if (sampler == nullptr) {
+    sampler = std::make_unique<SLArAliasSampler>(h);
+  }
+  else if (sampler->IsBuiltFrom(h) == false) {
+    sampler->Build(h);
+  }
+  return *sampler;
+}
+
+/**
+ * @details Sample a value from the histogram with the alias method, using
+ * the TRandom3 engine seeded from the Geant4 engine. The value is linearly
+ * interpolated within the sampled bin.
+ */
+G4double SLArRandom::SampleFromHist(const TH1& h) {
+  return GetHistSampler(h).Sample( fRandomEngine.get() );
+}
+
+void SLArRandom::SampleFromHist(const TH2& h, G4double& x, G4double& y) {
+  GetHistSampler(h).Sample( fRandomEngine.get(), x, y );
+  return;
+}
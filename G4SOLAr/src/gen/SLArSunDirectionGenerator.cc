@@ -31,7 +31,7 @@ namespace gen{
         printf("SLArSunDirectionGenerator::ShootDirection() Sourcing nadir angle distribution\n"); 
         printf("fNadirDistribution ptr: %p\n", fNadirDistribution.get());
       }
-      const double cos_nadir = fNadirDistribution->GetRandom( slar_random->GetEngine().get() );
+      const double cos_nadir = slar_random->SampleFromHist( fNadirDistribution.get() );
       const double sin_nadir = sqrt(1-cos_nadir*cos_nadir); 
       const double theta = 102.5*TMath::DegToRad(); 
       const double cos_theta = cos( theta ); 
@@ -0,0 +1,266 @@
+/**
+ * @author      : Daniele Guffanti (daniele.guffanti@mib.infn.it)
+ * @file        : SLArVoxelAcceptanceMap.cc
+ * @created     : Saturday Oct 17, 2026 20:58:02 CEST
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cfloat>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <functional>
+
+#include "SLArVoxelAcceptanceMap.hh"
+
+#include "G4VSolid.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4Material.hh"
+#include "G4Transform3D.hh"
+#include "Randomize.hh"
+
+namespace gen {
+namespace vertex {
+
+namespace {
+  const char kMapMagic[8] = "SLVXMAP";
+  const uint32_t kMapVersion = 1;
+
+  struct voxel_box_t {
+    G4ThreeVector lo;
+    G4ThreeVector hi;
+    inline bool Overlaps(const voxel_box_t& other) const {
+      return (lo.x() < other.hi.x() && other.lo.x() < hi.x() &&
+              lo.y() < other.hi.y() && other.lo.y() < hi.y() &&
+              lo.z() < other.hi.z() && other.lo.z() < hi.z());
+    }
+  };
+
+  // bounding box of a daughter volume in the mother frame
+  voxel_box_t get_daughter_box(const G4VPhysicalVolume* pv,
+      const G4ThreeVector& mother_lo, const G4ThreeVector& mother_hi) {
+    voxel_box_t box = {mother_lo, mother_hi};
+    if (pv->IsReplicated() || pv->IsParameterised()) return box;
+
+    G4ThreeVector dlo, dhi;
+    pv->GetLogicalVolume()->GetSolid()->BoundingLimits(dlo, dhi);
+    const G4Transform3D transform(pv->GetObjectRotationValue(), pv->GetObjectTranslation());
+
+    box.lo.set(DBL_MAX, DBL_MAX, DBL_MAX);
+    box.hi.set(-DBL_MAX, -DBL_MAX, -DBL_MAX);
+    for (int i = 0; i < 8; i++) {
+      const HepGeom::Point3D<double> corner(
+          (i & 1) ? dhi.x() : dlo.x(),
+          (i & 2) ? dhi.y() : dlo.y(),
+          (i & 4) ? dhi.z() : dlo.z());
+      const HepGeom::Point3D<double> p = transform * corner;
+      box.lo.set(std::min(box.lo.x(), p.x()), std::min(box.lo.y(), p.y()), std::min(box.lo.z(), p.z()));
+      box.hi.set(std::max(box.hi.x(), p.x()), std::max(box.hi.y(), p.y()), std::max(box.hi.z(), p.z()));
+    }
+    return box;
+  }
+}
+
+SLArVoxelAcceptanceMap::SLArVoxelAcceptanceMap()
+  : fGeometryHash(0), fLo(), fWidth(), fNBins{0, 0, 0}, fNPartial(0)
+{}
+
+/**
+ * @details Hash of the volume description (solid parameters, material,
+ * placement of the daughters) and of the map parameters, used to check that
+ * a cached map matches the current geometry.
+ */
+size_t SLArVoxelAcceptanceMap::ComputeGeometryHash(const G4LogicalVolume* lv,
+    const G4ThreeVector& lo, const G4ThreeVector& hi, const G4double voxel_size,
+    const G4bool check_daughters, const G4String& material)
+{
+  std::ostringstream descr;
+  descr.precision(9);
+  descr << lv->GetName() << " " << lv->GetMaterial()->GetName() << "\n";
+  lv->GetSolid()->StreamInfo(descr);
+  for (size_t i = 0; i < lv->GetNoDaughters(); i++) {
+    const G4VPhysicalVolume* pv = lv->GetDaughter(i);
+    descr << pv->GetName() << " " << pv->GetLogicalVolume()->GetMaterial()->GetName()
+      << " " << pv->GetObjectTranslation() << " " << pv->GetObjectRotationValue() << "\n";
+    pv->GetLogicalVolume()->GetSolid()->StreamInfo(descr);
+  }
+  descr << lo << " " << hi << " " << voxel_size << " " << check_daughters << " " << material;
+
+  return std::hash<std::string>{}( descr.str() );
+}
+
+/**
+ * @details Classify the voxels of the box [lo, hi] (solid frame) of the
+ * given logical volume. If check_daughters is true, points inside the
+ * daughter volumes are not valid vertexes (the voxels overlapping a
+ * daughter are partially accepted). If a material is given, the points
+ * outside the daughters are valid only if the volume material matches.
+ */
+void SLArVoxelAcceptanceMap::Build(const G4LogicalVolume* lv,
+    const G4ThreeVector& lo, const G4ThreeVector& hi, const G4double voxel_size,
+    const G4bool check_daughters, const G4String& material)
+{
+  fGeometryHash = ComputeGeometryHash(lv, lo, hi, voxel_size, check_daughters, material);
+  fVoxels.clear();
+  fPartial.clear();
+  fNPartial = 0;
+
+  fLo = lo;
+  const G4ThreeVector size = hi - lo;
+  for (int i = 0; i < 3; i++) {
+    fNBins[i] = std::max(1, static_cast<int>(std::ceil(size[i] / voxel_size)));
+    fWidth[i] = size[i] / fNBins[i];
+  }
+
+  const G4VSolid* solid = lv->GetSolid();
+  const G4bool check_material = (material.empty() == false);
+  const G4bool mother_material_ok =
+    (check_material == false) || (lv->GetMaterial()->GetName() == material);
+
+  std::vector<voxel_box_t> daughter_boxes;
+  if (check_daughters || check_material) {
+    for (size_t i = 0; i < lv->GetNoDaughters(); i++) {
+      daughter_boxes.push_back( get_daughter_box(lv->GetDaughter(i), lo, hi) );
+    }
+  }
+
+  const G4double half_diagonal = 0.5*fWidth.mag();
+  for (int iz = 0; iz < fNBins[2]; iz++) {
+    for (int iy = 0; iy < fNBins[1]; iy++) {
+      for (int ix = 0; ix < fNBins[0]; ix++) {
+        const voxel_box_t box = {
+          G4ThreeVector(lo.x() + ix*fWidth.x(), lo.y() + iy*fWidth.y(), lo.z() + iz*fWidth.z()),
+          G4ThreeVector(lo.x() + (ix+1)*fWidth.x(), lo.y() + (iy+1)*fWidth.y(), lo.z() + (iz+1)*fWidth.z())};
+        const G4ThreeVector center = 0.5*(box.lo + box.hi);
+
+        // position w.r.t. the solid surface
+        const EInside inside = solid->Inside(center);
+        if (inside == kOutside && solid->DistanceToIn(center) >= half_diagonal) continue;
+        G4bool is_partial = !(inside == kInside && solid->DistanceToOut(center) >= half_diagonal);
+
+        // daughters and material
+        const G4bool overlaps_daughter = std::any_of(daughter_boxes.begin(), daughter_boxes.end(),
+            [&box](const voxel_box_t& dbox) {return box.Overlaps(dbox);});
+        if (overlaps_daughter) is_partial = true;
+        else if (mother_material_ok == false) continue;
+
+        fVoxels.push_back( ix + fNBins[0]*(iy + static_cast<uint32_t>(fNBins[1])*iz) );
+        fPartial.push_back( is_partial );
+        if (is_partial) fNPartial++;
+      }
+    }
+  }
+
+  printf("SLArVoxelAcceptanceMap::Build: %s - %i x %i x %i voxels, %lu non-empty (%lu partial)\n",
+      lv->GetName().data(), fNBins[0], fNBins[1], fNBins[2], fVoxels.size(), fNPartial);
+  return;
+}
+
+/**
+ * @details Sample a point uniformly in a random non-empty voxel. If the
+ * voxel is partially accepted the point must be checked by the caller,
+ * and on failure a new voxel must be sampled (not a new point in the same
+ * voxel) to keep the vertex distribution uniform.
+ */
+G4bool SLArVoxelAcceptanceMap::SamplePoint(G4ThreeVector& point, G4bool& is_partial) const
+{
+  if (fVoxels.empty()) return false;
+
+  const size_t n_voxels = fVoxels.size();
+  const size_t ivoxel = std::min(static_cast<size_t>(G4UniformRand()*n_voxels), n_voxels-1);
+  const uint32_t idx = fVoxels[ivoxel];
+  const int ix = idx % fNBins[0];
+  const int iy = (idx / fNBins[0]) % fNBins[1];
+  const int iz = idx / (fNBins[0]*fNBins[1]);
+
+  point.set(
+      fLo.x() + (ix + G4UniformRand())*fWidth.x(),
+      fLo.y() + (iy + G4UniformRand())*fWidth.y(),
+      fLo.z() + (iz + G4UniformRand())*fWidth.z());
+  is_partial = fPartial[ivoxel];
+  return true;
+}
+
+/**
+ * @details Write the map to a binary file. The file is written to a
+ * temporary path and then renamed, so that concurrent writers (e.g. the
+ * worker threads) never leave a truncated cache file.
+ */
+G4bool SLArVoxelAcceptanceMap::Save(const G4String& file_path) const
+{
+  const G4String tmp_path = file_path + ".tmp" + std::to_string(std::hash<const void*>{}(this));
+  std::ofstream out(tmp_path.data(), std::ios::binary);
+  if (!out.good()) {
+    printf("SLArVoxelAcceptanceMap::Save WARNING: cannot write %s\n", tmp_path.data());
+    return false;
+  }
+
+  const uint64_t hash = fGeometryHash;
+  const uint64_t n_voxels = fVoxels.size();
+  const double lo[3] = {fLo.x(), fLo.y(), fLo.z()};
+  const double width[3] = {fWidth.x(), fWidth.y(), fWidth.z()};
+  out.write(kMapMagic, sizeof(kMapMagic));
+  out.write(reinterpret_cast<const char*>(&kMapVersion), sizeof(kMapVersion));
+  out.write(reinterpret_cast<const char*>(&hash), sizeof(hash));
+  out.write(reinterpret_cast<const char*>(lo), sizeof(lo));
+  out.write(reinterpret_cast<const char*>(width), sizeof(width));
+  out.write(reinterpret_cast<const char*>(fNBins), sizeof(fNBins));
+  out.write(reinterpret_cast<const char*>(&n_voxels), sizeof(n_voxels));
+  out.write(reinterpret_cast<const char*>(fVoxels.data()), n_voxels*sizeof(uint32_t));
+  out.write(reinterpret_cast<const char*>(fPartial.data()), n_voxels*sizeof(uint8_t));
+  out.close();
+
+  if (out.fail() || std::rename(tmp_path.data(), file_path.data()) != 0) {
+    printf("SLArVoxelAcceptanceMap::Save WARNING: cannot write %s\n", file_path.data());
+    std::remove(tmp_path.data());
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @return true if the file exists and matches the given geometry hash
+ */
+G4bool SLArVoxelAcceptanceMap::Load(const G4String& file_path, const size_t geometry_hash)
+{
+  std::ifstream in(file_path.data(), std::ios::binary);
+  if (!in.good()) return false;
+
+  char magic[sizeof(kMapMagic)] = {};
+  uint32_t version = 0;
+  uint64_t hash = 0, n_voxels = 0;
+  double lo[3] = {0., 0., 0.}, width[3] = {0., 0., 0.};
+  G4int nbins[3] = {0, 0, 0};
+  in.read(magic, sizeof(magic));
+  in.read(reinterpret_cast<char*>(&version), sizeof(version));
+  in.read(reinterpret_cast<char*>(&hash), sizeof(hash));
+  if (!in.good() || std::memcmp(magic, kMapMagic, sizeof(kMapMagic)) != 0 ||
+      version != kMapVersion || hash != geometry_hash) return false;
+
+  in.read(reinterpret_cast<char*>(lo), sizeof(lo));
+  in.read(reinterpret_cast<char*>(width), sizeof(width));
+  in.read(reinterpret_cast<char*>(nbins), sizeof(nbins));
+  in.read(reinterpret_cast<char*>(&n_voxels), sizeof(n_voxels));
+  std::vector<uint32_t> voxels(n_voxels);
+  std::vector<uint8_t> partial(n_voxels);
+  in.read(reinterpret_cast<char*>(voxels.data()), n_voxels*sizeof(uint32_t));
+  in.read(reinterpret_cast<char*>(partial.data()), n_voxels*sizeof(uint8_t));
+  if (!in.good()) {
+    printf("SLArVoxelAcceptanceMap::Load WARNING: %s is truncated\n", file_path.data());
+    return false;
+  }
+
+  fGeometryHash = hash;
+  fLo.set(lo[0], lo[1], lo[2]);
+  fWidth.set(width[0], width[1], width[2]);
+  std::copy(nbins, nbins+3, fNBins);
+  fVoxels = std::move(voxels);
+  fPartial = std::move(partial);
+  fNPartial = std::count(fPartial.begin(), fPartial.end(), 1);
+  return true;
+}
+
+}
+}
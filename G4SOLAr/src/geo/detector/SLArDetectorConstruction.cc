@@ -65,11 +65,16 @@
  * @param geometry_cfg_file Geometry configuration file 
  * @param material_db_file Material description table
  */
+G4ThreadLocal std::vector<SLArDetectorConstruction::SLArPhotonSD>* 
+  SLArDetectorConstruction::fPhotonSDTable = nullptr;
+
 SLArDetectorConstruction::SLArDetectorConstruction(
     G4String geometry_cfg_file, G4String material_db_file)
   : G4VUserDetectorConstruction(),
   fGeometryCfgFile(""), 
   fMaterialDBFile(""),
+  fUsePixelLookup(true), 
+  fPixelLookupValidationPoints(0),
   fExpHall(nullptr),
   fSuperCell(nullptr),
   fWorldLog(nullptr), 
@@ -648,6 +653,8 @@ G4VPhysicalVolume* SLArDetectorConstruction::Construct()
   visAttributes->SetColor(0.25,0.54,0.79, 0.0);
   fWorldLog->SetVisAttributes(visAttributes);
 
+  // the readout configuration is complete: freeze it with dense lookup tables
+  SLArAnalysisManager::Instance()->BuildCfgIndexTables();
   SLArAnalysisManager::Instance()->CreateEventStructure();
 
   //always return the physical World
@@ -702,6 +709,8 @@ void SLArDetectorConstruction::ConstructSDandField()
     }
   }
 
+  if (fPhotonSDTable) fPhotonSDTable->clear(); 
+
   //Set ReadoutTile SD
   if (fReadoutTile) {
     G4VSensitiveDetector* sipmSD
@@ -709,6 +718,7 @@ void SLArDetectorConstruction::ConstructSDandField()
     SDman->AddNewDetector(sipmSD);
     SetSensitiveDetector(
         fReadoutTile->GetSiPMActive()->GetModLV(), sipmSD );
+    RegisterPhotonSD(fReadoutTile->GetSiPMActive()->GetModLV(), sipmSD, kReadoutTilePhotonSD); 
   }
 
   //Set SuperCell SD
@@ -718,6 +728,7 @@ void SLArDetectorConstruction::ConstructSDandField()
     SDman->AddNewDetector(superCellSD); 
     SetSensitiveDetector(
         fSuperCell->GetCoating()->GetModLV(), superCellSD );
+    RegisterPhotonSD(fSuperCell->GetCoating()->GetModLV(), superCellSD, kSuperCellPhotonSD); 
   }
 
   // Set LAr-volume SD
@@ -734,6 +745,23 @@ void SLArDetectorConstruction::ConstructSDandField()
 
 }
 
+/**
+ * @details Store the sensitive detector and its type at the position of 
+ * the logical volume instance ID, so that the stepping action can trigger
+ * the photon detectors on a Detection boundary status with an array 
+ * lookup. The sensitive detectors are thread-local, as is the table. 
+ */
+void SLArDetectorConstruction::RegisterPhotonSD(const G4LogicalVolume* lv, 
+    G4VSensitiveDetector* sd, const EPhotonSD type)
+{
+  if (fPhotonSDTable == nullptr) fPhotonSDTable = new std::vector<SLArPhotonSD>(); 
+  const size_t id = lv->GetInstanceID(); 
+  if (id >= fPhotonSDTable->size()) fPhotonSDTable->resize(id+1); 
+  (*fPhotonSDTable)[id].fType = type; 
+  (*fPhotonSDTable)[id].fSD = sd; 
+  return;
+}
+
 void SLArDetectorConstruction::AddExternalScorer(const G4String phys_volume_name, const G4String alias)
 {
   // sensitive detectors 
@@ -975,14 +1003,59 @@ void SLArDetectorConstruction::ConstructAnodeMap() {
     anodeCfg.RegisterMap(1, hMapTile); 
     anodeCfg.RegisterMap(2, hMapPixel); 
 
+    anodeCfg.BuildPixelLookup(); 
+    anodeCfg.SetUsePixelLookup( fUsePixelLookup ); 
+
     delete mtile_rot;
     delete mtile_rot_inv; 
   }
 
+  if (fPixelLookupValidationPoints > 0) {
+    ValidatePixelLookup( fPixelLookupValidationPoints ); 
+  }
+
   printf("SLArDetectorConstruction::ConstructAnodeMap() DONE \n");
   return; 
 }
 
+void SLArDetectorConstruction::SetUsePixelLookup(const G4bool use_lookup) {
+  fUsePixelLookup = use_lookup; 
+
+  auto ana_mgr = SLArAnalysisManager::Instance(); 
+  for (auto& anodeCfg_ : ana_mgr->GetAnodeCfg()) {
+    anodeCfg_.second.SetUsePixelLookup( use_lookup ); 
+  }
+  return;
+}
+
+/**
+ * @details Set the number of random points used to cross-check the 
+ * pixel lookup against the TH2Poly maps. If the anode maps are already
+ * constructed the validation is performed immediately, otherwise it 
+ * is performed at the end of SLArDetectorConstruction::ConstructAnodeMap.
+ */
+void SLArDetectorConstruction::SetPixelLookupValidation(const G4int n_points) {
+  fPixelLookupValidationPoints = n_points; 
+  if (fWorldPhys) ValidatePixelLookup( n_points ); 
+  return;
+}
+
+G4int SLArDetectorConstruction::ValidatePixelLookup(const G4int n_points) const {
+  auto ana_mgr = SLArAnalysisManager::Instance(); 
+  G4int n_mismatch = 0; 
+  for (auto& anodeCfg_ : ana_mgr->GetAnodeCfg()) {
+    n_mismatch += anodeCfg_.second.ValidatePixelLookup( n_points ); 
+  }
+
+  if (n_mismatch > 0) {
+    G4ExceptionDescription msg; 
+    msg << "Pixel lookup and TH2Poly maps disagree on " << n_mismatch << " points"; 
+    G4Exception("SLArDetectorConstruction::ValidatePixelLookup()", 
+        "PixelLookup001", JustWarning, msg); 
+  }
+  return n_mismatch;
+}
+
 G4VIStore* SLArDetectorConstruction::CreateImportanceStore() {
 
   printf("World volume ------------------------------------\n");
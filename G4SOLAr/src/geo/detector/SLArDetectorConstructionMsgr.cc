@@ -7,6 +7,8 @@
 #include "detector/SLArDetectorConstructionMsgr.hh"
 #include "detector/SLArDetectorConstruction.hh"
 #include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
 
 
 SLArDetectorConstructionMsgr::SLArDetectorConstructionMsgr(SLArDetectorConstruction* det)
@@ -17,10 +19,23 @@ SLArDetectorConstructionMsgr::SLArDetectorConstructionMsgr(SLArDetectorConstruct
     fCmdCheckOverlaps->SetGuidance("Usage: /geometry/checkOverlaps [fatal|warn]");
     fCmdCheckOverlaps->SetParameterName("mode", false);
     fCmdCheckOverlaps->SetCandidates("fatal warn");
+
+    fCmdUsePixelLookup = new G4UIcmdWithABool("/SLAr/geometry/usePixelLookup", this);
+    fCmdUsePixelLookup->SetGuidance("Use the constant-time lookup tables to find the anode pixel");
+    fCmdUsePixelLookup->SetGuidance("instead of the TH2Poly maps search (default: true)");
+    fCmdUsePixelLookup->SetParameterName("use_lookup", false);
+
+    fCmdValidatePixelLookup = new G4UIcmdWithAnInteger("/SLAr/geometry/validatePixelLookup", this);
+    fCmdValidatePixelLookup->SetGuidance("Cross-check the pixel lookup against the TH2Poly maps");
+    fCmdValidatePixelLookup->SetGuidance("on the given number of random points");
+    fCmdValidatePixelLookup->SetParameterName("n_points", false);
+    fCmdValidatePixelLookup->SetRange("n_points>0");
 }
 
 SLArDetectorConstructionMsgr::~SLArDetectorConstructionMsgr() {
     delete fCmdCheckOverlaps;
+    delete fCmdUsePixelLookup;
+    delete fCmdValidatePixelLookup;
 }
 
 void SLArDetectorConstructionMsgr::SetNewValue(G4UIcommand* cmd, G4String val) {
@@ -33,6 +48,12 @@ void SLArDetectorConstructionMsgr::SetNewValue(G4UIcommand* cmd, G4String val) {
             G4cerr << "Unknown mode: " << val << ". Use 'fatal' or 'warn'." << G4endl;
         }
     }
+    else if (cmd == fCmdUsePixelLookup) {
+        fDetector->SetUsePixelLookup( G4UIcmdWithABool::GetNewBoolValue(val) );
+    }
+    else if (cmd == fCmdValidatePixelLookup) {
+        fDetector->SetPixelLookupValidation( G4UIcmdWithAnInteger::GetNewIntValue(val) );
+    }
 }
 
 
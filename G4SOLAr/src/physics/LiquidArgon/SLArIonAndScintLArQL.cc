@@ -1,6 +1,8 @@
 #include "LiquidArgon/SLArIonAndScintLArQL.h"
 #include "G4MaterialPropertiesTable.hh"
 #include <iostream>
+#include <algorithm>
+#include <cstdio>
 
 
 SLArIonAndScintLArQL::SLArIonAndScintLArQL() : 
@@ -83,12 +85,191 @@ double SLArIonAndScintLArQL::ComputeIonYield(const double& energy_deposit, const
   return ComputeIonYield(dEdx, electric_field);
 }
 
+/**
+ * @details Charge yield (electrons/MeV). In kTabulated mode the escape 
+ * term Corr*QChi*Qinf is interpolated in the lookup table, which is built
+ * at the first call and rebuilt when the electric field moves outside the
+ * field range of the table (e.g. after a /SLAr/scint/electricField command). 
+ * The Birks term has no transcendental functions and is always evaluated
+ * analytically. Steps with dE/dx above the table range, close to the QChi
+ * pole or without electric field fall back to the analytic parametrization. As in the analytic
+ * path, dEdx is clamped to 1 MeV/cm on return. 
+ */
 double SLArIonAndScintLArQL::ComputeIonYield(double& dEdx, const double& electric_field) const {
+  if (fMode == kTabulated && electric_field > 0. && dEdx <= fTableDEdxMax) {
+    if (fTable.Covers(dEdx, electric_field) == false) BuildTable(electric_field); 
+    if (fTable.IsBuilt() && fTable.NearPole(dEdx) == false) {
+      const double QB = QBirks(dEdx, electric_field); 
+      if (dEdx < 1.) dEdx = 1.;
+      return QB + fTable.Eval(dEdx, electric_field); 
+    }
+  }
+  return ComputeIonYieldAnalytic(dEdx, electric_field); 
+}
+
+double SLArIonAndScintLArQL::ComputeIonYieldAnalytic(double& dEdx, const double& electric_field) const {
   double QB = QBirks(dEdx, electric_field); 
   double QX = Corr(dEdx, electric_field)*QChi(dEdx, electric_field)*Qinf();
   return (QB + QX); 
 }
 
+double SLArIonAndScintLArQL::EscapeNumerator(const double& dEdx, const double& E) const {
+  return exp(-E/(fLArQLAlpha *log(dEdx) + fLArQLBeta)) * fLArQLChiPars[0] * Qinf(); 
+}
+
+double SLArIonAndScintLArQL::EscapeDenominator(const double& dEdx) const {
+  return fLArQLChiPars[1]+exp(fLArQLChiPars[2] + fLArQLChiPars[3]*dEdx); 
+}
+
+void SLArIonAndScintLArQL::SetTableAccuracy(const double& accuracy) {
+  if (accuracy <= 0.) {
+    printf("SLArIonAndScintLArQL::SetTableAccuracy WARNING: accuracy must be positive (%g). Ignored.\n", accuracy); 
+    return;
+  }
+  fTableAccuracy = accuracy; 
+  fTable = SLArLArQLTable(); 
+}
+
+void SLArIonAndScintLArQL::SetTableDEdxMax(const double& dEdx_max) {
+  if (dEdx_max <= 1.) {
+    printf("SLArIonAndScintLArQL::SetTableDEdxMax WARNING: the table starts at 1 MeV/cm (%g). Ignored.\n", dEdx_max); 
+    return;
+  }
+  fTableDEdxMax = dEdx_max; 
+  fTable = SLArLArQLTable(); 
+}
+
+/**
+ * @details Build the lookup table of the escape term on a regular grid 
+ * with dE/dx in [1, fTableDEdxMax] MeV/cm and field in the range 
+ * electric_field*(1 ± fTableFieldSpan). Starting from a coarse grid, the 
+ * number of nodes along each axis is doubled until the deviation of the 
+ * interpolated charge yield from the analytic one, relative to the charge
+ * yield, is below fTableAccuracy at the centers of the cell edges, or 
+ * the table reaches 2^20 nodes. 
+ *
+ * The QChi parametrization can have a pole in the dE/dx range (the 
+ * default parameters put it at about 2.3 MeV/cm), so the numerator and
+ * the denominator of the escape term are tabulated separately. Close to
+ * the pole the relative error of the interpolated denominator diverges:
+ * the points of the cell where the denominator changes sign for which the
+ * estimated interpolation error exceeds the target are excluded from the 
+ * accuracy check and evaluated analytically (see SLArLArQLTable::NearPole).
+ *
+ * @return true if the table has been built
+ */
+bool SLArIonAndScintLArQL::BuildTable(const double& electric_field) const {
+  if (electric_field <= 0.) return false;
+
+  const size_t max_nodes = 1 << 20; 
+  const double span = std::clamp(fTableFieldSpan, 1e-3, 0.99); 
+
+  SLArLArQLTable table; 
+  table.fDEdxMin = 1.; 
+  table.fDEdxMax = fTableDEdxMax; 
+  table.fFieldMin = electric_field * (1. - span); 
+  table.fFieldMax = electric_field * (1. + span); 
+
+  auto relative_deviation = [&](const double& dEdx, const double& E) {
+    double x = dEdx; 
+    const double QB = QBirks(x, E); 
+    const double QX = EscapeNumerator(x, E) / EscapeDenominator(x); 
+    return fabs(table.Eval(x, E) - QX) / (QB + fabs(QX)); 
+  }; 
+
+  int n_dedx = 33; 
+  int n_field = 3; 
+  while (true) {
+    table.fNDEdx = n_dedx; 
+    table.fNField = n_field; 
+    const double step_dedx = (table.fDEdxMax - table.fDEdxMin) / (n_dedx - 1); 
+    const double step_field = (table.fFieldMax - table.fFieldMin) / (n_field - 1); 
+    table.fInvStepDEdx = 1. / step_dedx; 
+    table.fInvStepField = 1. / step_field; 
+    table.fNum.resize( (size_t)n_dedx * n_field ); 
+    table.fDen.resize( n_dedx ); 
+    for (int i = 0; i < n_dedx; i++) {
+      const double dEdx = table.fDEdxMin + i*step_dedx; 
+      table.fDen[i] = EscapeDenominator(dEdx); 
+      for (int j = 0; j < n_field; j++) {
+        table.fNum[i + (size_t)n_dedx*j] = EscapeNumerator(dEdx, table.fFieldMin + j*step_field); 
+      }
+    }
+
+    table.fPoleMin = table.fPoleMax = 0.; 
+    for (int i = 0; i < n_dedx-1; i++) {
+      if (table.fDen[i] * table.fDen[i+1] > 0.) continue;
+      // the interpolation error of the denominator is ~ h^2 |f''| / 8: 
+      // keep the points where it is larger than fTableAccuracy*|f|
+      const double x0 = table.fDEdxMin + i*step_dedx; 
+      const double slope = (table.fDen[i+1] - table.fDen[i]) * table.fInvStepDEdx; 
+      const double x_pole = (slope != 0.) ? x0 - table.fDen[i] / slope : x0; 
+      const double curv = fabs(EscapeDenominator(x0 + step_dedx) - 2*EscapeDenominator(x0 + 0.5*step_dedx) 
+          + EscapeDenominator(x0)) * 4. * table.fInvStepDEdx * table.fInvStepDEdx; 
+      const double half_width = (slope != 0.) ? 
+        2. * curv * step_dedx * step_dedx / (8. * fabs(slope) * fTableAccuracy) : step_dedx; 
+      table.fPoleMin = std::max(x_pole - half_width, x0); 
+      table.fPoleMax = std::min(x_pole + half_width, x0 + step_dedx); 
+      break;
+    }
+
+    double dev_dedx = 0.; 
+    double dev_field = 0.; 
+    for (int j = 0; j < n_field; j++) {
+      const double E = table.fFieldMin + j*step_field; 
+      for (int i = 0; i < n_dedx-1; i++) {
+        const double dEdx = table.fDEdxMin + (i+0.5)*step_dedx; 
+        if (table.NearPole(dEdx)) continue;
+        dev_dedx = std::max(dev_dedx, relative_deviation(dEdx, E)); 
+      }
+    }
+    for (int j = 0; j < n_field-1; j++) {
+      const double E = table.fFieldMin + (j+0.5)*step_field; 
+      for (int i = 0; i < n_dedx; i++) {
+        const double dEdx = table.fDEdxMin + i*step_dedx; 
+        if (table.NearPole(dEdx)) continue;
+        dev_field = std::max(dev_field, relative_deviation(dEdx, E)); 
+      }
+    }
+    table.fAccuracy = std::max(dev_dedx, dev_field); 
+    if (table.fAccuracy <= fTableAccuracy) break;
+
+    const int next_dedx = (dev_dedx > fTableAccuracy) ? 2*n_dedx-1 : n_dedx; 
+    const int next_field = (dev_field > fTableAccuracy) ? 2*n_field-1 : n_field; 
+    if ( (size_t)next_dedx * next_field > max_nodes ) {
+      printf("SLArIonAndScintLArQL::BuildTable WARNING: accuracy target %g not reached (%g) with %i x %i nodes\n", 
+          fTableAccuracy, table.fAccuracy, n_dedx, n_field); 
+      break;
+    }
+    n_dedx = next_dedx; 
+    n_field = next_field; 
+  }
+
+  fTable = std::move(table); 
+  printf("SLArIonAndScintLArQL::BuildTable: %i x %i LArQL table for E = %g kV/cm (field range [%g, %g] kV/cm, accuracy %g)\n", 
+      fTable.fNDEdx, fTable.fNField, electric_field, fTable.fFieldMin, fTable.fFieldMax, fTable.fAccuracy); 
+  return true;
+}
+
+/**
+ * @details Bilinear interpolation of the escape term numerator and linear
+ * interpolation of the QChi denominator. dEdx must be >= fDEdxMin. 
+ */
+double SLArIonAndScintLArQL::SLArLArQLTable::Eval(const double& dEdx, const double& E) const {
+  const double fx = (dEdx - fDEdxMin) * fInvStepDEdx; 
+  const int i = std::min(static_cast<int>(fx), fNDEdx-2); 
+  const double tx = fx - i; 
+  const double fy = std::max(E - fFieldMin, 0.) * fInvStepField; 
+  const int j = std::min(static_cast<int>(fy), fNField-2); 
+  const double ty = fy - j; 
+
+  const double* row0 = &fNum[i + (size_t)fNDEdx*j]; 
+  const double* row1 = row0 + fNDEdx; 
+  const double num = (1.-ty)*((1.-tx)*row0[0] + tx*row0[1]) + ty*((1.-tx)*row1[0] + tx*row1[1]); 
+  const double den = (1.-tx)*fDen[i] + tx*fDen[i+1]; 
+  return num / den; 
+}
+
 
 double SLArIonAndScintLArQL::Flat() const {
     return FlatLightYieldPerMeV;
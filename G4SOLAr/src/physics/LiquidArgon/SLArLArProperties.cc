@@ -11,7 +11,8 @@ SLArLArProperties::SLArLArProperties() :
   fElectricField(0.5), fLArTemperature(87.7), fMuElectron(1.), 
   fDiffCoefficientL(0.), fDiffCoefficientT(0.), 
   fvDrift(1.0), fvDriftInverse(1.0), fElectronLifetime(1e7), fElectronLifetimeInverse(1e-7), 
-  fStepThreshold(2.0*CLHEP::mm), fLSegment(0.5*CLHEP::mm), fNSegmentsLimit(100)
+  fStepThreshold(2.0*CLHEP::mm), fLSegment(0.5*CLHEP::mm), fNSegmentsLimit(100), 
+  fChargeDriftMode(kDriftElectrons)
 {}
 
 SLArLArProperties::SLArLArProperties(const SLArLArProperties& p) :
@@ -19,7 +20,8 @@ SLArLArProperties::SLArLArProperties(const SLArLArProperties& p) :
   fDiffCoefficientL(p.fDiffCoefficientL), fDiffCoefficientT(p.fDiffCoefficientT), 
   fvDrift(p.fvDrift), fvDriftInverse(p.fvDriftInverse), 
   fElectronLifetime(p.fElectronLifetime), fElectronLifetimeInverse(p.fElectronLifetimeInverse),
-  fStepThreshold(p.fStepThreshold), fLSegment(p.fLSegment), fNSegmentsLimit(p.fNSegmentsLimit)
+  fStepThreshold(p.fStepThreshold), fLSegment(p.fLSegment), fNSegmentsLimit(p.fNSegmentsLimit), 
+  fChargeDriftMode(p.fChargeDriftMode)
 {}
 
 SLArLArProperties& SLArLArProperties::operator=(const SLArLArProperties& p) {
@@ -36,6 +38,7 @@ SLArLArProperties& SLArLArProperties::operator=(const SLArLArProperties& p) {
     fStepThreshold = p.fStepThreshold;
     fLSegment = p.fLSegment;
     fNSegmentsLimit = p.fNSegmentsLimit;
+    fChargeDriftMode = p.fChargeDriftMode;
   }
 
   return *this;
@@ -122,6 +125,7 @@ void SLArLArProperties::PrintProperties() const {
   printf("* step length threshold: %g mm\n", fStepThreshold / CLHEP::mm);
   printf("* segment length: %g mm\n", fLSegment / CLHEP::mm);
   printf("* max number of segments: %u\n", fNSegmentsLimit);
+  printf("* charge drift mode: %s\n", (fChargeDriftMode == kDriftParametric) ? "parametric" : "electrons");
   printf("**************************************************\n");
   return;
 }
@@ -5,12 +5,15 @@
  */
 
 #include <cmath>
+#include <climits>
+#include <algorithm>
 
 #include "physics/SLArElectronDrift.hh"
 #include "SLArAnalysisManager.hh"
 #include "SLArBacktrackerManager.hh"
 #include "event/SLArEventAnode.hh"
 #include "event/SLArEventChargeHit.hh"
+#include "event/SLArEventChargePixel.hh"
 #include "config/SLArCfgAnode.hh"
 
 #include "G4SystemOfUnits.hh"
@@ -31,9 +34,11 @@ void SLArElectronDrift::Drift(const int& n,
     SLArEventAnode* anodeEv) 
 {
   if (n <= 0) return;
+  SLArProfileScope profile_scope(SLArProfiler::kElectronDrift); 
 
   auto ana_mngr = SLArAnalysisManager::Instance();
   auto bkt_mngr = ana_mngr->GetBacktrackerManager( backtracker::kCharge );
+  fBatch.Clear(); 
 
   // Build anode reference frame
   G4ThreeVector anodeXaxis = 
@@ -92,49 +97,230 @@ void SLArElectronDrift::Drift(const int& n,
     getchar(); 
 #endif
 
+    G4double posX = pos_local.dot(anodeXaxis);
+    G4double posY = pos_local.dot(anodeYaxis);
+    G4double diffTime = diffLengthL * fLArProperties.fvDriftInverse; 
+
+    if (fLArProperties.fChargeDriftMode == kDriftParametric) {
+      if (DriftSegmentParametric(n_elec_segment*f_surv, posX, posY, diffLengthT, 
+            hitTime, diffTime, trkId, ancestorId, anodeCfg, anodeEv)) continue;
+    }
+
     G4int n_elec_anode = G4Poisson(n_elec_segment*f_surv); 
   
     if (n_elec_anode == 0) continue;
     
-    std::vector<double> x_(n_elec_anode); 
-    std::vector<double> y_(n_elec_anode); 
-    std::vector<double> t_(n_elec_anode);
-    G4double posX = pos_local.dot(anodeXaxis);
-    G4double posY = pos_local.dot(anodeYaxis);
-    G4RandGauss::shootArray(n_elec_anode, &x_[0], posX, diffLengthT); 
-    G4RandGauss::shootArray(n_elec_anode, &y_[0], posY, diffLengthT); 
-    G4RandGauss::shootArray(n_elec_anode, &t_[0], hitTime, diffLengthL * fLArProperties.fvDriftInverse); 
-
-    // Register hits on anode
-    SLArCfgAnode::SLArPixIdx pixID;
-    for (G4int i=0; i<n_elec_anode; i++) {
-      pixID = anodeCfg->GetPixelIndex(x_[i], y_[i]); 
-      //printf("pixID: %i, %i, %i\n", pixID[0], pixID[1], pixID[2]);
-      if (pixID[0] >= 0 && pixID[1] >= 0 && pixID[2] >= 0 ) {
-
-        SLArEventChargeHit hit(t_[i], trkId, ancestorId); 
-        auto& evPixel = anodeEv->RegisterChargeHit(pixID, hit); 
-
-        //#ifdef SLAR_DEBUG
-        //printf("\tdiff x,y: %.2f - %.2f mm\n", x_[i], y_[i]);
-        //printf("\tpix id: %i, %i, %i\n", pixID[0], pixID[1], pixID[2]);
-        ////evT->PrintHits(); 
-        //getchar();
-        //#endif
-
-        if (bkt_mngr == nullptr) continue;
-
-        if (bkt_mngr->IsNull()) continue;
-
-        auto& records = 
-          evPixel.GetBacktrackerVector( evPixel.ConvertToClock<float>(hit.GetTime()));
-
-        for (size_t ib = 0; ib < bkt_mngr->GetBacktrackers().size(); ib++) {
-          bkt_mngr->GetBacktrackers().at(ib)->Eval(&hit, 
-              &records.GetRecords().at(ib));
-        }
+    const size_t offset = fBatch.Grow(n_elec_anode); 
+    G4RandGauss::shootArray(n_elec_anode, &fBatch.fX[offset], posX, diffLengthT); 
+    G4RandGauss::shootArray(n_elec_anode, &fBatch.fY[offset], posY, diffLengthT); 
+    G4RandGauss::shootArray(n_elec_anode, &fBatch.fT[offset], hitTime, diffTime); 
+  }
+
+  const size_t n_elec = fBatch.fSize; 
+  if (n_elec == 0) return;
+
+  // Pixel binning
+  for (size_t i = 0; i < n_elec; i++) {
+    const auto pixID = anodeCfg->GetPixelIndex(fBatch.fX[i], fBatch.fY[i]); 
+    fBatch.fMegaTile[i] = pixID[0]; 
+    fBatch.fTile[i] = pixID[1]; 
+    fBatch.fPixel[i] = pixID[2]; 
+  }
+
+  // Time to clock conversion (same as SLArEventHitsCollection::ConvertToClock<float>)
+  const float clock_unit = SLArEventChargePixel::kDefaultClockUnit; 
+  const double* t_ = fBatch.fT.data(); 
+  int* clock_ = fBatch.fClock.data(); 
+  for (size_t i = 0; i < n_elec; i++) {
+    clock_[i] = static_cast<int>( static_cast<float>(t_[i]) / clock_unit ); 
+  }
+
+  // Aggregate electrons with the same (pixel, clock) 
+  for (size_t i = 0; i < n_elec; i++) {
+    if (fBatch.fMegaTile[i] < 0 || fBatch.fTile[i] < 0 || fBatch.fPixel[i] < 0) continue;
+    fBatch.fKeys.push_back( {fBatch.fMegaTile[i], fBatch.fTile[i], fBatch.fPixel[i], 
+        fBatch.fClock[i], static_cast<unsigned int>(i)} ); 
+  }
+  std::sort(fBatch.fKeys.begin(), fBatch.fKeys.end()); 
+
+  // Register hits on anode
+  const size_t n_keys = fBatch.fKeys.size(); 
+  size_t ikey = 0; 
+  while (ikey < n_keys) {
+    const auto& key = fBatch.fKeys[ikey]; 
+    size_t iend = ikey+1; 
+    while (iend < n_keys && iend - ikey < USHRT_MAX && key.SameBin(fBatch.fKeys[iend])) iend++; 
+    const UShort_t n_hits = static_cast<UShort_t>(iend - ikey); 
+
+    const SLArCfgAnode::SLArPixIdx pixID = {key.fMegaTile, key.fTile, key.fPixel}; 
+    RegisterHits(pixID, fBatch.fT[key.fIndex], n_hits, trkId, ancestorId, anodeEv, bkt_mngr); 
+
+    ikey = iend; 
+  }
+
+  return;
+}
+
+/**
+ * @details Register n electrons collected by the same pixel in the same
+ * clock tick and update the charge backtracker records. 
+ */
+void SLArElectronDrift::RegisterHits(const SLArCfgAnode::SLArPixIdx& pixID, 
+    const double& time, const UShort_t n_hits, 
+    const int& trkId, const int& ancestorId, SLArEventAnode* anodeEv, 
+    backtracker::SLArBacktrackerManager* bkt_mngr)
+{
+  SLArEventChargeHit hit(time, trkId, ancestorId); 
+  auto& evPixel = anodeEv->RegisterChargeHit(pixID, hit, n_hits); 
+  SLArProfiler::CountActive(SLArProfiler::kNChargeHits, n_hits); 
+
+  if (bkt_mngr == nullptr) return;
+  if (bkt_mngr->IsNull()) return;
+
+  SLArProfileScope profile_scope(SLArProfiler::kBacktracker); 
+
+  auto& records = 
+    evPixel.GetBacktrackerVector( evPixel.ConvertToClock<float>(hit.GetTime()));
+
+  for (size_t ib = 0; ib < bkt_mngr->GetBacktrackers().size(); ib++) {
+    for (UShort_t ih = 0; ih < n_hits; ih++) {
+      bkt_mngr->GetBacktrackers().at(ib)->Eval(&hit, 
+          &records.GetRecords().at(ib));
+    }
+  }
+  return;
+}
+
+/**
+ * @details Parametric charge response of a drift segment. The electron
+ * cloud reaching the anode is a 2D Gaussian with transverse width
+ * diffLengthT centered in (posX, posY): the fraction of the cloud 
+ * collected by each pixel within kNSigma widths is computed analytically
+ * (product of the erf integrals over the pixel edges) and the number of 
+ * electrons collected by the pixel is drawn from a Poisson distribution
+ * with mean n_mean times the collected fraction. The electrons of each
+ * pixel are then distributed among the clock ticks with sequential
+ * binomial draws following the longitudinal (time) diffusion. 
+ *
+ * The work scales with the number of pixels and clock ticks touched 
+ * instead of the number of electrons. The pixels are found by probing 
+ * the pixel lattice around the cloud center, so the method requires the 
+ * pixel lookup of the anode and a regular pixel layout; the bounding box
+ * of each pixel is used in the integral. 
+ *
+ * @return false if the segment cannot be treated parametrically (no 
+ * regular pixel lattice, cloud center outside the pixels or cloud too
+ * wide), in which case the electrons must be drifted individually. 
+ */
+G4bool SLArElectronDrift::DriftSegmentParametric(const double& n_mean, 
+    const double& posX, const double& posY, const double& diffLengthT, 
+    const double& hitTime, const double& diffTime, 
+    const int& trkId, const int& ancestorId, 
+    SLArCfgAnode* anodeCfg, SLArEventAnode* anodeEv)
+{
+  double pitch0 = 0., pitch1 = 0.; 
+  if (!anodeCfg->GetPixelPitch(pitch0, pitch1)) return false;
+
+  SLArCfgAnode::SLArPixCell cell; 
+  if (!anodeCfg->FindPixelCell(posX, posY, cell)) return false;
+
+  const double reach = kNSigma*diffLengthT; 
+  const int n0 = static_cast<int>( std::ceil(reach / pitch0) ); 
+  const int n1 = static_cast<int>( std::ceil(reach / pitch1) ); 
+  if ((2*n0+1)*(2*n1+1) > kMaxParametricPixels) return false;
+
+  auto ana_mngr = SLArAnalysisManager::Instance();
+  auto bkt_mngr = ana_mngr->GetBacktrackerManager( backtracker::kCharge );
+
+  // collect the pixels overlapping the cloud
+  fPixWeights.clear(); 
+  const double c0 = 0.5*(cell.fX0min + cell.fX0max); 
+  const double c1 = 0.5*(cell.fX1min + cell.fX1max); 
+  for (int i0 = -n0; i0 <= n0; i0++) {
+    for (int i1 = -n1; i1 <= n1; i1++) {
+      if (!anodeCfg->FindPixelCell(c0 + i0*pitch0, c1 + i1*pitch1, cell)) continue;
+
+      bool is_new = true; 
+      for (const auto& pw : fPixWeights) {
+        if (pw.fIdx == cell.fIdx) {is_new = false; break;}
+      }
+      if (!is_new) continue;
+
+      const double w = 
+        GaussianFraction(cell.fX0min, cell.fX0max, posX, diffLengthT) * 
+        GaussianFraction(cell.fX1min, cell.fX1max, posY, diffLengthT); 
+      if (w > 0.) fPixWeights.push_back( {cell.fIdx, w} ); 
+    }
+  }
+
+  // time bins covered by the longitudinal diffusion
+  const double clock_unit = SLArEventChargePixel::kDefaultClockUnit; 
+  const int clock_lo = static_cast<int>( std::floor((hitTime - kNSigma*diffTime) / clock_unit) ); 
+  const int clock_hi = static_cast<int>( std::floor((hitTime + kNSigma*diffTime) / clock_unit) ); 
+  fClockWeights.clear(); 
+  double w_tot = 0.; 
+  for (int ic = clock_lo; ic <= clock_hi; ic++) {
+    const double w = (clock_lo == clock_hi) ? 1.0 : 
+      GaussianFraction(ic*clock_unit, (ic+1)*clock_unit, hitTime, diffTime); 
+    fClockWeights.push_back( w ); 
+    w_tot += w; 
+  }
+
+  for (const auto& pw : fPixWeights) {
+    int n_pix = G4Poisson( n_mean * pw.fWeight ); 
+    double w_left = w_tot; 
+    for (size_t ic = 0; ic < fClockWeights.size() && n_pix > 0; ic++) {
+      const double p = (w_left > 0.) ? std::min(fClockWeights[ic] / w_left, 1.0) : 1.0; 
+      w_left -= fClockWeights[ic]; 
+      const int n_clk = (p >= 1.0) ? n_pix : 
+        static_cast<int>( CLHEP::RandBinomial::shoot(n_pix, p) ); 
+      if (n_clk == 0) continue;
+      n_pix -= n_clk; 
+
+      const double t = (clock_lo + ic + 0.5) * clock_unit; 
+      int n_left = n_clk; 
+      while (n_left > 0) {
+        const UShort_t n_hits = static_cast<UShort_t>( std::min(n_left, USHRT_MAX) ); 
+        RegisterHits(pw.fIdx, t, n_hits, trkId, ancestorId, anodeEv, bkt_mngr); 
+        n_left -= n_hits; 
       }
     }
   }
+
+  return true;
+}
+
+/**
+ * @details Fraction of a Gaussian distribution with mean mu and width 
+ * sigma contained in the interval [lo, hi]. 
+ */
+double SLArElectronDrift::GaussianFraction(const double& lo, const double& hi, 
+    const double& mu, const double& sigma)
+{
+  if (sigma <= 0.) return (mu > lo && mu <= hi) ? 1.0 : 0.0;
+  const double k = 1.0 / (M_SQRT2 * sigma); 
+  return 0.5*(std::erf((hi-mu)*k) - std::erf((lo-mu)*k)); 
+}
+
+/**
+ * @details Extend the batch buffers by n electrons. 
+ *
+ * @return index of the first new electron
+ */
+size_t SLArElectronDrift::SLArDriftBatch::Grow(const size_t n)
+{
+  const size_t offset = fSize; 
+  fSize += n; 
+  if (fX.size() < fSize) {
+    fX.resize(fSize); 
+    fY.resize(fSize); 
+    fT.resize(fSize); 
+    fMegaTile.resize(fSize); 
+    fTile.resize(fSize); 
+    fPixel.resize(fSize); 
+    fClock.resize(fSize); 
+  }
+  return offset; 
 }
 
+
@@ -0,0 +1,113 @@
+/**
+ * @author      : Daniele Guffanti (daniele.guffanti@mib.infn.it)
+ * @file        : SLArOpticalLibrary.cc
+ * @created     : Saturday Oct 17, 2026 19:10:51 CEST
+ */
+
+#include <cmath>
+#include <memory>
+
+#include "physics/SLArOpticalLibrary.hh"
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TH3.h"
+
+SLArOpticalLibrary::SLArOpticalLibrary()
+  : fFilePath(""), fNBins{0, 0, 0}, fMin{0., 0., 0.}, fInvWidth{0., 0., 0.}
+{}
+
+/**
+ * @details Read the voxel grid and the visibility table from the given
+ * file. The entries are stored grouped by voxel in a single array, so that
+ * the channels seeing a voxel are found with one offset lookup.
+ *
+ * @return true if the library has been loaded
+ */
+G4bool SLArOpticalLibrary::Load(const G4String& file_path)
+{
+  std::unique_ptr<TFile> file( TFile::Open(file_path.data()) );
+  if (!file || file->IsZombie()) {
+    printf("SLArOpticalLibrary::Load ERROR: cannot open %s\n", file_path.data());
+    return false;
+  }
+
+  TH3* grid = file->Get<TH3>("VoxelGrid");
+  TTree* table = file->Get<TTree>("OpticalLibrary");
+  if (grid == nullptr || table == nullptr) {
+    printf("SLArOpticalLibrary::Load ERROR: cannot find VoxelGrid/OpticalLibrary in %s\n",
+        file_path.data());
+    return false;
+  }
+
+  const TAxis* axis[3] = {grid->GetXaxis(), grid->GetYaxis(), grid->GetZaxis()};
+  for (int i = 0; i < 3; i++) {
+    if (axis[i]->IsVariableBinSize()) {
+      printf("SLArOpticalLibrary::Load ERROR: the voxel grid must have uniform bins\n");
+      return false;
+    }
+    fNBins[i] = axis[i]->GetNbins();
+    fMin[i] = axis[i]->GetXmin();
+    fInvWidth[i] = fNBins[i] / (axis[i]->GetXmax() - axis[i]->GetXmin());
+  }
+
+  Int_t voxel = 0, array = 0, cell = 0;
+  Float_t vis = 0., t0 = 0., tau = 0.;
+  table->SetBranchAddress("voxel", &voxel);
+  table->SetBranchAddress("array", &array);
+  table->SetBranchAddress("cell", &cell);
+  table->SetBranchAddress("vis", &vis);
+  table->SetBranchAddress("t0", &t0);
+  table->SetBranchAddress("tau", &tau);
+
+  const size_t n_voxels = GetNVoxels();
+  const Long64_t n_entries = table->GetEntries();
+
+  // count the entries of each voxel and fill the table grouped by voxel
+  fVoxelOffset.assign(n_voxels+1, 0);
+  for (Long64_t i = 0; i < n_entries; i++) {
+    table->GetEntry(i);
+    if (voxel < 0 || (size_t)voxel >= n_voxels) {
+      printf("SLArOpticalLibrary::Load ERROR: voxel %i out of the grid (%lu voxels)\n",
+          voxel, n_voxels);
+      fVoxelOffset.clear();
+      return false;
+    }
+    fVoxelOffset[voxel+1]++;
+  }
+  for (size_t i = 0; i < n_voxels; i++) fVoxelOffset[i+1] += fVoxelOffset[i];
+
+  std::vector<size_t> next(fVoxelOffset.begin(), fVoxelOffset.end()-1);
+  fEntries.resize(n_entries);
+  for (Long64_t i = 0; i < n_entries; i++) {
+    table->GetEntry(i);
+    fEntries[next[voxel]++] = {array, cell, vis, t0, tau};
+  }
+
+  fFilePath = file_path;
+  printf("SLArOpticalLibrary::Load: %lu voxels, %lu entries from %s\n",
+      n_voxels, fEntries.size(), file_path.data());
+  return true;
+}
+
+/**
+ * @details Return the channels seeing the voxel containing the given point
+ * (in the detector frame). n is set to zero outside the grid.
+ */
+const SLArOpticalLibrary::SLArOpticalLibraryEntry* SLArOpticalLibrary::GetEntries(
+    const G4ThreeVector& pos, size_t& n) const
+{
+  n = 0;
+  if (fVoxelOffset.empty()) return nullptr;
+
+  int ibin[3];
+  for (int i = 0; i < 3; i++) {
+    ibin[i] = static_cast<int>(std::floor((pos[i] - fMin[i]) * fInvWidth[i]));
+    if (ibin[i] < 0 || ibin[i] >= fNBins[i]) return nullptr;
+  }
+
+  const size_t voxel = ibin[0] + fNBins[0]*(ibin[1] + (size_t)fNBins[1]*ibin[2]);
+  n = fVoxelOffset[voxel+1] - fVoxelOffset[voxel];
+  return fEntries.data() + fVoxelOffset[voxel];
+}
+
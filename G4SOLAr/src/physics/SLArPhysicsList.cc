@@ -34,6 +34,8 @@
 
 #include "physics/SLArExtraPhysics.hh"
 #include "physics/SLArOpticalPhysics.hh"
+#include "physics/SLArOpticalLibrary.hh"
+#include "physics/SLArScintillation.hh"
 
 #include "G4LossTableManager.hh"
 
@@ -66,7 +68,7 @@
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 SLArPhysicsList::SLArPhysicsList(G4String physName, G4bool do_cerenkov) : 
-  G4VModularPhysicsList()
+  G4VModularPhysicsList(), fOpticalLibrary(nullptr)
 {
   G4LossTableManager::Instance();
 
@@ -118,6 +120,41 @@ SLArPhysicsList::~SLArPhysicsList()
   delete fMessenger;
 
   delete fStepMaxProcess;
+
+  if (SLArScintillation::GetOpticalLibrary() == fOpticalLibrary) 
+    SLArScintillation::SetOpticalLibrary(nullptr);
+  delete fOpticalLibrary;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SLArPhysicsList::LoadOpticalLibrary(const G4String& file_path)
+{
+  auto library = new SLArOpticalLibrary();
+  if (library->Load(file_path) == false) {
+    delete library;
+    return false;
+  }
+
+  const G4bool use_library = (SLArScintillation::GetOpticalLibrary() != nullptr);
+  delete fOpticalLibrary;
+  fOpticalLibrary = library;
+  if (use_library) SLArScintillation::SetOpticalLibrary(fOpticalLibrary);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SLArPhysicsList::SetOpticalLibraryMode(G4bool use_library)
+{
+  if (use_library && fOpticalLibrary == nullptr) {
+    G4Exception("SLArPhysicsList::SetOpticalLibraryMode", "NoOpticalLibrary", 
+        JustWarning, "No optical library loaded (/SLAr/phys/loadOpticalLibrary). Keeping photon tracking.");
+    return false;
+  }
+
+  SLArScintillation::SetOpticalLibrary( use_library ? fOpticalLibrary : nullptr ); 
+  return true;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -90,6 +90,30 @@ SLArPhysicsListMessenger::SLArPhysicsListMessenger(SLArPhysicsList* pPhys)
   fCmdSetLArNSegmentsLimit->SetGuidance("Set max number of segments for distributing ionization along the step, to avoid excessive segmentation for long steps");
   fCmdSetLArNSegmentsLimit->SetParameterName("n_segments_limit", false);
   fCmdSetLArNSegmentsLimit->SetRange("n_segments_limit>1");
+
+  fCmdSetChargeDriftMode = 
+    new G4UIcmdWithAString("/SLAr/phys/setChargeDriftMode", this);
+  fCmdSetChargeDriftMode->SetGuidance("Set the simulation of the charge collected on the anode");
+  fCmdSetChargeDriftMode->SetGuidance("electrons: diffuse each ionization electron");
+  fCmdSetChargeDriftMode->SetGuidance("parametric: integrate the Gaussian electron cloud of each segment over the pixels");
+  fCmdSetChargeDriftMode->SetParameterName("mode", false);
+  fCmdSetChargeDriftMode->SetCandidates("electrons parametric");
+
+  fCmdLoadOpticalLibrary = 
+    new G4UIcmdWithAString("/SLAr/phys/loadOpticalLibrary", this);
+  fCmdLoadOpticalLibrary->SetGuidance("Load the photon visibility library of the SuperCell readout from a ROOT file");
+  fCmdLoadOpticalLibrary->SetParameterName("library_file", false);
+  fCmdLoadOpticalLibrary->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fCmdSetOpticalMode = 
+    new G4UIcmdWithAString("/SLAr/phys/setOpticalMode", this);
+  fCmdSetOpticalMode->SetGuidance("Set the simulation of the scintillation light detected by the SuperCells");
+  fCmdSetOpticalMode->SetGuidance("tracking: create and track the optical photons");
+  fCmdSetOpticalMode->SetGuidance("library: sample the detected photons from the visibility library");
+  fCmdSetOpticalMode->SetGuidance("(library mode does not produce hits on the anode tile SiPMs: the anode output must be disabled)");
+  fCmdSetOpticalMode->SetParameterName("mode", false);
+  fCmdSetOpticalMode->SetCandidates("tracking library");
+  fCmdSetOpticalMode->AvailableForStates(G4State_PreInit,G4State_Idle);
   
   fSetAbsorptionCMD = new G4UIcmdWithABool(
       "/SLAr/phys/setAbsorption", this);
@@ -190,6 +214,9 @@ SLArPhysicsListMessenger::~SLArPhysicsListMessenger()
   delete fCmdSetLArStepLenThreshold;
   delete fCmdSetLArSegmentLen;
   delete fCmdSetLArNSegmentsLimit;
+  delete fCmdSetChargeDriftMode;
+  delete fCmdLoadOpticalLibrary;
+  delete fCmdSetOpticalMode;
 
   delete fVerboseCmd;
   delete fCerenkovCmd;
@@ -254,6 +281,22 @@ void SLArPhysicsListMessenger::SetNewValue(G4UIcommand* command,
     }
     lar_properties.SetNSegmentsLimit( nSegmentsLimit );
   }
+  else if (command == fCmdSetChargeDriftMode) {
+    auto detector = 
+      (SLArDetectorConstruction*)G4RunManager::GetRunManager()->GetUserDetectorConstruction(); 
+    auto& lar_properties = detector->GetLArProperties(); 
+    lar_properties.SetChargeDriftMode( (newValue == "parametric") ? kDriftParametric : kDriftElectrons ); 
+  }
+  else if (command == fCmdLoadOpticalLibrary) {
+    if (fPhysicsList->LoadOpticalLibrary( newValue ) == false) {
+      G4ExceptionDescription ed;
+      ed << "Cannot load the optical library from " << newValue;
+      G4Exception("SLArPhysicsListMessenger::SetNewValue", "InvalidOpticalLibrary", JustWarning, ed);
+    }
+  }
+  else if (command == fCmdSetOpticalMode) {
+    fPhysicsList->SetOpticalLibraryMode( newValue == "library" ); 
+  }
   else if( command == fSetAbsorptionCMD ) {
     fPhysicsList->SetAbsorption(G4UIcmdWithABool::GetNewBoolValue(newValue));
   }
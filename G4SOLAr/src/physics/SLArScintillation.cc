@@ -91,11 +91,19 @@
 #include "LiquidArgon/SLArLArProperties.hh"
 #include "LiquidArgon/SLArIonAndScintLArQL.h"
 #include "LiquidArgon/SLArIonAndScintSeparate.h"
+#include "physics/SLArOpticalLibrary.hh"
+#include "geo/SLArGeoUtils.hh"
+#include "SLArAnalysisManager.hh"
+#include "SLArBacktrackerManager.hh"
+#include "CLHEP/Random/RandBinomial.h"
 
 
 #include <unistd.h>     //required for usleep()
 #include <cstdlib>
 #include <fstream>
+G4ThreadLocal SLArScintStepYield SLArScintillation::fgStepYield;
+const SLArOpticalLibrary* SLArScintillation::fgOpticalLibrary = nullptr;
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 SLArScintillation::SLArScintillation(const G4String& processName,
                                  G4ProcessType type)
@@ -122,6 +130,11 @@ SLArScintillation::SLArScintillation(const G4String& processName,
   scint_mesg_->DeclareProperty("electricField", electricField_,"Electric Field for LArQL [kV/cm]");
   scint_mesg_->DeclareProperty("enablePhGeneration", fDoGeneratePhotons, "enable/disable optical ph generation");
   scint_mesg_->DeclareProperty("setScintScaling", fScintScale, "Scale the scintillation yield by this factor");
+  scint_mesg_->DeclareMethod("setLArQLMode", &SLArScintillation::SetLArQLMode, 
+      "LArQL charge yield evaluation (table | analytic)")
+    .SetCandidates("table analytic"); 
+  scint_mesg_->DeclareMethod("setLArQLTableAccuracy", &SLArScintillation::SetLArQLTableAccuracy, 
+      "Target relative accuracy of the LArQL lookup table"); 
 
   if(verboseLevel > 1)
   {
@@ -379,6 +392,27 @@ G4VParticleChange* SLArScintillation::AtRestDoIt(const G4Track& aTrack,
   return SLArScintillation::PostStepDoIt(aTrack, aStep);
 }
 
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4bool SLArScintillation::GetStepYield(const G4Step* step, G4int& n_ph, G4int& n_el)
+// Read the yields published by the last PostStepDoIt call of this thread.
+// The record is valid only if it was written for the same track and step:
+// steps where the process was not invoked (or at-rest steps, which are not
+// accounted in the trajectory/charge yields) return zero.
+{
+  n_ph = 0;
+  n_el = 0;
+
+  const G4Track* track = step->GetTrack();
+  if (step->GetPostStepPoint()->GetStepStatus() == fAtRestDoItProc) return false;
+  if (fgStepYield.fTrack != track ||
+      fgStepYield.fTrackID != track->GetTrackID() ||
+      fgStepYield.fStepNumber != track->GetCurrentStepNumber()) return false;
+
+  n_ph = fgStepYield.fNumPhotons;
+  n_el = fgStepYield.fNumIonElectrons;
+  return true;
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 G4VParticleChange* SLArScintillation::PostStepDoIt(const G4Track& aTrack,
                                                  const G4Step& aStep)
@@ -387,8 +421,16 @@ G4VParticleChange* SLArScintillation::PostStepDoIt(const G4Track& aTrack,
 // generated according to the scintillation yield formula, distributed
 // evenly along the track segment and uniformly into 4pi.
 {
+  SLArProfileScope profile_scope(SLArProfiler::kScintillation); 
   aParticleChange.Initialize(aTrack);
   fNumPhotons = 0;
+  fNumIonElectrons = 0;
+
+  fgStepYield.fTrack = &aTrack;
+  fgStepYield.fTrackID = aTrack.GetTrackID();
+  fgStepYield.fStepNumber = aTrack.GetCurrentStepNumber();
+  fgStepYield.fNumPhotons = 0;
+  fgStepYield.fNumIonElectrons = 0;
 
   const G4DynamicParticle* aParticle = aTrack.GetDynamicParticle();
   const G4Material* aMaterial        = aTrack.GetMaterial();
@@ -548,6 +590,9 @@ G4VParticleChange* SLArScintillation::PostStepDoIt(const G4Track& aTrack,
     fNumIonElectrons = G4int(G4Poisson(MeanNumberOfIonElectrons)); 
   }
 
+  fgStepYield.fNumPhotons = fNumPhotons;
+  fgStepYield.fNumIonElectrons = fNumIonElectrons;
+
   if (fDoGeneratePhotons == false) {
     if(verboseLevel > 1)
     {
@@ -567,6 +612,22 @@ G4VParticleChange* SLArScintillation::PostStepDoIt(const G4Track& aTrack,
     return G4VRestDiscreteProcess::PostStepDoIt(aTrack, aStep);
   }
 
+  if (fgOpticalLibrary)
+  {
+    // fast optical simulation: no photon tracks, the detected photons
+    // are sampled from the visibility library
+    const G4double yields[3] = {yield1, yield2, yield3};
+    G4int n_hits = SampleOpticalLibraryHits(aTrack, aStep, MPT, N_timeconstants, yields);
+    SLArProfiler::CountActive(SLArProfiler::kNPhotonHits, n_hits); 
+    if(verboseLevel > 1)
+    {
+      G4cout << "\n Exiting from SLArScintillation::DoIt -- "
+        << "sampled " << n_hits << " SuperCell hits from the optical library" << G4endl;
+    }
+    aParticleChange.SetNumberOfSecondaries(0);
+    return G4VRestDiscreteProcess::PostStepDoIt(aTrack, aStep);
+  }
+
   aParticleChange.SetNumberOfSecondaries(fNumPhotons);
 
 
@@ -729,6 +790,101 @@ G4VParticleChange* SLArScintillation::PostStepDoIt(const G4Track& aTrack,
   return G4VRestDiscreteProcess::PostStepDoIt(aTrack, aStep);
 }
 
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+G4int SLArScintillation::SampleOpticalLibraryHits(const G4Track& aTrack, 
+    const G4Step& aStep, const G4MaterialPropertiesTable* MPT, 
+    G4int N_timeconstants, const G4double yields[3])
+// Sample the photons detected by each SuperCell seeing the voxel of the 
+// step midpoint (binomial with the library visibility) and register them 
+// directly in the event PDS. The arrival time is the emission time 
+// (uniform along the step + scintillation component decay) plus the 
+// propagation time from the library (t0 + Exp(tau)). 
+{
+  SLArAnalysisManager* SLArAnaMgr = SLArAnalysisManager::Instance();
+  if (SLArAnaMgr->IsPDSOutputEnabled() == false) return 0;
+
+  const G4ThreeVector midpoint_world = 
+    0.5*(aStep.GetPreStepPoint()->GetPosition() + aStep.GetPostStepPoint()->GetPosition()); 
+  const G4ThreeVector midpoint = geo::transform_frame_world_to_det( midpoint_world ); 
+
+  size_t n_entries = 0;
+  const auto entries = fgOpticalLibrary->GetEntries(midpoint, n_entries);
+  if (n_entries == 0) return 0;
+
+  // scintillation components
+  const G4MaterialConstPropertyIndex kTimeConst[3] = 
+    {kSCINTILLATIONTIMECONSTANT1, kSCINTILLATIONTIMECONSTANT2, kSCINTILLATIONTIMECONSTANT3};
+  const G4MaterialConstPropertyIndex kRiseTime[3] = 
+    {kSCINTILLATIONRISETIME1, kSCINTILLATIONRISETIME2, kSCINTILLATIONRISETIME3};
+  G4double scintTime[3] = {0., 0., 0.};
+  G4double riseTime[3] = {0., 0., 0.};
+  G4double cumulative[3] = {1., 1., 1.};
+  const G4double sum_yields = yields[0] + yields[1] + yields[2];
+  G4double cum = 0.;
+  for (G4int scnt = 0; scnt < N_timeconstants; ++scnt) {
+    scintTime[scnt] = MPT->GetConstProperty(kTimeConst[scnt]);
+    if (fFiniteRiseTime) riseTime[scnt] = MPT->GetConstProperty(kRiseTime[scnt]);
+    if (N_timeconstants > 1) {
+      cum += yields[scnt] / sum_yields;
+      cumulative[scnt] = cum;
+    }
+  }
+  cumulative[N_timeconstants-1] = 1.;
+
+  auto bktManager = SLArAnaMgr->GetBacktrackerManager( backtracker::kSuperCell ); 
+  auto& opdet_map = SLArAnaMgr->GetEventPDS().GetOpDetArrayMap(); 
+
+  const G4double t0 = aStep.GetPreStepPoint()->GetGlobalTime();
+  const G4double step_time = aStep.GetDeltaTime();
+  G4int n_hits = 0;
+
+  for (size_t i = 0; i < n_entries; i++) {
+    const auto& entry = entries[i];
+    const G4long n_det = CLHEP::RandBinomial::shoot(fNumPhotons, entry.fVisibility);
+    if (n_det == 0) continue;
+
+    auto array_itr = opdet_map.find(entry.fArray);
+    if (array_itr == opdet_map.end()) continue;
+    auto& ev_array = array_itr->second;
+
+    for (G4long j = 0; j < n_det; j++) {
+      G4int scnt = 0;
+      const G4double r = G4UniformRand();
+      while (scnt < N_timeconstants-1 && r > cumulative[scnt]) scnt++;
+
+      G4double time = t0 + G4UniformRand()*step_time;
+      if (riseTime[scnt] == 0.0) {
+        time -= scintTime[scnt] * std::log(G4UniformRand());
+      }
+      else {
+        time += sample_time(riseTime[scnt], scintTime[scnt]);
+      }
+      time += entry.fT0 - entry.fTau * std::log(G4UniformRand());
+
+      SLArEventPhotonHit dstHit(time, kScnt);
+      dstHit.SetProducerTrkID( aTrack.GetTrackID() ); 
+
+      auto& ev_sc = ev_array.RegisterHit(dstHit, entry.fCell);
+
+      if (bktManager) {
+        if (bktManager->IsNull() == false) {
+          SLArProfileScope profile_scope(SLArProfiler::kBacktracker); 
+          SLArEventBacktrackerVector& records = 
+            ev_sc.GetBacktrackerVector( ev_sc.ConvertToClock<float>(dstHit.GetTime()) );
+
+          for (size_t ib = 0; ib < bktManager->GetBacktrackers().size(); ib++) {
+            bktManager->GetBacktrackers().at(ib)->Eval(&dstHit, 
+                &records.GetRecords().at(ib));
+          }
+        }
+      }
+      n_hits++;
+    }
+  }
+
+  return n_hits;
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 G4double SLArScintillation::GetMeanFreePath(const G4Track&, G4double,
                                           G4ForceCondition* condition)
@@ -1036,6 +1192,26 @@ void SLArScintillation::SetStackPhotons(const G4bool stackingFlag)
   G4OpticalParameters::Instance()->SetScintStackPhotons(fStackingFlag);
 }
 
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void SLArScintillation::SetLArQLMode(const G4String& mode)
+{
+  SLArIonAndScintLArQL* larql = 
+    (SLArIonAndScintLArQL*)IonAndScint[SLArIonAndScintModel::kLArQL]; 
+  if (mode == "analytic") larql->SetMode(SLArIonAndScintLArQL::kAnalytic); 
+  else if (mode == "table") larql->SetMode(SLArIonAndScintLArQL::kTabulated); 
+  else {
+    printf("SLArScintillation::SetLArQLMode WARNING: unknown mode %s (table | analytic)\n", mode.data()); 
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+void SLArScintillation::SetLArQLTableAccuracy(const G4double accuracy)
+{
+  SLArIonAndScintLArQL* larql = 
+    (SLArIonAndScintLArQL*)IonAndScint[SLArIonAndScintModel::kLArQL]; 
+  larql->SetTableAccuracy(accuracy); 
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 void SLArScintillation::SetVerboseLevel(G4int verbose)
 {